@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "mappedfile.h"
+
+using namespace std;
+
+namespace fs = boost::filesystem;
+
+namespace reone {
+
+MappedFile::MappedFile(const fs::path &path) {
+    if (!fs::exists(path)) {
+        throw runtime_error("File not found: " + path.string());
+    }
+    if (fs::file_size(path) > 0) {
+        _file.open(path.string());
+    }
+}
+
+ByteView MappedFile::view() {
+    static const char kEmpty[] = "";
+    if (!_file.is_open()) {
+        return ByteView(kEmpty, 0, shared_from_this());
+    }
+    return ByteView(_file.data(), _file.size(), shared_from_this());
+}
+
+ByteView MappedFile::view(size_t offset, size_t size) {
+    return view().slice(offset, size);
+}
+
+} // namespace reone
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "types.h"
+
+namespace reone {
+
+/**
+ * Read-only memory-mapped file. Views into the mapping keep it alive, so
+ * instances must be managed by a shared pointer.
+ */
+class MappedFile : public std::enable_shared_from_this<MappedFile>, boost::noncopyable {
+public:
+    MappedFile(const boost::filesystem::path &path);
+
+    /**
+     * @return view into the whole file
+     */
+    ByteView view();
+
+    /**
+     * @return view into the specified range of the file
+     */
+    ByteView view(size_t offset, size_t size);
+
+    size_t size() const { return _file.size(); }
+
+private:
+    boost::iostreams::mapped_file_source _file;
+};
+
+} // namespace reone
@@ -20,20 +20,71 @@
 namespace reone {
 
 /**
- * Generic in-memory cache.
+ * Budget and retention policy of a memory cache.
  */
 template <class K, class V>
+struct CachePolicy {
+    size_t byteBudget {0}; /**< maximum total size of cached values in bytes, or 0 for unbounded */
+
+    /**
+     * Used to account for the size of a value in bytes. Values are not
+     * accounted for when unset.
+     */
+    std::function<size_t(const V &)> sizeOf;
+
+    /**
+     * Used to decide whether a value must be kept when the cache is
+     * invalidated, e.g. when switching between modules. Only called for
+     * non-null values.
+     */
+    std::function<bool(const K &)> retain;
+};
+
+/**
+ * Cache of shared values, computed lazily by key. When a byte budget is set,
+ * least recently used values that are no longer referenced outside of the
+ * cache are evicted to stay within the budget.
+ */
+template <class K, class V, class Hash = std::hash<K>>
 class MemoryCache : boost::noncopyable {
 public:
+    MemoryCache() = default;
+
     /**
      * @param compute function used to lazily compute a value by key
      */
-    MemoryCache(std::function<std::shared_ptr<V>(K)> compute) :
-        _compute(std::move(compute)) {
+    MemoryCache(std::function<std::shared_ptr<V>(K)> compute, CachePolicy<K, V> policy = CachePolicy<K, V>()) :
+        _compute(std::move(compute)),
+        _policy(std::move(policy)) {
     }
 
+    /**
+     * Removes all values, except those that the retention policy requires to keep.
+     */
     void invalidate() {
+        for (auto it = _objects.begin(); it != _objects.end();) {
+            if (it->second.retained) {
+                ++it;
+                continue;
+            }
+            _size -= it->second.size;
+            listOf(it->second).erase(it->second.lruIt);
+            it = _objects.erase(it);
+        }
+        for (auto &key : _pinned) {
+            _objects.find(key)->second.pinned = false;
+        }
+        _lru.splice(_lru.end(), _pinned);
+    }
+
+    /**
+     * Removes all values, regardless of the retention policy.
+     */
+    void clear() {
         _objects.clear();
+        _lru.clear();
+        _pinned.clear();
+        _size = 0;
     }
 
     /**
@@ -41,18 +92,99 @@ public:
      * @note if given key is not found in this cache, then value will be computed
      */
     std::shared_ptr<V> get(K key) {
+        return get(key, [this, &key]() { return _compute(key); });
+    }
+
+    /**
+     * @param compute function used to compute a value if given key is not found in this cache
+     * @return cached value
+     */
+    std::shared_ptr<V> get(const K &key, const std::function<std::shared_ptr<V>()> &compute) {
         auto maybeObject = _objects.find(key);
         if (maybeObject != _objects.end()) {
-            return maybeObject->second;
+            Entry &entry = maybeObject->second;
+            _lru.splice(_lru.begin(), listOf(entry), entry.lruIt);
+            entry.pinned = false;
+            return entry.value;
+        }
+        Entry entry;
+        entry.value = compute();
+        if (entry.value) {
+            entry.size = _policy.sizeOf ? _policy.sizeOf(*entry.value) : 0;
+            entry.retained = _policy.retain && _policy.retain(key);
         }
-        auto object = _compute(key);
-        return _objects.insert(make_pair(key, move(object))).first->second;
+        entry.lruIt = _lru.insert(_lru.begin(), key);
+        _size += entry.size;
+
+        auto inserted = _objects.insert(std::make_pair(key, std::move(entry)));
+        evict();
+
+        return inserted.first->second.value;
     }
 
+    void setPolicy(CachePolicy<K, V> policy) {
+        _policy = std::move(policy);
+    }
+
+    /**
+     * @return total size of cached values in bytes
+     */
+    size_t size() const { return _size; }
+
 private:
+    struct Entry {
+        std::shared_ptr<V> value;
+        size_t size {0};
+        bool retained {false};
+        bool pinned {false}; /**< lruIt points into the pinned list */
+        typename std::list<K>::iterator lruIt;
+    };
+
     std::function<std::shared_ptr<V>(K)> _compute;
+    CachePolicy<K, V> _policy;
+
+    std::unordered_map<K, Entry, Hash> _objects;
+    std::list<K> _lru;    /**< keys, most recently used first */
+    std::list<K> _pinned; /**< keys of values found to be referenced outside of this cache on eviction */
+    size_t _size {0};
+
+    std::list<K> &listOf(const Entry &entry) {
+        return entry.pinned ? _pinned : _lru;
+    }
 
-    std::unordered_map<K, std::shared_ptr<V>> _objects;
+    void evict() {
+        if (_policy.byteBudget == 0 || _size <= _policy.byteBudget) {
+            return;
+        }
+        // Give the longest pinned entry another chance on every eviction, so
+        // that values released since being pinned are eventually evicted too
+        if (!_pinned.empty()) {
+            Entry &entry = _objects.find(_pinned.front())->second;
+            if (entry.value.use_count() > 1) {
+                _pinned.splice(_pinned.end(), _pinned, entry.lruIt);
+            } else {
+                _lru.splice(_lru.end(), _pinned, entry.lruIt);
+                entry.pinned = false;
+            }
+        }
+        // Least recently used entry is at the back. The most recently used
+        // entry is never evicted, so that get always returns a cached value.
+        // Referenced entries are moved to the pinned list, so that each of
+        // them is visited at most once instead of on every insert.
+        while (_size > _policy.byteBudget && _lru.size() > 1) {
+            auto it = std::prev(_lru.end());
+            auto maybeObject = _objects.find(*it);
+            Entry &entry = maybeObject->second;
+            if (entry.value && entry.value.use_count() > 1) {
+                _pinned.splice(_pinned.end(), _lru, it);
+                entry.pinned = true;
+                continue; // still referenced outside of this cache, evicting would not free memory
+            }
+            _size -= entry.size;
+            _lru.erase(it);
+            _objects.erase(maybeObject);
+        }
+    }
 };
 
 } // namespace reone
@@ -24,76 +24,122 @@ namespace endian = boost::endian;
 namespace reone {
 
 size_t StreamReader::tell() {
-    return _stream->tellg();
+    if (_stream) {
+        return _stream->tellg();
+    }
+    return _pos;
 }
 
 void StreamReader::seek(size_t pos) {
-    _stream->clear();
-    _stream->seekg(pos);
+    if (_stream) {
+        _stream->clear();
+        _stream->seekg(pos);
+    } else {
+        _pos = min(pos, _view.size);
+        _eof = false;
+    }
 }
 
 void StreamReader::ignore(int count) {
-    _stream->ignore(count);
+    if (_stream) {
+        _stream->ignore(count);
+    } else {
+        size_t available = _view.size - _pos;
+        if (static_cast<size_t>(count) > available) {
+            _pos = _view.size;
+            _eof = true;
+        } else {
+            _pos += count;
+        }
+    }
+}
+
+void StreamReader::readExact(char *dest, size_t count) {
+    if (_stream) {
+        _stream->read(dest, count);
+        return;
+    }
+    size_t available = _view.size - _pos;
+    if (count > available) {
+        memcpy(dest, _view.data + _pos, available);
+        memset(dest + available, 0, count - available);
+        _pos = _view.size;
+        _eof = true;
+    } else {
+        memcpy(dest, _view.data + _pos, count);
+        _pos += count;
+    }
+}
+
+size_t StreamReader::read(char *dest, size_t count) {
+    if (_stream) {
+        _stream->read(dest, count);
+        return _stream->gcount();
+    }
+    size_t numRead = min(count, _view.size - _pos);
+    memcpy(dest, _view.data + _pos, numRead);
+    _pos += numRead;
+    return numRead;
 }
 
 uint8_t StreamReader::getByte() {
     uint8_t val;
-    _stream->read(reinterpret_cast<char *>(&val), 1);
+    readExact(reinterpret_cast<char *>(&val), 1);
     return val;
 }
 
 uint16_t StreamReader::getUint16() {
     uint16_t val;
-    _stream->read(reinterpret_cast<char *>(&val), 2);
+    readExact(reinterpret_cast<char *>(&val), 2);
     endian::conditional_reverse_inplace(val, _endianess, endian::order::native);
     return val;
 }
 
 uint32_t StreamReader::getUint32() {
     uint32_t val;
-    _stream->read(reinterpret_cast<char *>(&val), 4);
+    readExact(reinterpret_cast<char *>(&val), 4);
     endian::conditional_reverse_inplace(val, _endianess, endian::order::native);
     return val;
 }
 
 uint64_t StreamReader::getUint64() {
     uint64_t val;
-    _stream->read(reinterpret_cast<char *>(&val), 8);
+    readExact(reinterpret_cast<char *>(&val), 8);
     endian::conditional_reverse_inplace(val, _endianess, endian::order::native);
     return val;
 }
 
 int16_t StreamReader::getInt16() {
     int16_t val;
-    _stream->read(reinterpret_cast<char *>(&val), 2);
+    readExact(reinterpret_cast<char *>(&val), 2);
     endian::conditional_reverse_inplace(val, _endianess, endian::order::native);
     return val;
 }
 
 int32_t StreamReader::getInt32() {
     int32_t val;
-    _stream->read(reinterpret_cast<char *>(&val), 4);
+    readExact(reinterpret_cast<char *>(&val), 4);
     endian::conditional_reverse_inplace(val, _endianess, endian::order::native);
     return val;
 }
 
 int64_t StreamReader::getInt64() {
     int64_t val;
-    _stream->read(reinterpret_cast<char *>(&val), 8);
+    readExact(reinterpret_cast<char *>(&val), 8);
     endian::conditional_reverse_inplace(val, _endianess, endian::order::native);
     return val;
 }
 
 float StreamReader::getFloat() {
     uint32_t val;
-    _stream->read(reinterpret_cast<char *>(&val), 4);
+    readExact(reinterpret_cast<char *>(&val), 4);
     endian::conditional_reverse_inplace(val, _endianess, endian::order::native);
     return *reinterpret_cast<float *>(&val);
 }
 
 double StreamReader::getDouble() {
     uint64_t val;
-    _stream->read(reinterpret_cast<char *>(&val), 8);
+    readExact(reinterpret_cast<char *>(&val), 8);
     endian::conditional_reverse_inplace(val, _endianess, endian::order::native);
     return *reinterpret_cast<double *>(&val);
 }
@@ -101,15 +147,27 @@ double StreamReader::getDouble() {
 string StreamReader::getString(int len) {
     string val;
     val.resize(len);
-    _stream->read(&val[0], len);
+    readExact(&val[0], len);
     return move(val);
 }
 
 string StreamReader::getNullTerminatedString() {
-    stringbuf ss;
-    _stream->get(ss, '\0');
-    _stream->seekg(1, ios::cur);
-    return ss.str();
+    if (_stream) {
+        stringbuf ss;
+        _stream->get(ss, '\0');
+        _stream->seekg(1, ios::cur);
+        return ss.str();
+    }
+    const char *begin = _view.data + _pos;
+    size_t available = _view.size - _pos;
+    auto end = static_cast<const char *>(memchr(begin, '\0', available));
+    if (!end) {
+        _pos = _view.size;
+        _eof = true;
+        return string(begin, available);
+    }
+    _pos += end - begin + 1;
+    return string(begin, end);
 }
 
 u16string StreamReader::getNullTerminatedStringUTF16() {
@@ -129,12 +187,117 @@ u16string StreamReader::getNullTerminatedStringUTF16() {
 ByteArray StreamReader::getBytes(int count) {
     ByteArray result;
     result.resize(count);
-    _stream->read(reinterpret_cast<char *>(&result[0]), count);
+    readExact(&result[0], count);
+    return move(result);
+}
+
+template <class T>
+static void reverseArray(T *values, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        endian::endian_reverse_inplace(values[i]);
+    }
+}
+
+static void reverseArray(float *values, size_t count) {
+    // Swap bit patterns, so that the loop is vectorized and no float is ever
+    // observed with its bytes reversed
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t bits;
+        memcpy(&bits, &values[i], sizeof(bits));
+        endian::endian_reverse_inplace(bits);
+        memcpy(&values[i], &bits, sizeof(bits));
+    }
+}
+
+void StreamReader::getUint16Array(uint16_t *dest, size_t count) {
+    readExact(reinterpret_cast<char *>(dest), count * sizeof(uint16_t));
+    if (_endianess != endian::order::native) {
+        reverseArray(dest, count);
+    }
+}
+
+void StreamReader::getUint32Array(uint32_t *dest, size_t count) {
+    readExact(reinterpret_cast<char *>(dest), count * sizeof(uint32_t));
+    if (_endianess != endian::order::native) {
+        reverseArray(dest, count);
+    }
+}
+
+void StreamReader::getFloatArray(float *dest, size_t count) {
+    readExact(reinterpret_cast<char *>(dest), count * sizeof(float));
+    if (_endianess != endian::order::native) {
+        reverseArray(dest, count);
+    }
+}
+
+vector<uint16_t> StreamReader::getUint16Array(int count) {
+    vector<uint16_t> result(count);
+    if (count > 0) {
+        getUint16Array(&result[0], count);
+    }
+    return move(result);
+}
+
+vector<uint32_t> StreamReader::getUint32Array(int count) {
+    vector<uint32_t> result(count);
+    if (count > 0) {
+        getUint32Array(&result[0], count);
+    }
+    return move(result);
+}
+
+vector<uint32_t> StreamReader::getUint32Array(size_t offset, int count) {
+    size_t pos = tell();
+    seek(offset);
+
+    vector<uint32_t> result(getUint32Array(count));
+    seek(pos);
+
+    return move(result);
+}
+
+vector<float> StreamReader::getFloatArray(int count) {
+    vector<float> result(count);
+    if (count > 0) {
+        getFloatArray(&result[0], count);
+    }
+    return move(result);
+}
+
+vector<float> StreamReader::getFloatArray(size_t offset, int count) {
+    size_t pos = tell();
+    seek(offset);
+
+    vector<float> result(getFloatArray(count));
+    seek(pos);
+
+    return move(result);
+}
+
+ByteView StreamReader::getView(size_t count) {
+    if (_stream) {
+        auto bytes = make_shared<ByteArray>(count);
+        if (count > 0) {
+            readExact(&(*bytes)[0], count);
+        }
+        const char *data = bytes->data();
+        return ByteView(data, count, move(bytes));
+    }
+    size_t available = _view.size - _pos;
+    if (count > available) {
+        throw out_of_range("View out of range: " + to_string(count));
+    }
+    ByteView result(_view.slice(_pos, count));
+    _pos += count;
+
     return move(result);
 }
 
 bool StreamReader::eof() const {
-    return _stream->eof();
+    if (_stream) {
+        return _stream->eof();
+    }
+    return _eof;
 }
 
 } // namespace reone
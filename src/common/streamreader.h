@@ -22,7 +22,9 @@
 namespace reone {
 
 /**
- * Abstraction over reading primitive data types from a standard input stream.
+ * Abstraction over reading primitive data types from either a standard input
+ * stream or a read-only byte view. Reading from a view bypasses the stream
+ * machinery altogether.
  */
 class StreamReader : boost::noncopyable {
 public:
@@ -33,6 +35,13 @@ public:
         _endianess(endianess) {
     }
 
+    StreamReader(
+        ByteView view,
+        boost::endian::order endianess = boost::endian::order::little) :
+        _view(std::move(view)),
+        _endianess(endianess) {
+    }
+
     size_t tell();
     void seek(size_t pos);
     void ignore(int count);
@@ -51,58 +60,55 @@ public:
     std::u16string getNullTerminatedStringUTF16();
     ByteArray getBytes(int count);
 
-    bool eof() const;
-
-    inline std::vector<uint16_t> getUint16Array(int count) {
-        std::vector<uint16_t> result;
-        result.reserve(count);
-        for (int i = 0; i < count; ++i) {
-            result.push_back(getUint16());
-        }
-        return std::move(result);
-    }
-
-    inline std::vector<uint32_t> getUint32Array(int count) {
-        std::vector<uint32_t> result;
-        result.reserve(count);
-        for (int i = 0; i < count; ++i) {
-            result.push_back(getUint32());
-        }
-        return std::move(result);
-    }
-
-    inline std::vector<uint32_t> getUint32Array(size_t offset, int count) {
-        size_t pos = tell();
-        seek(offset);
-
-        std::vector<uint32_t> result(getUint32Array(count));
-        seek(pos);
-
-        return std::move(result);
-    }
-
-    inline std::vector<float> getFloatArray(int count) {
-        std::vector<float> result;
-        result.reserve(count);
-        for (int i = 0; i < count; ++i) {
-            result.push_back(getFloat());
-        }
-        return std::move(result);
-    }
+    /**
+     * Reads at most count bytes into dest.
+     *
+     * @return number of bytes actually read
+     */
+    size_t read(char *dest, size_t count);
 
-    inline std::vector<float> getFloatArray(size_t offset, int count) {
-        size_t pos = tell();
-        seek(offset);
+    bool eof() const;
 
-        std::vector<float> result(getFloatArray(count));
-        seek(pos);
-
-        return std::move(result);
-    }
+    /**
+     * @return true if this reader is backed by a byte view, false if by a stream
+     */
+    bool isView() const { return !_stream; }
+
+    /**
+     * @return byte view backing this reader, or an empty view if backed by a stream
+     */
+    const ByteView &view() const { return _view; }
+
+    /**
+     * Reads count values into dest in a single read, converting them from
+     * the endianess of this reader only if it differs from native.
+     */
+    void getUint16Array(uint16_t *dest, size_t count);
+    void getUint32Array(uint32_t *dest, size_t count);
+    void getFloatArray(float *dest, size_t count);
+
+    std::vector<uint16_t> getUint16Array(int count);
+    std::vector<uint32_t> getUint32Array(int count);
+    std::vector<uint32_t> getUint32Array(size_t offset, int count);
+    std::vector<float> getFloatArray(int count);
+    std::vector<float> getFloatArray(size_t offset, int count);
+
+    /**
+     * Reads count bytes without copying, if this reader is backed by a byte
+     * view. Otherwise, bytes are copied into a new buffer.
+     *
+     * @return view into the bytes read
+     */
+    ByteView getView(size_t count);
 
 private:
     std::shared_ptr<std::istream> _stream;
+    ByteView _view;
+    size_t _pos {0}; /**< read position within the view */
+    bool _eof {false}; /**< true if a read past the end of the view was attempted */
     boost::endian::order _endianess;
+
+    void readExact(char *dest, size_t count);
 };
 
 } // namespace reone
@@ -28,4 +28,18 @@ unique_ptr<istream> wrap(const ByteArray &arr) {
     return make_unique<io::stream<io::array_source>>(source);
 }
 
+unique_ptr<istream> wrap(const ByteView &view) {
+    io::array_source source(view.data, view.size);
+    return make_unique<io::stream<io::array_source>>(source);
+}
+
+ByteView makeView(shared_ptr<ByteArray> arr) {
+    if (!arr) {
+        return ByteView();
+    }
+    const char *data = arr->data();
+    size_t size = arr->size();
+    return ByteView(data, size, move(arr));
+}
+
 } // namespace reone
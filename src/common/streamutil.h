@@ -33,6 +33,16 @@ inline std::unique_ptr<std::istream> wrap(const std::shared_ptr<ByteArray> &arr)
     return wrap(*arr.get());
 }
 
+/**
+ * Wraps byte view in a standard input stream.
+ */
+std::unique_ptr<std::istream> wrap(const ByteView &view);
+
+/**
+ * @return read-only view into the shared byte array, which is kept alive by the view
+ */
+ByteView makeView(std::shared_ptr<ByteArray> arr);
+
 /**
  * Unwrap standard output stream into a byte array.
  */
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "threadpool.h"
+
+using namespace std;
+
+namespace reone {
+
+ThreadPool::ThreadPool(int numThreads) {
+    if (numThreads <= 0) {
+        // Leave one core to the main thread
+        numThreads = max(1, static_cast<int>(thread::hardware_concurrency()) - 1);
+    }
+    for (int i = 0; i < numThreads; ++i) {
+        _threads.push_back(thread(&ThreadPool::workerLoop, this));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _condition.notify_all();
+    for (auto &thread : _threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        function<void()> task;
+        {
+            unique_lock<mutex> lock(_mutex);
+            _condition.wait(lock, [this]() { return _stopping || !_tasks.empty(); });
+            if (_tasks.empty()) {
+                return; // stopping and no pending tasks
+            }
+            task = move(_tasks.front());
+            _tasks.pop();
+        }
+        task();
+    }
+}
+
+} // namespace reone
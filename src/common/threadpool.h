@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+namespace reone {
+
+/**
+ * Fixed-size pool of worker threads, executing tasks in FIFO order. Tasks must
+ * not log, as logging is only allowed on the main thread.
+ */
+class ThreadPool : boost::noncopyable {
+public:
+    /**
+     * @param numThreads number of worker threads, or 0 to derive from hardware concurrency
+     */
+    ThreadPool(int numThreads = 0);
+
+    /**
+     * Completes pending tasks and joins worker threads.
+     */
+    ~ThreadPool();
+
+    /**
+     * @return future, that is made ready when the task completes or throws
+     */
+    template <class F>
+    auto enqueue(F task) -> std::future<decltype(task())> {
+        typedef decltype(task()) R;
+        auto packagedTask = std::make_shared<std::packaged_task<R()>>(std::move(task));
+        std::future<R> result(packagedTask->get_future());
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _tasks.push([packagedTask]() { (*packagedTask)(); });
+        }
+        _condition.notify_one();
+
+        return result;
+    }
+
+    int numThreads() const { return static_cast<int>(_threads.size()); }
+
+private:
+    std::vector<std::thread> _threads;
+    std::queue<std::function<void()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stopping {false};
+
+    void workerLoop();
+};
+
+} // namespace reone
@@ -46,4 +46,31 @@ struct LogChannels {
 
 typedef std::vector<char> ByteArray;
 
+/**
+ * Read-only view into a contiguous range of bytes. Underlying storage, e.g. a
+ * memory-mapped file or a shared byte array, is kept alive by the owner.
+ */
+struct ByteView {
+    const char *data {nullptr};
+    size_t size {0};
+    std::shared_ptr<const void> owner;
+
+    ByteView() = default;
+
+    ByteView(const char *data, size_t size, std::shared_ptr<const void> owner = nullptr) :
+        data(data),
+        size(size),
+        owner(std::move(owner)) {
+    }
+
+    ByteView slice(size_t offset, size_t count) const {
+        if (offset + count > size) {
+            throw std::out_of_range("Byte view slice out of range");
+        }
+        return ByteView(data + offset, count, owner);
+    }
+
+    explicit operator bool() const { return data != nullptr; }
+};
+
 } // namespace reone
@@ -21,10 +21,15 @@ using namespace std;
 
 using namespace reone::resource;
 
+namespace fs = boost::filesystem;
+
 namespace reone {
 
+static constexpr char kIndexCacheDirectoryName[] = "cache";
+
 void ResourceModule::init() {
     _resources = make_unique<Resources>();
+    _resources->setIndexCacheDirectory(fs::current_path() / kIndexCacheDirectoryName);
     _strings = make_unique<Strings>();
     _twoDas = make_unique<TwoDas>(*_resources);
     _gffs = make_unique<Gffs>(*_resources);
@@ -57,6 +57,10 @@ Options OptionsParser::parse() {
         ("voicevol", po::value<int>()->default_value(options.audio.voiceVolume), "voice volume in percents")                       //
         ("soundvol", po::value<int>()->default_value(options.audio.soundVolume), "sound volume in percents")                       //
         ("movievol", po::value<int>()->default_value(options.audio.movieVolume), "movie volume in percents")                       //
+        ("jobbudget", po::value<float>()->default_value(options.jobBudget), "per-frame budget of periodic jobs in ms")             //
+        ("scriptopt", po::value<bool>()->default_value(options.optimizeScripts), "optimize scripts")                               //
+        ("scriptverify", po::value<bool>()->default_value(options.verifyScripts), "verify optimized scripts against originals")    //
+        ("scriptbudget", po::value<float>()->default_value(options.scriptBudget), "per-frame budget of yielded scripts in ms")     //
         ("loglevel", po::value<int>()->default_value(static_cast<int>(options.logLevel)), "log level")                             //
         ("logch", po::value<int>()->default_value(options.logChannels), "log channel mask")                                        //
         ("logfile", po::value<bool>()->default_value(options.logToFile), "log to file");
@@ -93,6 +97,10 @@ Options OptionsParser::parse() {
     options.audio.voiceVolume = vars["voicevol"].as<int>();
     options.audio.soundVolume = vars["soundvol"].as<int>();
     options.audio.movieVolume = vars["movievol"].as<int>();
+    options.jobBudget = vars["jobbudget"].as<float>();
+    options.optimizeScripts = vars["scriptopt"].as<bool>();
+    options.verifyScripts = vars["scriptverify"].as<bool>();
+    options.scriptBudget = vars["scriptbudget"].as<float>();
     options.developer = vars["dev"].as<bool>();
     options.logLevel = static_cast<LogLevel>(vars["loglevel"].as<int>());
     options.logChannels = vars["logch"].as<int>();
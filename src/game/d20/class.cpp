@@ -68,13 +68,18 @@ void CreatureClass::loadClassSkills(const string &skillsTable) {
 
 void CreatureClass::loadSavingThrows(const string &savingThrowTable) {
     shared_ptr<TwoDA> twoDa(_twoDas.get(savingThrowTable));
+    TwoDA::ColumnRef levelColumn(twoDa->getColumn("level"));
+    TwoDA::ColumnRef fortSaveColumn(twoDa->getColumn("fortsave"));
+    TwoDA::ColumnRef refSaveColumn(twoDa->getColumn("refsave"));
+    TwoDA::ColumnRef willSaveColumn(twoDa->getColumn("willsave"));
+
     for (int row = 0; row < twoDa->getRowCount(); ++row) {
-        int level = twoDa->getInt(row, "level");
+        int level = twoDa->getInt(row, levelColumn);
 
         SavingThrows throws;
-        throws.fortitude = twoDa->getInt(row, "fortsave");
-        throws.reflex = twoDa->getInt(row, "refsave");
-        throws.will = twoDa->getInt(row, "willsave");
+        throws.fortitude = twoDa->getInt(row, fortSaveColumn);
+        throws.reflex = twoDa->getInt(row, refSaveColumn);
+        throws.will = twoDa->getInt(row, willSaveColumn);
 
         _savingThrowsByLevel.insert(make_pair(level, move(throws)));
     }
@@ -82,8 +87,10 @@ void CreatureClass::loadSavingThrows(const string &savingThrowTable) {
 
 void CreatureClass::loadAttackBonuses(const string &attackBonusTable) {
     shared_ptr<TwoDA> twoDa(_twoDas.get(attackBonusTable));
+    TwoDA::ColumnRef babColumn(twoDa->getColumn("bab"));
+
     for (int row = 0; row < twoDa->getRowCount(); ++row) {
-        _attackBonuses.push_back(twoDa->getInt(row, "bab"));
+        _attackBonuses.push_back(twoDa->getInt(row, babColumn));
     }
 }
 
@@ -38,15 +38,24 @@ void Feats::init() {
         return;
     }
 
+    TwoDA::ColumnRef nameColumn(feats->getColumn("name"));
+    TwoDA::ColumnRef descriptionColumn(feats->getColumn("description"));
+    TwoDA::ColumnRef iconColumn(feats->getColumn("icon"));
+    TwoDA::ColumnRef minCharLevelColumn(feats->getColumn("mincharlevel"));
+    TwoDA::ColumnRef preReqFeat1Column(feats->getColumn("prereqfeat1"));
+    TwoDA::ColumnRef preReqFeat2Column(feats->getColumn("prereqfeat2"));
+    TwoDA::ColumnRef successorColumn(feats->getColumn("successor"));
+    TwoDA::ColumnRef pipsColumn(feats->getColumn("pips"));
+
     for (int row = 0; row < feats->getRowCount(); ++row) {
-        string name(_strings.get(feats->getInt(row, "name", -1)));
-        string description(_strings.get(feats->getInt(row, "description", -1)));
-        shared_ptr<Texture> icon(_textures.get(feats->getString(row, "icon"), TextureUsage::GUI));
-        uint32_t minCharLevel = feats->getUint(row, "mincharlevel");
-        auto preReqFeat1 = static_cast<FeatType>(feats->getUint(row, "prereqfeat1"));
-        auto preReqFeat2 = static_cast<FeatType>(feats->getUint(row, "prereqfeat2"));
-        auto successor = static_cast<FeatType>(feats->getUint(row, "successor"));
-        uint32_t pips = feats->getUint(row, "pips");
+        string name(_strings.get(feats->getInt(row, nameColumn, -1)));
+        string description(_strings.get(feats->getInt(row, descriptionColumn, -1)));
+        shared_ptr<Texture> icon(_textures.get(feats->getString(row, iconColumn), TextureUsage::GUI));
+        uint32_t minCharLevel = feats->getUint(row, minCharLevelColumn);
+        auto preReqFeat1 = static_cast<FeatType>(feats->getUint(row, preReqFeat1Column));
+        auto preReqFeat2 = static_cast<FeatType>(feats->getUint(row, preReqFeat2Column));
+        auto successor = static_cast<FeatType>(feats->getUint(row, successorColumn));
+        uint32_t pips = feats->getUint(row, pipsColumn);
 
         auto feat = make_shared<Feat>();
         feat->name = move(name);
@@ -38,10 +38,14 @@ void Skills::init() {
         return;
     }
 
+    TwoDA::ColumnRef nameColumn(skills->getColumn("name"));
+    TwoDA::ColumnRef descriptionColumn(skills->getColumn("description"));
+    TwoDA::ColumnRef iconColumn(skills->getColumn("icon"));
+
     for (int row = 0; row < skills->getRowCount(); ++row) {
-        string name(_strings.get(skills->getInt(row, "name", -1)));
-        string description(_strings.get(skills->getInt(row, "description", -1)));
-        shared_ptr<Texture> icon(_textures.get(skills->getString(row, "icon"), TextureUsage::GUI));
+        string name(_strings.get(skills->getInt(row, nameColumn, -1)));
+        string description(_strings.get(skills->getInt(row, descriptionColumn, -1)));
+        shared_ptr<Texture> icon(_textures.get(skills->getString(row, iconColumn), TextureUsage::GUI));
 
         auto skill = make_shared<Skill>();
         skill->name = move(name);
@@ -37,11 +37,16 @@ void Spells::init() {
     if (!spells)
         return;
 
+    TwoDA::ColumnRef nameColumn(spells->getColumn("name"));
+    TwoDA::ColumnRef descriptionColumn(spells->getColumn("spelldesc"));
+    TwoDA::ColumnRef iconColumn(spells->getColumn("iconresref"));
+    TwoDA::ColumnRef pipsColumn(spells->getColumn("pips"));
+
     for (int row = 0; row < spells->getRowCount(); ++row) {
-        string name(_strings.get(spells->getInt(row, "name", -1)));
-        string description(_strings.get(spells->getInt(row, "spelldesc", -1)));
-        shared_ptr<Texture> icon(_textures.get(spells->getString(row, "iconresref"), TextureUsage::GUI));
-        uint32_t pips = spells->getUint(row, "pips");
+        string name(_strings.get(spells->getInt(row, nameColumn, -1)));
+        string description(_strings.get(spells->getInt(row, descriptionColumn, -1)));
+        shared_ptr<Texture> icon(_textures.get(spells->getString(row, iconColumn), TextureUsage::GUI));
+        uint32_t pips = spells->getUint(row, pipsColumn);
 
         auto spell = make_shared<Spell>();
         spell->name = move(name);
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "delayedactions.h"
+
+using namespace std;
+
+namespace reone {
+
+namespace game {
+
+void DelayedActions::add(uint32_t objectId, unique_ptr<Action> action, float delay) {
+    DelayedAction delayed;
+    delayed.time = _time + max(0.0f, delay);
+    delayed.order = _order++;
+    delayed.objectId = objectId;
+    delayed.action = move(action);
+    _actions.push_back(move(delayed));
+    push_heap(_actions.begin(), _actions.end(), DueLater());
+}
+
+void DelayedActions::removeIf(const function<bool(uint32_t objectId)> &pred) {
+    auto removeBegin = remove_if(_actions.begin(), _actions.end(), [&pred](auto &delayed) { return pred(delayed.objectId); });
+    if (removeBegin == _actions.end()) {
+        return;
+    }
+    _actions.erase(removeBegin, _actions.end());
+    make_heap(_actions.begin(), _actions.end(), DueLater());
+}
+
+void DelayedActions::update(float dt, const ActionHandler &handler) {
+    _time += dt;
+
+    // Handler may add new delayed actions, so pop before invoking it
+    while (!_actions.empty() && _actions.front().time <= _time) {
+        pop_heap(_actions.begin(), _actions.end(), DueLater());
+        DelayedAction delayed(move(_actions.back()));
+        _actions.pop_back();
+
+        handler(delayed.objectId, move(delayed.action));
+    }
+}
+
+} // namespace game
+
+} // namespace reone
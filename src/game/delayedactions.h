@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "action.h"
+
+namespace reone {
+
+namespace game {
+
+/**
+ * Holds delayed actions of all objects, ordered by due time. Per-frame cost
+ * depends only on the number of actions that become due, rather than on the
+ * number of objects.
+ */
+class DelayedActions : boost::noncopyable {
+public:
+    typedef std::function<void(uint32_t objectId, std::unique_ptr<Action> action)> ActionHandler;
+
+    void add(uint32_t objectId, std::unique_ptr<Action> action, float delay);
+
+    /**
+     * Removes delayed actions of objects, for which the predicate returns true.
+     */
+    void removeIf(const std::function<bool(uint32_t objectId)> &pred);
+
+    /**
+     * Advances the clock and passes due actions to the handler, in order of
+     * their due time. Actions with equal due time are passed in the order
+     * they were added.
+     */
+    void update(float dt, const ActionHandler &handler);
+
+    bool empty() const { return _actions.empty(); }
+    int size() const { return static_cast<int>(_actions.size()); }
+
+private:
+    struct DelayedAction {
+        double time {0.0};
+        uint64_t order {0};
+        uint32_t objectId {0};
+        std::unique_ptr<Action> action;
+    };
+
+    struct DueLater {
+        bool operator()(const DelayedAction &left, const DelayedAction &right) const {
+            return left.time != right.time ? left.time > right.time : left.order > right.order;
+        }
+    };
+
+    std::vector<DelayedAction> _actions; /**< min-heap by due time */
+    double _time {0.0};
+    uint64_t _order {0};
+};
+
+} // namespace game
+
+} // namespace reone
@@ -88,6 +88,8 @@ void Game::init() {
         scene.second->setLineOfSightSurfaces(lineOfSightSurfaces);
     }
 
+    _workerPool = make_unique<ThreadPool>();
+
     loadModuleNames();
     setCursorType(CursorType::Default);
 }
@@ -125,8 +127,10 @@ void Game::update() {
 
     bool updModule = !_movie && _module && (_screen == GameScreen::InGame || _screen == GameScreen::Conversation);
     if (updModule && !_paused) {
+        updateDelayedActions(dt);
         _module->update(dt);
         _combat.update(dt);
+        _scriptRunner->resumeYielded(_options.scriptBudget / 1000.0f);
     }
 
     GUI *gui = getScreenGUI();
@@ -169,9 +173,21 @@ void Game::loadModule(const string &name, string entry) {
 
         try {
             if (_module) {
-                _module->area()->runOnExitScript();
-                _module->area()->unloadParty();
+                shared_ptr<Area> area(_module->area());
+                area->runOnExitScript();
+
+                // Party members leave the area together with their delayed actions
+                unordered_set<uint32_t> areaObjectIds {area->id()};
+                for (auto &object : area->objects()) {
+                    if (!_party.isMember(*object)) {
+                        areaObjectIds.insert(object->id());
+                    }
+                }
+                _delayedActions.removeIf([&areaObjectIds](uint32_t objectId) { return areaObjectIds.count(objectId) > 0; });
+
+                area->unloadParty();
             }
+            _scriptRunner->cancelYielded();
 
             loadModuleResources(name);
             if (_loadScreen) {
@@ -340,6 +356,16 @@ Camera *Game::getActiveCamera() const {
     return &area->getCamera(_cameraType);
 }
 
+void Game::updateDelayedActions(float dt) {
+    _delayedActions.update(dt, [this](uint32_t objectId, unique_ptr<Action> action) {
+        // Actions of objects destroyed in the meantime are discarded
+        shared_ptr<Object> object(getObjectById(objectId));
+        if (object) {
+            object->addAction(move(action));
+        }
+    });
+}
+
 shared_ptr<Object> Game::getObjectById(uint32_t id) const {
     switch (id) {
     case kObjectSelf:
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "../../audio/source.h"
+#include "../../common/threadpool.h"
 #include "../../graphics/eventhandler.h"
 #include "../../movie/movie.h"
 #include "../../script/routines.h"
@@ -25,6 +26,7 @@
 #include "action/factory.h"
 #include "camera.h"
 #include "combat.h"
+#include "delayedactions.h"
 #include "effect/factory.h"
 #include "gui/console.h"
 #include "gui/loadscreen.h"
@@ -86,10 +88,12 @@ public:
     const Options &options() const { return _options; }
     Party &party() { return _party; }
     Combat &combat() { return _combat; }
+    DelayedActions &delayedActions() { return _delayedActions; }
     ActionFactory &actionFactory() { return _actionFactory; }
     EffectFactory &effectFactory() { return _effectFactory; }
     ObjectFactory &objectFactory() { return _objectFactory; }
     ScriptRunner &scriptRunner() { return *_scriptRunner; }
+    ThreadPool &workerPool() { return *_workerPool; }
     IMap &map() { return *_map; }
     script::IRoutines &routines() { return *_routines; }
 
@@ -189,12 +193,14 @@ protected:
 
     Party _party;
     Combat _combat;
+    DelayedActions _delayedActions;
     ActionFactory _actionFactory;
     EffectFactory _effectFactory;
     ObjectFactory _objectFactory;
 
     std::unique_ptr<script::IRoutines> _routines;
     std::unique_ptr<ScriptRunner> _scriptRunner;
+    std::unique_ptr<ThreadPool> _workerPool; /**< batched jobs, such as line of sight tests */
 
     // END Services
 
@@ -255,6 +261,7 @@ protected:
     void updateMusic();
     void updateMovie(float dt);
     void updateCamera(float dt);
+    void updateDelayedActions(float dt);
     void updateSceneGraph(float dt);
 
     void loadDefaultParty();
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../resource/gfflabels.h"
+
+namespace reone {
+
+namespace game {
+
+// Pre-hashed labels of GFF fields read when loading blueprints and areas
+
+static constexpr resource::GffKey kFieldAnimationState("AnimationState");
+static constexpr resource::GffKey kFieldAppearance("Appearance");
+static constexpr resource::GffKey kFieldAppearanceType("Appearance_Type");
+static constexpr resource::GffKey kFieldAreaProperties("AreaProperties");
+static constexpr resource::GffKey kFieldAutoRemoveKey("AutoRemoveKey");
+static constexpr resource::GffKey kFieldBearing("Bearing");
+static constexpr resource::GffKey kFieldBodyBag("BodyBag");
+static constexpr resource::GffKey kFieldBodyVariation("BodyVariation");
+static constexpr resource::GffKey kFieldCameraList("CameraList");
+static constexpr resource::GffKey kFieldCha("Cha");
+static constexpr resource::GffKey kFieldChallengeRating("ChallengeRating");
+static constexpr resource::GffKey kFieldClass("Class");
+static constexpr resource::GffKey kFieldClassLevel("ClassLevel");
+static constexpr resource::GffKey kFieldClassList("ClassList");
+static constexpr resource::GffKey kFieldCon("Con");
+static constexpr resource::GffKey kFieldConversation("Conversation");
+static constexpr resource::GffKey kFieldCreatureList("Creature List");
+static constexpr resource::GffKey kFieldCurrentForce("CurrentForce");
+static constexpr resource::GffKey kFieldCurrentHP("CurrentHP");
+static constexpr resource::GffKey kFieldCurrentHitPoints("CurrentHitPoints");
+static constexpr resource::GffKey kFieldDex("Dex");
+static constexpr resource::GffKey kFieldDisarmable("Disarmable");
+static constexpr resource::GffKey kFieldDoorList("Door List");
+static constexpr resource::GffKey kFieldDropable("Dropable");
+static constexpr resource::GffKey kFieldEncounterList("Encounter List");
+static constexpr resource::GffKey kFieldEquipItemList("Equip_ItemList");
+static constexpr resource::GffKey kFieldEquippedRes("EquippedRes");
+static constexpr resource::GffKey kFieldFaction("Faction");
+static constexpr resource::GffKey kFieldFactionID("FactionID");
+static constexpr resource::GffKey kFieldFeat("Feat");
+static constexpr resource::GffKey kFieldFeatList("FeatList");
+static constexpr resource::GffKey kFieldFirstName("FirstName");
+static constexpr resource::GffKey kFieldForcePoints("ForcePoints");
+static constexpr resource::GffKey kFieldFort("Fort");
+static constexpr resource::GffKey kFieldFortbonus("fortbonus");
+static constexpr resource::GffKey kFieldGender("Gender");
+static constexpr resource::GffKey kFieldGenericType("GenericType");
+static constexpr resource::GffKey kFieldGoodEvil("GoodEvil");
+static constexpr resource::GffKey kFieldHP("HP");
+static constexpr resource::GffKey kFieldHardness("Hardness");
+static constexpr resource::GffKey kFieldHasInventory("HasInventory");
+static constexpr resource::GffKey kFieldHitPoints("HitPoints");
+static constexpr resource::GffKey kFieldInt("Int");
+static constexpr resource::GffKey kFieldInterruptable("Interruptable");
+static constexpr resource::GffKey kFieldInventoryRes("InventoryRes");
+static constexpr resource::GffKey kFieldIsPC("IsPC");
+static constexpr resource::GffKey kFieldItemList("ItemList");
+static constexpr resource::GffKey kFieldKeyName("KeyName");
+static constexpr resource::GffKey kFieldKeyRequired("KeyRequired");
+static constexpr resource::GffKey kFieldKnownList0("KnownList0");
+static constexpr resource::GffKey kFieldLastName("LastName");
+static constexpr resource::GffKey kFieldLinkedTo("LinkedTo");
+static constexpr resource::GffKey kFieldLinkedToFlags("LinkedToFlags");
+static constexpr resource::GffKey kFieldLinkedToModule("LinkedToModule");
+static constexpr resource::GffKey kFieldLocName("LocName");
+static constexpr resource::GffKey kFieldLockable("Lockable");
+static constexpr resource::GffKey kFieldLocked("Locked");
+static constexpr resource::GffKey kFieldMaxHitPoints("MaxHitPoints");
+static constexpr resource::GffKey kFieldMin1HP("Min1HP");
+static constexpr resource::GffKey kFieldMusicDay("MusicDay");
+static constexpr resource::GffKey kFieldNaturalAC("NaturalAC");
+static constexpr resource::GffKey kFieldNoPermDeath("NoPermDeath");
+static constexpr resource::GffKey kFieldNotReorienting("NotReorienting");
+static constexpr resource::GffKey kFieldOnClick("OnClick");
+static constexpr resource::GffKey kFieldOnClosed("OnClosed");
+static constexpr resource::GffKey kFieldOnDamaged("OnDamaged");
+static constexpr resource::GffKey kFieldOnDeath("OnDeath");
+static constexpr resource::GffKey kFieldOnEndDialogue("OnEndDialogue");
+static constexpr resource::GffKey kFieldOnFailToOpen("OnFailToOpen");
+static constexpr resource::GffKey kFieldOnHeartbeat("OnHeartbeat");
+static constexpr resource::GffKey kFieldOnInvDisturbed("OnInvDisturbed");
+static constexpr resource::GffKey kFieldOnLock("OnLock");
+static constexpr resource::GffKey kFieldOnMeleeAttacked("OnMeleeAttacked");
+static constexpr resource::GffKey kFieldOnOpen("OnOpen");
+static constexpr resource::GffKey kFieldOnSpellCastAt("OnSpellCastAt");
+static constexpr resource::GffKey kFieldOnUnlock("OnUnlock");
+static constexpr resource::GffKey kFieldOnUsed("OnUsed");
+static constexpr resource::GffKey kFieldOnUserDefined("OnUserDefined");
+static constexpr resource::GffKey kFieldOpenLockDC("OpenLockDC");
+static constexpr resource::GffKey kFieldPartyInteract("PartyInteract");
+static constexpr resource::GffKey kFieldPerceptionRange("PerceptionRange");
+static constexpr resource::GffKey kFieldPlaceableList("Placeable List");
+static constexpr resource::GffKey kFieldPlot("Plot");
+static constexpr resource::GffKey kFieldPortraitId("PortraitId");
+static constexpr resource::GffKey kFieldRace("Race");
+static constexpr resource::GffKey kFieldRank("Rank");
+static constexpr resource::GffKey kFieldRefbonus("refbonus");
+static constexpr resource::GffKey kFieldScriptAttacked("ScriptAttacked");
+static constexpr resource::GffKey kFieldScriptDamaged("ScriptDamaged");
+static constexpr resource::GffKey kFieldScriptDeath("ScriptDeath");
+static constexpr resource::GffKey kFieldScriptDialogue("ScriptDialogue");
+static constexpr resource::GffKey kFieldScriptDisturbed("ScriptDisturbed");
+static constexpr resource::GffKey kFieldScriptEndDialogu("ScriptEndDialogu");
+static constexpr resource::GffKey kFieldScriptEndRound("ScriptEndRound");
+static constexpr resource::GffKey kFieldScriptHeartbeat("ScriptHeartbeat");
+static constexpr resource::GffKey kFieldScriptOnBlocked("ScriptOnBlocked");
+static constexpr resource::GffKey kFieldScriptOnNotice("ScriptOnNotice");
+static constexpr resource::GffKey kFieldScriptSpawn("ScriptSpawn");
+static constexpr resource::GffKey kFieldScriptSpellAt("ScriptSpellAt");
+static constexpr resource::GffKey kFieldScriptUserDefine("ScriptUserDefine");
+static constexpr resource::GffKey kFieldSkillList("SkillList");
+static constexpr resource::GffKey kFieldSoundList("SoundList");
+static constexpr resource::GffKey kFieldSoundSetFile("SoundSetFile");
+static constexpr resource::GffKey kFieldSpell("Spell");
+static constexpr resource::GffKey kFieldStatic("Static");
+static constexpr resource::GffKey kFieldStr("Str");
+static constexpr resource::GffKey kFieldSubraceIndex("SubraceIndex");
+static constexpr resource::GffKey kFieldTag("Tag");
+static constexpr resource::GffKey kFieldTemplateResRef("TemplateResRef");
+static constexpr resource::GffKey kFieldTextureVar("TextureVar");
+static constexpr resource::GffKey kFieldTransitionDestin("TransitionDestin");
+static constexpr resource::GffKey kFieldTriggerList("TriggerList");
+static constexpr resource::GffKey kFieldUseable("Useable");
+static constexpr resource::GffKey kFieldWalkRate("WalkRate");
+static constexpr resource::GffKey kFieldWaypointList("WaypointList");
+static constexpr resource::GffKey kFieldWillbonus("willbonus");
+static constexpr resource::GffKey kFieldWis("Wis");
+static constexpr resource::GffKey kFieldX("X");
+static constexpr resource::GffKey kFieldXOrientation("XOrientation");
+static constexpr resource::GffKey kFieldXPosition("XPosition");
+static constexpr resource::GffKey kFieldY("Y");
+static constexpr resource::GffKey kFieldYOrientation("YOrientation");
+static constexpr resource::GffKey kFieldYPosition("YPosition");
+static constexpr resource::GffKey kFieldZ("Z");
+static constexpr resource::GffKey kFieldZPosition("ZPosition");
+
+} // namespace game
+
+} // namespace reone
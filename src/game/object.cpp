@@ -83,15 +83,11 @@ void Object::addActionOnTop(unique_ptr<Action> action) {
 }
 
 void Object::delayAction(unique_ptr<Action> action, float seconds) {
-    DelayedAction delayed;
-    delayed.action = move(action);
-    delayed.timer.setTimeout(seconds);
-    _delayed.push_back(move(delayed));
+    _game.delayedActions().add(_id, move(action), seconds);
 }
 
 void Object::updateActions(float dt) {
     removeCompletedActions();
-    updateDelayedActions(dt);
 }
 
 void Object::removeCompletedActions() {
@@ -104,21 +100,6 @@ void Object::removeCompletedActions() {
     }
 }
 
-void Object::updateDelayedActions(float dt) {
-    for (auto &delayed : _delayed) {
-        delayed.timer.advance(dt);
-        if (delayed.timer.isTimedOut()) {
-            _actions.push_back(move(delayed.action));
-        }
-    }
-    auto delayedToRemove = remove_if(
-        _delayed.begin(),
-        _delayed.end(),
-        [](const DelayedAction &delayed) { return delayed.timer.isTimedOut(); });
-
-    _delayed.erase(delayedToRemove, _delayed.end());
-}
-
 void Object::executeActions(float dt) {
     if (_actions.empty()) {
         return;
@@ -316,6 +297,13 @@ void Object::setRoom(Room *room) {
 void Object::setPosition(const glm::vec3 &position) {
     _position = position;
     updateTransform();
+
+    // Objects moved by scripts and actions must be found by spatial queries
+    // before the next area update
+    auto module = _game.module();
+    if (module && module->area()) {
+        module->area()->onObjectMoved(*this);
+    }
 }
 
 void Object::updateTransform() {
@@ -197,11 +197,6 @@ public:
     // END Scripts
 
 protected:
-    struct DelayedAction {
-        std::unique_ptr<Action> action;
-        Timer timer;
-    };
-
     struct AppliedEffect {
         std::shared_ptr<Effect> effect;
         DurationType durationType {DurationType::Instant};
@@ -247,7 +242,6 @@ protected:
     // Actions
 
     std::deque<std::shared_ptr<Action>> _actions;
-    std::vector<DelayedAction> _delayed;
 
     // END Actions
 
@@ -285,7 +279,6 @@ protected:
 
     void updateActions(float dt);
     void removeCompletedActions();
-    void updateDelayedActions(float dt);
 
     void executeActions(float dt);
 
@@ -44,6 +44,7 @@
 
 #include "../camerastyles.h"
 #include "../game.h"
+#include "../gffkeys.h"
 #include "../layouts.h"
 #include "../location.h"
 #include "../party.h"
@@ -74,12 +75,19 @@ namespace game {
 
 static constexpr float kDefaultFieldOfView = 75.0f;
 static constexpr float kUpdatePerceptionInterval = 1.0f; // seconds
-static constexpr float kLineOfSightHeight = 1.7f;        // TODO: make it appearance-based
-static constexpr float kLineOfSightFOV = glm::radians(60.0f);
 
 static constexpr float kMaxCollisionDistance = 8.0f;
 static constexpr float kMaxCollisionDistance2 = kMaxCollisionDistance * kMaxCollisionDistance;
 
+// As documented for GetFirstObjectInShape in nwscript.nss
+static constexpr float kSpellConeHalfAngle = glm::radians(30.0f); // spell cones are 60 degrees wide
+static constexpr float kSpellCylinderRadius = 1.5f;
+
+enum class PeriodicJobType {
+    Heartbeat,
+    Perception
+};
+
 static glm::vec3 g_defaultAmbientColor {0.2f};
 static CameraStyle g_defaultCameraStyle {"", 3.2f, 83.0f, 0.45f, 55.0f};
 
@@ -97,13 +105,15 @@ Area::Area(
     _sceneName(move(sceneName)) {
 
     init();
-    _heartbeatTimer.setTimeout(kHeartbeatInterval);
 }
 
 void Area::init() {
     const GraphicsOptions &opts = _game.options().graphics;
     _cameraAspect = opts.width / static_cast<float>(opts.height);
 
+    _scheduler.setBudget(_game.options().jobBudget / 1000.0f);
+    _scheduler.add(static_cast<int>(PeriodicJobType::Heartbeat), _id, kHeartbeatInterval);
+
     _objectsByType.insert(make_pair(ObjectType::Creature, ObjectList()));
     _objectsByType.insert(make_pair(ObjectType::Item, ObjectList()));
     _objectsByType.insert(make_pair(ObjectType::Trigger, ObjectList()));
@@ -227,12 +237,12 @@ void Area::loadGIT(const GffStruct &git) {
 }
 
 void Area::loadProperties(const GffStruct &git) {
-    shared_ptr<GffStruct> props(git.getStruct("AreaProperties"));
+    shared_ptr<GffStruct> props(git.getStruct(kFieldAreaProperties));
     if (!props) {
         warn("Area properties not found in GIT");
         return;
     }
-    int musicIdx = props->getInt("MusicDay");
+    int musicIdx = props->getInt(kFieldMusicDay);
     if (musicIdx) {
         shared_ptr<TwoDA> musicTable(_services.twoDas.get("ambientmusic"));
         _music = musicTable->getString(musicIdx, "resource");
@@ -240,7 +250,7 @@ void Area::loadProperties(const GffStruct &git) {
 }
 
 void Area::loadCreatures(const GffStruct &git) {
-    for (auto &gffs : git.getList("Creature List")) {
+    for (auto &gffs : git.getList(kFieldCreatureList)) {
         shared_ptr<Creature> creature(_game.objectFactory().newCreature(_sceneName));
         creature->loadFromGIT(*gffs);
         landObject(*creature);
@@ -249,7 +259,7 @@ void Area::loadCreatures(const GffStruct &git) {
 }
 
 void Area::loadDoors(const GffStruct &git) {
-    for (auto &gffs : git.getList("Door List")) {
+    for (auto &gffs : git.getList(kFieldDoorList)) {
         shared_ptr<Door> door(_game.objectFactory().newDoor(_sceneName));
         door->loadFromGIT(*gffs);
         add(door);
@@ -257,7 +267,7 @@ void Area::loadDoors(const GffStruct &git) {
 }
 
 void Area::loadPlaceables(const GffStruct &git) {
-    for (auto &gffs : git.getList("Placeable List")) {
+    for (auto &gffs : git.getList(kFieldPlaceableList)) {
         shared_ptr<Placeable> placeable(_game.objectFactory().newPlaceable(_sceneName));
         placeable->loadFromGIT(*gffs);
         add(placeable);
@@ -265,7 +275,7 @@ void Area::loadPlaceables(const GffStruct &git) {
 }
 
 void Area::loadWaypoints(const GffStruct &git) {
-    for (auto &gffs : git.getList("WaypointList")) {
+    for (auto &gffs : git.getList(kFieldWaypointList)) {
         shared_ptr<Waypoint> waypoint(_game.objectFactory().newWaypoint(_sceneName));
         waypoint->loadFromGIT(*gffs);
         add(waypoint);
@@ -273,7 +283,7 @@ void Area::loadWaypoints(const GffStruct &git) {
 }
 
 void Area::loadTriggers(const GffStruct &git) {
-    for (auto &gffs : git.getList("TriggerList")) {
+    for (auto &gffs : git.getList(kFieldTriggerList)) {
         shared_ptr<Trigger> trigger(_game.objectFactory().newTrigger(_sceneName));
         trigger->loadFromGIT(*gffs);
         add(trigger);
@@ -281,7 +291,7 @@ void Area::loadTriggers(const GffStruct &git) {
 }
 
 void Area::loadSounds(const GffStruct &git) {
-    for (auto &gffs : git.getList("SoundList")) {
+    for (auto &gffs : git.getList(kFieldSoundList)) {
         shared_ptr<Sound> sound(_game.objectFactory().newSound(_sceneName));
         sound->loadFromGIT(*gffs);
         add(sound);
@@ -289,7 +299,7 @@ void Area::loadSounds(const GffStruct &git) {
 }
 
 void Area::loadCameras(const GffStruct &git) {
-    for (auto &gffs : git.getList("CameraList")) {
+    for (auto &gffs : git.getList(kFieldCameraList)) {
         shared_ptr<PlaceableCamera> camera(_game.objectFactory().newCamera(_sceneName));
         camera->loadFromGIT(*gffs);
         add(camera);
@@ -297,7 +307,7 @@ void Area::loadCameras(const GffStruct &git) {
 }
 
 void Area::loadEncounters(const GffStruct &git) {
-    for (auto &gffs : git.getList("Encounter List")) {
+    for (auto &gffs : git.getList(kFieldEncounterList)) {
         shared_ptr<Encounter> encounter(_game.objectFactory().newEncounter(_sceneName));
         encounter->loadFromGIT(*gffs);
         add(encounter);
@@ -309,6 +319,15 @@ void Area::loadLYT() {
     if (!layout) {
         throw ValidationException("Area LYT file not found");
     }
+    // Read room models and walkmeshes on worker threads, while rooms are being loaded
+    vector<ResourceId> roomResIds;
+    for (auto &lytRoom : layout->rooms) {
+        roomResIds.push_back(ResourceId(lytRoom.name, ResourceType::Mdl));
+        roomResIds.push_back(ResourceId(lytRoom.name, ResourceType::Mdx));
+        roomResIds.push_back(ResourceId(lytRoom.name, ResourceType::Wok));
+    }
+    _services.resources.prefetch(roomResIds);
+
     auto &sceneGraph = _services.sceneGraphs.get(_sceneName);
     for (auto &lytRoom : layout->rooms) {
         auto model = _services.models.get(lytRoom.name);
@@ -420,6 +439,12 @@ void Area::add(const shared_ptr<Object> &object) {
     _objects.push_back(object);
     _objectsByType[object->type()].push_back(object);
     _objectsByTag[object->tag()].push_back(object);
+    _spatialIndex.add(object);
+
+    _scheduler.add(static_cast<int>(PeriodicJobType::Heartbeat), object->id(), kHeartbeatInterval);
+    if (object->type() == ObjectType::Creature) {
+        _scheduler.add(static_cast<int>(PeriodicJobType::Perception), object->id(), kUpdatePerceptionInterval);
+    }
 
     determineObjectRoom(*object);
 
@@ -481,6 +506,10 @@ void Area::doDestroyObject(uint32_t objectId) {
     if (!object) {
         return;
     }
+    _scheduler.remove(static_cast<int>(PeriodicJobType::Heartbeat), objectId);
+    _scheduler.remove(static_cast<int>(PeriodicJobType::Perception), objectId);
+    _shapeIterations.erase(objectId);
+
     auto room = object->room();
     if (room) {
         room->removeTenant(object.get());
@@ -539,6 +568,7 @@ void Area::doDestroyObject(uint32_t objectId) {
     if (maybeObjectByType != typeObjects.end()) {
         typeObjects.erase(maybeObjectByType);
     }
+    _spatialIndex.remove(*object);
 }
 
 ObjectList &Area::getObjectsByType(ObjectType type) {
@@ -578,6 +608,10 @@ void Area::landObject(Object &object) {
     }
 }
 
+void Area::onObjectMoved(const Object &object) {
+    _spatialIndex.update(object);
+}
+
 void Area::loadParty(const glm::vec3 &position, float facing, bool fromSave) {
     Party &party = _game.party();
 
@@ -628,8 +662,9 @@ void Area::update(float dt) {
             object->update(dt);
         }
 
-        updatePerception(dt);
-        updateHeartbeat(dt);
+        _scheduler.update(dt, bind(&Area::runPeriodicJob, this, _1, _2));
+        runHeartbeats();
+        updatePerception();
     }
 }
 
@@ -699,27 +734,6 @@ bool Area::moveCreatureTowards(const shared_ptr<Creature> &creature, const glm::
     return moveCreature(creature, dir, run, dt);
 }
 
-bool Area::isObjectSeen(const Creature &subject, const Object &object) const {
-    if (!subject.isInLineOfSight(object, kLineOfSightFOV)) {
-        return false;
-    }
-    auto &sceneGraph = _services.sceneGraphs.get(_sceneName);
-
-    glm::vec3 origin(subject.position());
-    origin.z += kLineOfSightHeight;
-
-    glm::vec3 dest(object.position());
-    dest.z += kLineOfSightHeight;
-
-    Collision collision;
-    if (sceneGraph.testLineOfSight(origin, dest, collision)) {
-        return collision.user == &object ||
-               subject.getSquareDistanceTo(object) < glm::distance2(origin, collision.intersection);
-    }
-
-    return true;
-}
-
 void Area::runSpawnScripts() {
     for (auto &creature : _objectsByType[ObjectType::Creature]) {
         static_cast<Creature &>(*creature).runSpawnScript();
@@ -864,19 +878,57 @@ void Area::checkTriggersIntersection(const shared_ptr<Object> &triggerrer) {
     }
 }
 
-void Area::updateHeartbeat(float dt) {
-    if (_heartbeatTimer.advance(dt)) {
-        if (!_onHeartbeat.empty()) {
-            _game.scriptRunner().run(_onHeartbeat, _id);
+void Area::runPeriodicJob(int type, uint32_t objectId) {
+    switch (static_cast<PeriodicJobType>(type)) {
+    case PeriodicJobType::Heartbeat:
+        runHeartbeat(objectId);
+        break;
+    case PeriodicJobType::Perception: {
+        // Perception is updated in a batch, once all due jobs have run
+        auto creature = static_pointer_cast<Creature>(_game.objectFactory().getObjectById(objectId));
+        if (creature) {
+            _perceptionSubjects.push_back(move(creature));
+            _scheduler.charge(_perceptionCost);
         }
-        for (auto &object : _objects) {
-            string heartbeat(object->getOnHeartbeat());
-            if (!heartbeat.empty()) {
-                _game.scriptRunner().run(heartbeat, object->id());
-            }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void Area::runHeartbeat(uint32_t objectId) {
+    // Heartbeats are run in a batch, once all due jobs have run
+    ScriptInvocation invocation;
+    if (objectId == _id) {
+        invocation.resRef = _onHeartbeat;
+    } else {
+        auto object = _game.objectFactory().getObjectById(objectId);
+        if (object) {
+            invocation.resRef = object->getOnHeartbeat();
         }
-        _heartbeatTimer.setTimeout(kHeartbeatInterval);
     }
+    if (invocation.resRef.empty()) {
+        return;
+    }
+    invocation.callerId = objectId;
+    _heartbeatInvocations.push_back(move(invocation));
+    _scheduler.charge(_heartbeatCost);
+}
+
+void Area::runHeartbeats() {
+    if (_heartbeatInvocations.empty()) {
+        return;
+    }
+    // Heartbeat results are not used, so heartbeat scripts may yield
+    auto startTime = chrono::steady_clock::now();
+    _game.scriptRunner().runBatch(_heartbeatInvocations);
+
+    // Charged against the scheduler budget for every heartbeat on following updates
+    chrono::duration<float> elapsed(chrono::steady_clock::now() - startTime);
+    _heartbeatCost = elapsed.count() / _heartbeatInvocations.size();
+
+    _heartbeatInvocations.clear();
 }
 
 Camera &Area::getCamera(CameraType type) {
@@ -1014,41 +1066,19 @@ void Area::selectObject(shared_ptr<Object> object) {
     _selectedObject = move(object);
 }
 
-shared_ptr<Object> Area::getNearestObject(const glm::vec3 &origin, int nth, const std::function<bool(const std::shared_ptr<Object> &)> &predicate) {
-    vector<pair<shared_ptr<Object>, float>> candidates;
-
-    for (auto &object : _objects) {
-        if (predicate(object)) {
-            candidates.push_back(make_pair(object, object->getSquareDistanceTo(origin)));
-        }
-    }
-    sort(candidates.begin(), candidates.end(), [](auto &left, auto &right) { return left.second < right.second; });
-
-    int candidateCount = static_cast<int>(candidates.size());
-    if (nth >= candidateCount) {
-        debug(boost::format("getNearestObject: nth is out of bounds: %d/%d") % nth % candidateCount);
-        return nullptr;
+shared_ptr<Object> Area::getNearestObject(const glm::vec3 &origin, int nth, int typeMask, const std::function<bool(const std::shared_ptr<Object> &)> &predicate) {
+    auto object = _spatialIndex.getNearest(origin, nth, typeMask, predicate);
+    if (!object) {
+        debug(boost::format("getNearestObject: nth is out of bounds: %d") % nth);
     }
-
-    return candidates[nth].first;
+    return object;
 }
 
 shared_ptr<Creature> Area::getNearestCreature(const std::shared_ptr<Object> &target, const SearchCriteriaList &criterias, int nth) {
-    vector<pair<shared_ptr<Creature>, float>> candidates;
-
-    for (auto &object : getObjectsByType(ObjectType::Creature)) {
-        auto creature = static_pointer_cast<Creature>(object);
-        if (matchesCriterias(*creature, criterias, target)) {
-            float distance2 = creature->getSquareDistanceTo(*target);
-            candidates.push_back(make_pair(move(creature), distance2));
-        }
-    }
-
-    sort(candidates.begin(), candidates.end(), [](auto &left, auto &right) {
-        return left.second < right.second;
+    auto object = _spatialIndex.getNearest(target->position(), nth, static_cast<int>(ObjectType::Creature), [&](auto &object) {
+        return matchesCriterias(static_cast<Creature &>(*object), criterias, target);
     });
-
-    return nth < candidates.size() ? candidates[nth].first : nullptr;
+    return static_pointer_cast<Creature>(object);
 }
 
 bool Area::matchesCriterias(const Creature &creature, const SearchCriteriaList &criterias, std::shared_ptr<Object> target) const {
@@ -1124,79 +1154,122 @@ bool Area::matchesCriterias(const Creature &creature, const SearchCriteriaList &
 }
 
 shared_ptr<Creature> Area::getNearestCreatureToLocation(const Location &location, const SearchCriteriaList &criterias, int nth) {
-    vector<pair<shared_ptr<Creature>, float>> candidates;
-
-    for (auto &object : getObjectsByType(ObjectType::Creature)) {
-        auto creature = static_pointer_cast<Creature>(object);
-        if (matchesCriterias(*creature, criterias)) {
-            float distance2 = creature->getSquareDistanceTo(location.position());
-            candidates.push_back(make_pair(move(creature), distance2));
-        }
-    }
-
-    std::sort(candidates.begin(), candidates.end(), [](auto &left, auto &right) {
-        return left.second < right.second;
+    auto object = _spatialIndex.getNearest(location.position(), nth, static_cast<int>(ObjectType::Creature), [&](auto &object) {
+        return matchesCriterias(static_cast<Creature &>(*object), criterias);
     });
-
-    return nth < candidates.size() ? candidates[nth].first : nullptr;
+    return static_pointer_cast<Creature>(object);
 }
 
-void Area::updatePerception(float dt) {
-    if (_perceptionTimer.advance(dt)) {
-        doUpdatePerception();
-        _perceptionTimer.setTimeout(kUpdatePerceptionInterval);
-    }
-}
+shared_ptr<Object> Area::getFirstObjectInShape(
+    uint32_t callerId,
+    Shape shape,
+    float size,
+    const Location &target,
+    bool lineOfSight,
+    int objectTypes,
+    const glm::vec3 &origin) {
 
-void Area::doUpdatePerception() {
-    // For each creature, determine a list of creatures it sees
-    ObjectList &creatures = getObjectsByType(ObjectType::Creature);
-    for (auto &object : creatures) {
-        // Skip dead creatures
-        if (object->isDead())
-            continue;
+    ShapeIteration iteration;
+    glm::vec3 sightOrigin(target.position());
 
-        auto creature = static_pointer_cast<Creature>(object);
-        float hearingRange2 = creature->perception().hearingRange * creature->perception().hearingRange;
-        float sightRange2 = creature->perception().sightRange * creature->perception().sightRange;
+    switch (shape) {
+    case Shape::Sphere:
+        _spatialIndex.getInSphere(target.position(), size, objectTypes, nullptr, iteration.objects);
+        break;
+    case Shape::Cube:
+        _spatialIndex.getInCube(target.position(), size, objectTypes, nullptr, iteration.objects);
+        break;
+    case Shape::Cone:
+    case Shape::SpellCone:
+    case Shape::SpellCylinder: {
+        glm::vec3 apex(origin);
+        if (apex == glm::vec3(0.0f)) {
+            auto caller = _game.objectFactory().getObjectById(callerId);
+            if (caller) {
+                apex = caller->position();
+            }
+        }
+        sightOrigin = apex;
 
-        for (auto &other : creatures) {
-            // Skip self
-            if (other == object)
-                continue;
+        glm::vec3 apexToTarget(target.position() - apex);
+        if (glm::length2(apexToTarget) == 0.0f) {
+            break;
+        }
+        glm::vec3 dir(glm::normalize(apexToTarget));
+        if (shape == Shape::SpellCylinder) {
+            // Size is the length of the cylinder
+            _spatialIndex.getInCylinder(apex, dir, size, kSpellCylinderRadius, objectTypes, nullptr, iteration.objects);
+        } else if (shape == Shape::SpellCone) {
+            // Size is the length of the cone
+            _spatialIndex.getInCone(apex, dir, size, kSpellConeHalfAngle, objectTypes, nullptr, iteration.objects);
+        } else {
+            // Size is the widest radius of the cone, which ends at the target
+            float length = glm::length(apexToTarget);
+            _spatialIndex.getInCone(apex, dir, length, glm::atan(size / length), objectTypes, nullptr, iteration.objects);
+        }
+        break;
+    }
+    default:
+        warn("getFirstObjectInShape: unsupported shape: " + to_string(static_cast<int>(shape)));
+        break;
+    }
 
-            bool heard = false;
-            bool seen = false;
+    if (lineOfSight && !iteration.objects.empty()) {
+        auto &sceneGraph = _services.sceneGraphs.get(_sceneName);
+        vector<LineOfSightQuery> queries;
+        queries.reserve(iteration.objects.size());
+        for (auto &object : iteration.objects) {
+            LineOfSightQuery query;
+            query.origin = sightOrigin + glm::vec3(0.0f, 0.0f, kLineOfSightHeight);
+            query.dest = object->position() + glm::vec3(0.0f, 0.0f, kLineOfSightHeight);
+            queries.push_back(move(query));
+        }
+        sceneGraph.testLineOfSight(queries, &_game.workerPool());
 
-            float distance2 = creature->getSquareDistanceTo(*other);
-            if (distance2 <= hearingRange2) {
-                heard = true;
-            }
-            if (distance2 <= sightRange2) {
-                seen = isObjectSeen(*creature, *other);
+        ObjectList visible;
+        for (size_t i = 0; i < queries.size(); ++i) {
+            if (queries[i].isVisible(iteration.objects[i].get())) {
+                visible.push_back(move(iteration.objects[i]));
             }
+        }
+        iteration.objects = move(visible);
+    }
 
-            // Hearing
-            bool wasHeard = creature->perception().heard.count(other) > 0;
-            if (!wasHeard && heard) {
-                debug(boost::format("%s heard by %s") % other->tag() % creature->tag(), LogChannels::perception);
-                creature->onObjectHeard(other);
-            } else if (wasHeard && !heard) {
-                debug(boost::format("%s inaudible to %s") % other->tag() % creature->tag(), LogChannels::perception);
-                creature->onObjectInaudible(other);
-            }
+    _shapeIterations[callerId] = move(iteration);
 
-            // Sight
-            bool wasSeen = creature->perception().seen.count(other) > 0;
-            if (!wasSeen && seen) {
-                debug(boost::format("%s seen by %s") % other->tag() % creature->tag(), LogChannels::perception);
-                creature->onObjectSeen(other);
-            } else if (wasSeen && !seen) {
-                debug(boost::format("%s vanished from %s") % other->tag() % creature->tag(), LogChannels::perception);
-                creature->onObjectVanished(other);
-            }
+    return getNextObjectInShape(callerId);
+}
+
+shared_ptr<Object> Area::getNextObjectInShape(uint32_t callerId) {
+    auto maybeIteration = _shapeIterations.find(callerId);
+    if (maybeIteration == _shapeIterations.end()) {
+        return nullptr;
+    }
+    ShapeIteration &iteration = maybeIteration->second;
+    while (iteration.index < static_cast<int>(iteration.objects.size())) {
+        shared_ptr<Object> object(iteration.objects[iteration.index++]);
+        // Skip objects destroyed since the iteration started
+        if (_objectsToDestroy.count(object->id()) == 0 && _spatialIndex.contains(*object)) {
+            return object;
         }
     }
+    _shapeIterations.erase(maybeIteration);
+    return nullptr;
+}
+
+void Area::updatePerception() {
+    if (_perceptionSubjects.empty()) {
+        return;
+    }
+    auto &sceneGraph = _services.sceneGraphs.get(_sceneName);
+    auto startTime = chrono::steady_clock::now();
+    _perception.update(_perceptionSubjects, getObjectsByType(ObjectType::Creature), sceneGraph, &_game.workerPool());
+
+    // Charged against the scheduler budget for every subject on following updates
+    chrono::duration<float> elapsed(chrono::steady_clock::now() - startTime);
+    _perceptionCost = elapsed.count() / _perceptionSubjects.size();
+
+    _perceptionSubjects.clear();
 }
 
 Object *Area::getObjectAt(int x, int y) const {
@@ -29,6 +29,10 @@
 #include "../camera/static.h"
 #include "../camera/thirdperson.h"
 #include "../pathfinder.h"
+#include "../perceptionengine.h"
+#include "../periodicscheduler.h"
+#include "../spatialindex.h"
+#include "../script/runner.h"
 #include "../types.h"
 
 #include "../object.h"
@@ -45,6 +49,8 @@ namespace game {
 
 const float kHeartbeatInterval = 6.0f;
 
+constexpr float kLineOfSightHeight = 1.7f; // above object position, at eye level of a humanoid
+
 class Creature;
 class Game;
 class Location;
@@ -89,6 +95,12 @@ public:
     void update3rdPersonCameraTarget();
     void landObject(Object &object);
 
+    /**
+     * Moves the object to its new position in the spatial index. Called
+     * whenever the position of an object is set.
+     */
+    void onObjectMoved(const Object &object);
+
     bool moveCreature(const std::shared_ptr<Creature> &creature, const glm::vec2 &dir, bool run, float dt);
     bool moveCreatureTowards(const std::shared_ptr<Creature> &creature, const glm::vec2 &dest, bool run, float dt);
 
@@ -112,8 +124,6 @@ public:
 
     std::shared_ptr<Object> createObject(ObjectType type, const std::string &blueprintResRef, const std::shared_ptr<Location> &location);
 
-    bool isObjectSeen(const Creature &subject, const Object &object) const;
-
     ObjectList &getObjectsByType(ObjectType type);
     std::shared_ptr<Object> getObjectByTag(const std::string &tag, int nth = 0) const;
 
@@ -122,11 +132,12 @@ public:
     // Object Search
 
     /**
-     * Find the nth nearest object for which the specified predicate returns true.
+     * Find the nth nearest object of the specified types, for which the predicate, if any, returns true.
      *
      * @param nth a 0-based object index
+     * @param typeMask bitwise OR of object types to consider
      */
-    std::shared_ptr<Object> getNearestObject(const glm::vec3 &origin, int nth, const std::function<bool(const std::shared_ptr<Object> &)> &predicate);
+    std::shared_ptr<Object> getNearestObject(const glm::vec3 &origin, int nth, int typeMask, const std::function<bool(const std::shared_ptr<Object> &)> &predicate = nullptr);
 
     /**
      * @param nth 0-based index of the creature
@@ -140,6 +151,29 @@ public:
      */
     std::shared_ptr<Creature> getNearestCreatureToLocation(const Location &location, const SearchCriteriaList &criterias, int nth = 0);
 
+    /**
+     * Starts iterating over objects within the shape on behalf of the caller.
+     *
+     * @param size radius of a sphere, half the side of a cube, or length of a cone or cylinder
+     * @param lineOfSight whether objects must be visible from the apex of a cone or cylinder, or from the target otherwise
+     * @param objectTypes bitwise OR of object types to consider
+     * @param origin apex of a cone or base of a cylinder, caller position if zero
+     * @return first object within the shape, or nullptr
+     */
+    std::shared_ptr<Object> getFirstObjectInShape(
+        uint32_t callerId,
+        Shape shape,
+        float size,
+        const Location &target,
+        bool lineOfSight,
+        int objectTypes,
+        const glm::vec3 &origin);
+
+    /**
+     * @return next object within the shape passed to getFirstObjectInShape by the caller, or nullptr
+     */
+    std::shared_ptr<Object> getNextObjectInShape(uint32_t callerId);
+
     // END Object Search
 
     // Cameras
@@ -164,12 +198,6 @@ public:
 
     // END Party
 
-    // Perception
-
-    void updatePerception(float dt);
-
-    // END Perception
-
     // Object Selection
 
     void hilightObject(std::shared_ptr<Object> object);
@@ -222,13 +250,15 @@ private:
     CameraStyle _camStyleDefault;
     CameraStyle _camStyleCombat;
     std::string _music;
-    Timer _heartbeatTimer;
     bool _unescapable {false};
     Grass _grass;
     glm::vec3 _ambientColor {0.0f};
-    Timer _perceptionTimer;
     std::shared_ptr<Object> _hilightedObject;
     std::shared_ptr<Object> _selectedObject;
+    PeriodicScheduler _scheduler; /**< heartbeats and perception updates */
+    PerceptionEngine _perception;
+    std::vector<std::shared_ptr<Creature>> _perceptionSubjects; /**< creatures due for perception update in the current frame */
+    float _perceptionCost {0.0f};                               /**< measured time of a perception update per subject, in seconds */
 
     // Scripts
 
@@ -236,6 +266,9 @@ private:
     std::string _onExit;
     std::string _onHeartbeat;
 
+    std::vector<ScriptInvocation> _heartbeatInvocations; /**< heartbeats due in the current frame */
+    float _heartbeatCost {0.0f};                          /**< measured time of a heartbeat script per invocation, in seconds */
+
     // END Scripts
 
     // Cameras
@@ -255,9 +288,21 @@ private:
     std::unordered_map<ObjectType, ObjectList> _objectsByType;
     std::unordered_map<std::string, ObjectList> _objectsByTag;
     std::set<uint32_t> _objectsToDestroy;
+    SpatialIndex _spatialIndex;
 
     // END Objects
 
+    // Object Search
+
+    struct ShapeIteration {
+        ObjectList objects;
+        int index {0};
+    };
+
+    std::unordered_map<uint32_t, ShapeIteration> _shapeIterations; /**< by caller id */
+
+    // END Object Search
+
     // Stealth
 
     bool _stealthXPEnabled {false};
@@ -286,11 +331,17 @@ private:
     void doDestroyObject(uint32_t objectId);
     void doDestroyObjects();
     void updateVisibility();
-    void updateHeartbeat(float dt);
-
-    void doUpdatePerception();
     void updateObjectSelection();
 
+    // Periodic jobs
+
+    void runPeriodicJob(int type, uint32_t objectId);
+    void runHeartbeat(uint32_t objectId);
+    void runHeartbeats();
+    void updatePerception();
+
+    // END Periodic jobs
+
     bool matchesCriterias(const Creature &creature, const SearchCriteriaList &criterias, std::shared_ptr<Object> target = nullptr) const;
 
     /**
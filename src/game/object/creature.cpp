@@ -39,6 +39,7 @@
 #include "../d20/classes.h"
 #include "../footstepsounds.h"
 #include "../game.h"
+#include "../gffkeys.h"
 #include "../portraits.h"
 #include "../script/runner.h"
 #include "../services.h"
@@ -77,7 +78,7 @@ void Creature::Path::selectNextPoint() {
 }
 
 void Creature::loadFromGIT(const GffStruct &gffs) {
-    string templateResRef(boost::to_lower_copy(gffs.getString("TemplateResRef")));
+    string templateResRef(boost::to_lower_copy(gffs.getString(kFieldTemplateResRef)));
     loadFromBlueprint(templateResRef);
     loadTransformFromGIT(gffs);
 }
@@ -153,12 +154,12 @@ void Creature::updateModel() {
 }
 
 void Creature::loadTransformFromGIT(const GffStruct &gffs) {
-    _position[0] = gffs.getFloat("XPosition");
-    _position[1] = gffs.getFloat("YPosition");
-    _position[2] = gffs.getFloat("ZPosition");
+    _position[0] = gffs.getFloat(kFieldXPosition);
+    _position[1] = gffs.getFloat(kFieldYPosition);
+    _position[2] = gffs.getFloat(kFieldZPosition);
 
-    float cosine = gffs.getFloat("XOrientation");
-    float sine = gffs.getFloat("YOrientation");
+    float cosine = gffs.getFloat(kFieldXOrientation);
+    float sine = gffs.getFloat(kFieldYOrientation);
     _orientation = glm::quat(glm::vec3(0.0f, 0.0f, -glm::atan(cosine, sine)));
 
     updateTransform();
@@ -1245,51 +1246,51 @@ string Creature::getWeaponModelName(int slot) const {
 }
 
 void Creature::loadUTC(const GffStruct &utc) {
-    _blueprintResRef = boost::to_lower_copy(utc.getString("TemplateResRef"));
-    _race = utc.getEnum("Race", RacialType::Invalid);      // index into racialtypes.2da
-    _subrace = utc.getEnum("SubraceIndex", Subrace::None); // index into subrace.2da
-    _appearance = utc.getInt("Appearance_Type");           // index into appearance.2da
-    _gender = utc.getEnum("Gender", Gender::None);         // index into gender.2da
-    _portraitId = utc.getInt("PortraitId");                // index into portrait.2da
-    _tag = boost::to_lower_copy(utc.getString("Tag"));
-    _conversation = boost::to_lower_copy(utc.getString("Conversation"));
-    _isPC = utc.getBool("IsPC");                           // always 0
-    _faction = utc.getEnum("FactionID", Faction::Invalid); // index into repute.2da
-    _disarmable = utc.getBool("Disarmable");
-    _plot = utc.getBool("Plot");
-    _interruptable = utc.getBool("Interruptable");
-    _noPermDeath = utc.getBool("NoPermDeath");
-    _notReorienting = utc.getBool("NotReorienting");
-    _bodyVariation = utc.getInt("BodyVariation");
-    _textureVar = utc.getInt("TextureVar");
-    _minOneHP = utc.getBool("Min1HP");
-    _partyInteract = utc.getBool("PartyInteract");
-    _walkRate = utc.getInt("WalkRate"); // index into creaturespeed.2da
-    _naturalAC = utc.getInt("NaturalAC");
-    _hitPoints = utc.getInt("HitPoints");
-    _currentHitPoints = utc.getInt("CurrentHitPoints");
-    _maxHitPoints = utc.getInt("MaxHitPoints");
-    _forcePoints = utc.getInt("ForcePoints");
-    _currentForce = utc.getInt("CurrentForce");
-    _refBonus = utc.getInt("refbonus");
-    _willBonus = utc.getInt("willbonus");
-    _fortBonus = utc.getInt("fortbonus");
-    _goodEvil = utc.getInt("GoodEvil");
-    _challengeRating = utc.getInt("ChallengeRating");
-
-    _onHeartbeat = boost::to_lower_copy(utc.getString("ScriptHeartbeat"));
-    _onNotice = boost::to_lower_copy(utc.getString("ScriptOnNotice"));
-    _onSpellAt = boost::to_lower_copy(utc.getString("ScriptSpellAt"));
-    _onAttacked = boost::to_lower_copy(utc.getString("ScriptAttacked"));
-    _onDamaged = boost::to_lower_copy(utc.getString("ScriptDamaged"));
-    _onDisturbed = boost::to_lower_copy(utc.getString("ScriptDisturbed"));
-    _onEndRound = boost::to_lower_copy(utc.getString("ScriptEndRound"));
-    _onEndDialogue = boost::to_lower_copy(utc.getString("ScriptEndDialogu"));
-    _onDialogue = boost::to_lower_copy(utc.getString("ScriptDialogue"));
-    _onSpawn = boost::to_lower_copy(utc.getString("ScriptSpawn"));
-    _onDeath = boost::to_lower_copy(utc.getString("ScriptDeath"));
-    _onUserDefined = boost::to_lower_copy(utc.getString("ScriptUserDefine"));
-    _onBlocked = boost::to_lower_copy(utc.getString("ScriptOnBlocked"));
+    _blueprintResRef = boost::to_lower_copy(utc.getString(kFieldTemplateResRef));
+    _race = utc.getEnum(kFieldRace, RacialType::Invalid);      // index into racialtypes.2da
+    _subrace = utc.getEnum(kFieldSubraceIndex, Subrace::None); // index into subrace.2da
+    _appearance = utc.getInt(kFieldAppearanceType);            // index into appearance.2da
+    _gender = utc.getEnum(kFieldGender, Gender::None);         // index into gender.2da
+    _portraitId = utc.getInt(kFieldPortraitId);                // index into portrait.2da
+    _tag = boost::to_lower_copy(utc.getString(kFieldTag));
+    _conversation = boost::to_lower_copy(utc.getString(kFieldConversation));
+    _isPC = utc.getBool(kFieldIsPC);                           // always 0
+    _faction = utc.getEnum(kFieldFactionID, Faction::Invalid); // index into repute.2da
+    _disarmable = utc.getBool(kFieldDisarmable);
+    _plot = utc.getBool(kFieldPlot);
+    _interruptable = utc.getBool(kFieldInterruptable);
+    _noPermDeath = utc.getBool(kFieldNoPermDeath);
+    _notReorienting = utc.getBool(kFieldNotReorienting);
+    _bodyVariation = utc.getInt(kFieldBodyVariation);
+    _textureVar = utc.getInt(kFieldTextureVar);
+    _minOneHP = utc.getBool(kFieldMin1HP);
+    _partyInteract = utc.getBool(kFieldPartyInteract);
+    _walkRate = utc.getInt(kFieldWalkRate); // index into creaturespeed.2da
+    _naturalAC = utc.getInt(kFieldNaturalAC);
+    _hitPoints = utc.getInt(kFieldHitPoints);
+    _currentHitPoints = utc.getInt(kFieldCurrentHitPoints);
+    _maxHitPoints = utc.getInt(kFieldMaxHitPoints);
+    _forcePoints = utc.getInt(kFieldForcePoints);
+    _currentForce = utc.getInt(kFieldCurrentForce);
+    _refBonus = utc.getInt(kFieldRefbonus);
+    _willBonus = utc.getInt(kFieldWillbonus);
+    _fortBonus = utc.getInt(kFieldFortbonus);
+    _goodEvil = utc.getInt(kFieldGoodEvil);
+    _challengeRating = utc.getInt(kFieldChallengeRating);
+
+    _onHeartbeat = boost::to_lower_copy(utc.getString(kFieldScriptHeartbeat));
+    _onNotice = boost::to_lower_copy(utc.getString(kFieldScriptOnNotice));
+    _onSpellAt = boost::to_lower_copy(utc.getString(kFieldScriptSpellAt));
+    _onAttacked = boost::to_lower_copy(utc.getString(kFieldScriptAttacked));
+    _onDamaged = boost::to_lower_copy(utc.getString(kFieldScriptDamaged));
+    _onDisturbed = boost::to_lower_copy(utc.getString(kFieldScriptDisturbed));
+    _onEndRound = boost::to_lower_copy(utc.getString(kFieldScriptEndRound));
+    _onEndDialogue = boost::to_lower_copy(utc.getString(kFieldScriptEndDialogu));
+    _onDialogue = boost::to_lower_copy(utc.getString(kFieldScriptDialogue));
+    _onSpawn = boost::to_lower_copy(utc.getString(kFieldScriptSpawn));
+    _onDeath = boost::to_lower_copy(utc.getString(kFieldScriptDeath));
+    _onUserDefined = boost::to_lower_copy(utc.getString(kFieldScriptUserDefine));
+    _onBlocked = boost::to_lower_copy(utc.getString(kFieldScriptOnBlocked));
 
     loadNameFromUTC(utc);
     loadSoundSetFromUTC(utc);
@@ -1297,12 +1298,12 @@ void Creature::loadUTC(const GffStruct &utc) {
     loadAttributesFromUTC(utc);
     loadPerceptionRangeFromUTC(utc);
 
-    for (auto &item : utc.getList("Equip_ItemList")) {
-        equip(boost::to_lower_copy(item->getString("EquippedRes")));
+    for (auto &item : utc.getList(kFieldEquipItemList)) {
+        equip(boost::to_lower_copy(item->getString(kFieldEquippedRes)));
     }
-    for (auto &itemGffs : utc.getList("ItemList")) {
-        string resRef(boost::to_lower_copy(itemGffs->getString("InventoryRes")));
-        bool dropable = itemGffs->getBool("Dropable");
+    for (auto &itemGffs : utc.getList(kFieldItemList)) {
+        string resRef(boost::to_lower_copy(itemGffs->getString(kFieldInventoryRes)));
+        bool dropable = itemGffs->getBool(kFieldDropable);
         addItem(resRef, 1, dropable);
     }
 
@@ -1319,8 +1320,8 @@ void Creature::loadUTC(const GffStruct &utc) {
 }
 
 void Creature::loadNameFromUTC(const GffStruct &utc) {
-    string firstName(_services.strings.get(utc.getInt("FirstName")));
-    string lastName(_services.strings.get(utc.getInt("LastName")));
+    string firstName(_services.strings.get(utc.getInt(kFieldFirstName)));
+    string lastName(_services.strings.get(utc.getInt(kFieldLastName)));
     if (!firstName.empty() && !lastName.empty()) {
         _name = firstName + " " + lastName;
     } else if (!firstName.empty()) {
@@ -1329,7 +1330,7 @@ void Creature::loadNameFromUTC(const GffStruct &utc) {
 }
 
 void Creature::loadSoundSetFromUTC(const GffStruct &utc) {
-    uint32_t soundSetIdx = utc.getUint("SoundSetFile", 0xffff);
+    uint32_t soundSetIdx = utc.getUint(kFieldSoundSetFile, 0xffff);
     if (soundSetIdx == 0xffff) {
         return;
     }
@@ -1348,7 +1349,7 @@ void Creature::loadBodyBagFromUTC(const GffStruct &utc) {
     if (!bodyBags) {
         return;
     }
-    int bodyBag = utc.getInt("BodyBag");
+    int bodyBag = utc.getInt(kFieldBodyBag);
     _bodyBag.name = _services.strings.get(bodyBags->getInt(bodyBag, "name"));
     _bodyBag.appearance = bodyBags->getInt(bodyBag, "appearance");
     _bodyBag.corpse = bodyBags->getBool(bodyBag, "corpse");
@@ -1356,31 +1357,31 @@ void Creature::loadBodyBagFromUTC(const GffStruct &utc) {
 
 void Creature::loadAttributesFromUTC(const GffStruct &utc) {
     CreatureAttributes &attributes = _attributes;
-    attributes.setAbilityScore(Ability::Strength, utc.getInt("Str"));
-    attributes.setAbilityScore(Ability::Dexterity, utc.getInt("Dex"));
-    attributes.setAbilityScore(Ability::Constitution, utc.getInt("Con"));
-    attributes.setAbilityScore(Ability::Intelligence, utc.getInt("Int"));
-    attributes.setAbilityScore(Ability::Wisdom, utc.getInt("Wis"));
-    attributes.setAbilityScore(Ability::Charisma, utc.getInt("Cha"));
-
-    for (auto &classGffs : utc.getList("ClassList")) {
-        int clazz = classGffs->getInt("Class");
-        int level = classGffs->getInt("ClassLevel");
+    attributes.setAbilityScore(Ability::Strength, utc.getInt(kFieldStr));
+    attributes.setAbilityScore(Ability::Dexterity, utc.getInt(kFieldDex));
+    attributes.setAbilityScore(Ability::Constitution, utc.getInt(kFieldCon));
+    attributes.setAbilityScore(Ability::Intelligence, utc.getInt(kFieldInt));
+    attributes.setAbilityScore(Ability::Wisdom, utc.getInt(kFieldWis));
+    attributes.setAbilityScore(Ability::Charisma, utc.getInt(kFieldCha));
+
+    for (auto &classGffs : utc.getList(kFieldClassList)) {
+        int clazz = classGffs->getInt(kFieldClass);
+        int level = classGffs->getInt(kFieldClassLevel);
         attributes.addClassLevels(_services.classes.get(static_cast<ClassType>(clazz)).get(), level);
-        for (auto &spellGffs : classGffs->getList("KnownList0")) {
-            auto spell = static_cast<SpellType>(spellGffs->getUint("Spell"));
+        for (auto &spellGffs : classGffs->getList(kFieldKnownList0)) {
+            auto spell = static_cast<SpellType>(spellGffs->getUint(kFieldSpell));
             attributes.addSpell(spell);
         }
     }
 
-    vector<shared_ptr<GffStruct>> skillsUtc(utc.getList("SkillList"));
+    vector<shared_ptr<GffStruct>> skillsUtc(utc.getList(kFieldSkillList));
     for (int i = 0; i < static_cast<int>(skillsUtc.size()); ++i) {
         SkillType skill = static_cast<SkillType>(i);
-        attributes.setSkillRank(skill, skillsUtc[i]->getInt("Rank"));
+        attributes.setSkillRank(skill, skillsUtc[i]->getInt(kFieldRank));
     }
 
-    for (auto &featGffs : utc.getList("FeatList")) {
-        auto feat = static_cast<FeatType>(featGffs->getUint("Feat"));
+    for (auto &featGffs : utc.getList(kFieldFeatList)) {
+        auto feat = static_cast<FeatType>(featGffs->getUint(kFieldFeat));
         _attributes.addFeat(feat);
     }
 }
@@ -1390,7 +1391,7 @@ void Creature::loadPerceptionRangeFromUTC(const GffStruct &utc) {
     if (!ranges) {
         return;
     }
-    int rangeIdx = utc.getInt("PerceptionRange");
+    int rangeIdx = utc.getInt(kFieldPerceptionRange);
     _perception.sightRange = ranges->getFloat(rangeIdx, "primaryrange");
     _perception.hearingRange = ranges->getFloat(rangeIdx, "secondaryrange");
 }
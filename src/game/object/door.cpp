@@ -31,6 +31,7 @@
 #include "../../script/scripts.h"
 
 #include "../game.h"
+#include "../gffkeys.h"
 #include "../services.h"
 
 using namespace std;
@@ -45,13 +46,13 @@ namespace reone {
 namespace game {
 
 void Door::loadFromGIT(const GffStruct &gffs) {
-    string templateResRef(boost::to_lower_copy(gffs.getString("TemplateResRef")));
+    string templateResRef(boost::to_lower_copy(gffs.getString(kFieldTemplateResRef)));
     loadFromBlueprint(templateResRef);
 
-    _linkedToModule = boost::to_lower_copy(gffs.getString("LinkedToModule"));
-    _linkedTo = boost::to_lower_copy(gffs.getString("LinkedTo"));
-    _linkedToFlags = gffs.getInt("LinkedToFlags");
-    _transitionDestin = _services.strings.get(gffs.getInt("TransitionDestin"));
+    _linkedToModule = boost::to_lower_copy(gffs.getString(kFieldLinkedToModule));
+    _linkedTo = boost::to_lower_copy(gffs.getString(kFieldLinkedTo));
+    _linkedToFlags = gffs.getInt(kFieldLinkedToFlags);
+    _transitionDestin = _services.strings.get(gffs.getInt(kFieldTransitionDestin));
 
     loadTransformFromGIT(gffs);
 }
@@ -99,11 +100,11 @@ void Door::loadFromBlueprint(const string &resRef) {
 }
 
 void Door::loadTransformFromGIT(const GffStruct &gffs) {
-    _position[0] = gffs.getFloat("X");
-    _position[1] = gffs.getFloat("Y");
-    _position[2] = gffs.getFloat("Z");
+    _position[0] = gffs.getFloat(kFieldX);
+    _position[1] = gffs.getFloat(kFieldY);
+    _position[2] = gffs.getFloat(kFieldZ);
 
-    _orientation = glm::quat(glm::vec3(0.0f, 0.0f, gffs.getFloat("Bearing")));
+    _orientation = glm::quat(glm::vec3(0.0f, 0.0f, gffs.getFloat(kFieldBearing)));
 
     updateTransform();
 }
@@ -153,39 +154,39 @@ void Door::setLocked(bool locked) {
 }
 
 void Door::loadUTD(const GffStruct &utd) {
-    _tag = boost::to_lower_copy(utd.getString("Tag"));
-    _name = _services.strings.get(utd.getInt("LocName"));
-    _blueprintResRef = boost::to_lower_copy(utd.getString("TemplateResRef"));
-    _autoRemoveKey = utd.getBool("AutoRemoveKey");
-    _conversation = boost::to_lower_copy(utd.getString("Conversation"));
-    _interruptable = utd.getBool("Interruptable");
-    _faction = utd.getEnum("Faction", Faction::Invalid);
-    _plot = utd.getBool("Plot");
-    _minOneHP = utd.getBool("Min1HP");
-    _keyRequired = utd.getBool("KeyRequired");
-    _lockable = utd.getBool("Lockable");
-    _locked = utd.getBool("Locked");
-    _openLockDC = utd.getInt("OpenLockDC");
-    _keyName = utd.getString("KeyName");
-    _hitPoints = utd.getInt("HP");
-    _currentHitPoints = utd.getInt("CurrentHP");
-    _hardness = utd.getInt("Hardness");
-    _fortitude = utd.getInt("Fort");
-    _genericType = utd.getInt("GenericType");
-    _static = utd.getBool("Static");
-
-    _onClosed = utd.getString("OnClosed");   // always empty, but could be useful
-    _onDamaged = utd.getString("OnDamaged"); // always empty, but could be useful
-    _onDeath = utd.getString("OnDeath");
-    _onHeartbeat = utd.getString("OnHeartbeat");
-    _onLock = utd.getString("OnLock");                   // always empty, but could be useful
-    _onMeleeAttacked = utd.getString("OnMeleeAttacked"); // always empty, but could be useful
-    _onOpen = utd.getString("OnOpen");
-    _onSpellCastAt = utd.getString("OnSpellCastAt"); // always empty, but could be useful
-    _onUnlock = utd.getString("OnUnlock");           // always empty, but could be useful
-    _onUserDefined = utd.getString("OnUserDefined");
-    _onClick = utd.getString("OnClick");
-    _onFailToOpen = utd.getString("OnFailToOpen");
+    _tag = boost::to_lower_copy(utd.getString(kFieldTag));
+    _name = _services.strings.get(utd.getInt(kFieldLocName));
+    _blueprintResRef = boost::to_lower_copy(utd.getString(kFieldTemplateResRef));
+    _autoRemoveKey = utd.getBool(kFieldAutoRemoveKey);
+    _conversation = boost::to_lower_copy(utd.getString(kFieldConversation));
+    _interruptable = utd.getBool(kFieldInterruptable);
+    _faction = utd.getEnum(kFieldFaction, Faction::Invalid);
+    _plot = utd.getBool(kFieldPlot);
+    _minOneHP = utd.getBool(kFieldMin1HP);
+    _keyRequired = utd.getBool(kFieldKeyRequired);
+    _lockable = utd.getBool(kFieldLockable);
+    _locked = utd.getBool(kFieldLocked);
+    _openLockDC = utd.getInt(kFieldOpenLockDC);
+    _keyName = utd.getString(kFieldKeyName);
+    _hitPoints = utd.getInt(kFieldHP);
+    _currentHitPoints = utd.getInt(kFieldCurrentHP);
+    _hardness = utd.getInt(kFieldHardness);
+    _fortitude = utd.getInt(kFieldFort);
+    _genericType = utd.getInt(kFieldGenericType);
+    _static = utd.getBool(kFieldStatic);
+
+    _onClosed = utd.getString(kFieldOnClosed);   // always empty, but could be useful
+    _onDamaged = utd.getString(kFieldOnDamaged); // always empty, but could be useful
+    _onDeath = utd.getString(kFieldOnDeath);
+    _onHeartbeat = utd.getString(kFieldOnHeartbeat);
+    _onLock = utd.getString(kFieldOnLock);                   // always empty, but could be useful
+    _onMeleeAttacked = utd.getString(kFieldOnMeleeAttacked); // always empty, but could be useful
+    _onOpen = utd.getString(kFieldOnOpen);
+    _onSpellCastAt = utd.getString(kFieldOnSpellCastAt); // always empty, but could be useful
+    _onUnlock = utd.getString(kFieldOnUnlock);           // always empty, but could be useful
+    _onUserDefined = utd.getString(kFieldOnUserDefined);
+    _onClick = utd.getString(kFieldOnClick);
+    _onFailToOpen = utd.getString(kFieldOnFailToOpen);
 
     // Unused fields:
     //
@@ -29,6 +29,7 @@
 #include "../../script/types.h"
 
 #include "../game.h"
+#include "../gffkeys.h"
 #include "../script/runner.h"
 #include "../services.h"
 
@@ -44,7 +45,7 @@ namespace reone {
 namespace game {
 
 void Placeable::loadFromGIT(const GffStruct &gffs) {
-    string templateResRef(boost::to_lower_copy(gffs.getString("TemplateResRef")));
+    string templateResRef(boost::to_lower_copy(gffs.getString(kFieldTemplateResRef)));
     loadFromBlueprint(templateResRef);
     loadTransformFromGIT(gffs);
 }
@@ -77,11 +78,11 @@ void Placeable::loadFromBlueprint(const string &resRef) {
 }
 
 void Placeable::loadTransformFromGIT(const GffStruct &gffs) {
-    _position[0] = gffs.getFloat("X");
-    _position[1] = gffs.getFloat("Y");
-    _position[2] = gffs.getFloat("Z");
+    _position[0] = gffs.getFloat(kFieldX);
+    _position[1] = gffs.getFloat(kFieldY);
+    _position[2] = gffs.getFloat(kFieldZ);
 
-    _orientation = glm::quat(glm::vec3(0.0f, 0.0f, gffs.getFloat("Bearing")));
+    _orientation = glm::quat(glm::vec3(0.0f, 0.0f, gffs.getFloat(kFieldBearing)));
 
     updateTransform();
 }
@@ -99,45 +100,45 @@ void Placeable::runOnInvDisturbed(shared_ptr<Object> triggerrer) {
 }
 
 void Placeable::loadUTP(const GffStruct &utp) {
-    _tag = boost::to_lower_copy(utp.getString("Tag"));
-    _name = _services.strings.get(utp.getInt("LocName"));
-    _blueprintResRef = boost::to_lower_copy(utp.getString("TemplateResRef"));
-    _conversation = boost::to_lower_copy(utp.getString("Conversation"));
-    _interruptable = utp.getBool("Interruptable");
-    _faction = utp.getEnum("Faction", Faction::Invalid);
-    _plot = utp.getBool("Plot");
-    _minOneHP = utp.getBool("Min1HP");
-    _keyRequired = utp.getBool("KeyRequired");
-    _lockable = utp.getBool("Lockable");
-    _locked = utp.getBool("Locked");
-    _openLockDC = utp.getInt("OpenLockDC");
-    _animationState = utp.getInt("AnimationState");
-    _appearance = utp.getInt("Appearance");
-    _hitPoints = utp.getInt("HP");
-    _currentHitPoints = utp.getInt("CurrentHP");
-    _hardness = utp.getInt("Hardness");
-    _fortitude = utp.getInt("Fort");
-    _hasInventory = utp.getBool("HasInventory");
-    _partyInteract = utp.getBool("PartyInteract");
-    _static = utp.getBool("Static");
-    _usable = utp.getBool("Useable");
-
-    _onClosed = boost::to_lower_copy(utp.getString("OnClosed"));
-    _onDamaged = boost::to_lower_copy(utp.getString("OnDamaged")); // always empty, but could be useful
-    _onDeath = boost::to_lower_copy(utp.getString("OnDeath"));
-    _onHeartbeat = boost::to_lower_copy(utp.getString("OnHeartbeat"));
-    _onLock = boost::to_lower_copy(utp.getString("OnLock"));                   // always empty, but could be useful
-    _onMeleeAttacked = boost::to_lower_copy(utp.getString("OnMeleeAttacked")); // always empty, but could be useful
-    _onOpen = boost::to_lower_copy(utp.getString("OnOpen"));
-    _onSpellCastAt = boost::to_lower_copy(utp.getString("OnSpellCastAt"));
-    _onUnlock = boost::to_lower_copy(utp.getString("OnUnlock")); // always empty, but could be useful
-    _onUserDefined = boost::to_lower_copy(utp.getString("OnUserDefined"));
-    _onEndDialogue = boost::to_lower_copy(utp.getString("OnEndDialogue"));
-    _onInvDisturbed = boost::to_lower_copy(utp.getString("OnInvDisturbed"));
-    _onUsed = boost::to_lower_copy(utp.getString("OnUsed"));
-
-    for (auto &itemGffs : utp.getList("ItemList")) {
-        string resRef(boost::to_lower_copy(itemGffs->getString("InventoryRes")));
+    _tag = boost::to_lower_copy(utp.getString(kFieldTag));
+    _name = _services.strings.get(utp.getInt(kFieldLocName));
+    _blueprintResRef = boost::to_lower_copy(utp.getString(kFieldTemplateResRef));
+    _conversation = boost::to_lower_copy(utp.getString(kFieldConversation));
+    _interruptable = utp.getBool(kFieldInterruptable);
+    _faction = utp.getEnum(kFieldFaction, Faction::Invalid);
+    _plot = utp.getBool(kFieldPlot);
+    _minOneHP = utp.getBool(kFieldMin1HP);
+    _keyRequired = utp.getBool(kFieldKeyRequired);
+    _lockable = utp.getBool(kFieldLockable);
+    _locked = utp.getBool(kFieldLocked);
+    _openLockDC = utp.getInt(kFieldOpenLockDC);
+    _animationState = utp.getInt(kFieldAnimationState);
+    _appearance = utp.getInt(kFieldAppearance);
+    _hitPoints = utp.getInt(kFieldHP);
+    _currentHitPoints = utp.getInt(kFieldCurrentHP);
+    _hardness = utp.getInt(kFieldHardness);
+    _fortitude = utp.getInt(kFieldFort);
+    _hasInventory = utp.getBool(kFieldHasInventory);
+    _partyInteract = utp.getBool(kFieldPartyInteract);
+    _static = utp.getBool(kFieldStatic);
+    _usable = utp.getBool(kFieldUseable);
+
+    _onClosed = boost::to_lower_copy(utp.getString(kFieldOnClosed));
+    _onDamaged = boost::to_lower_copy(utp.getString(kFieldOnDamaged)); // always empty, but could be useful
+    _onDeath = boost::to_lower_copy(utp.getString(kFieldOnDeath));
+    _onHeartbeat = boost::to_lower_copy(utp.getString(kFieldOnHeartbeat));
+    _onLock = boost::to_lower_copy(utp.getString(kFieldOnLock));                   // always empty, but could be useful
+    _onMeleeAttacked = boost::to_lower_copy(utp.getString(kFieldOnMeleeAttacked)); // always empty, but could be useful
+    _onOpen = boost::to_lower_copy(utp.getString(kFieldOnOpen));
+    _onSpellCastAt = boost::to_lower_copy(utp.getString(kFieldOnSpellCastAt));
+    _onUnlock = boost::to_lower_copy(utp.getString(kFieldOnUnlock)); // always empty, but could be useful
+    _onUserDefined = boost::to_lower_copy(utp.getString(kFieldOnUserDefined));
+    _onEndDialogue = boost::to_lower_copy(utp.getString(kFieldOnEndDialogue));
+    _onInvDisturbed = boost::to_lower_copy(utp.getString(kFieldOnInvDisturbed));
+    _onUsed = boost::to_lower_copy(utp.getString(kFieldOnUsed));
+
+    for (auto &itemGffs : utp.getList(kFieldItemList)) {
+        string resRef(boost::to_lower_copy(itemGffs->getString(kFieldInventoryRes)));
         addItem(resRef, 1, true);
     }
 
@@ -32,6 +32,13 @@ struct Options {
     graphics::GraphicsOptions graphics;
     audio::AudioOptions audio;
 
+    float jobBudget {2.0f}; /**< per-frame budget of periodic jobs, such as heartbeats, in ms, or zero for unlimited */
+
+    // Scripting
+    bool optimizeScripts {true};
+    bool verifyScripts {false};
+    float scriptBudget {1.0f}; /**< per-frame budget of resuming yielded scripts, in ms */
+
     // Logging
     LogLevel logLevel {LogLevel::Info};
     int logChannels {LogChannels::general};
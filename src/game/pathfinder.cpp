@@ -17,43 +17,81 @@
 
 #include "pathfinder.h"
 
+#include "../common/logutil.h"
+
 using namespace std;
 
 namespace reone {
 
 namespace game {
 
-const Pathfinder::ContextVertex &Pathfinder::Context::getVertexWithLeastTotalCostFromOpen() const {
-    uint16_t bestIdx = 0xffff;
-    float bestTotalCost = numeric_limits<float>().max();
-
-    for (uint16_t idx : open) {
-        const ContextVertex &vert = vertices.find(idx)->second;
-        if (bestIdx == 0xffff || vert.totalCost < bestTotalCost) {
-            bestIdx = idx;
-            bestTotalCost = vert.totalCost;
-        }
-    }
+static constexpr size_t kPathCacheBudget = 16 * 1024; // bytes
 
-    return vertices.find(bestIdx)->second;
+Pathfinder::Pathfinder() {
+    CachePolicy<uint32_t, VertexPath> pathCachePolicy;
+    pathCachePolicy.byteBudget = kPathCacheBudget;
+    pathCachePolicy.sizeOf = [](auto &path) { return sizeof(VertexPath) + path.size() * sizeof(uint16_t); };
+    _pathCache.setPolicy(move(pathCachePolicy));
 }
 
 void Pathfinder::load(const vector<Path::Point> &points, const unordered_map<int, float> &pointZ) {
-    for (uint16_t i = 0; i < points.size(); ++i) {
-        if (pointZ.count(i) == 0) {
+    _vertices.clear();
+    _adjacencyOffsets.clear();
+    _adjacentVertices.clear();
+    _kdTree.clear();
+    _searchVertices.clear();
+    _openHeap.clear();
+    _pathCache.clear();
+
+    // Points without elevation are skipped, so vertex indices may differ from point indices
+    vector<int> vertexByPoint(points.size(), -1);
+    for (int i = 0; i < static_cast<int>(points.size()); ++i) {
+        auto maybeZ = pointZ.find(i);
+        if (maybeZ == pointZ.end()) {
             continue;
         }
+        if (_vertices.size() == 0xffff) {
+            warn("Pathfinder: too many path points");
+            break;
+        }
+        vertexByPoint[i] = static_cast<int>(_vertices.size());
+        _vertices.push_back(glm::vec3(points[i].x, points[i].y, maybeZ->second));
+    }
 
-        const Path::Point &point = points[i];
-        glm::vec3 pointVec(point.x, point.y, pointZ.find(i)->second);
-        _vertices.push_back(pointVec);
-
-        glm::vec3 adjPointVec;
-        for (auto &adjPointIdx : point.adjPoints) {
-            const Path::Point &adjPoint = points[adjPointIdx];
-            _adjacentVertices[i].push_back(static_cast<uint16_t>(adjPointIdx));
+    for (int i = 0; i < static_cast<int>(points.size()); ++i) {
+        if (vertexByPoint[i] == -1) {
+            continue;
+        }
+        _adjacencyOffsets.push_back(static_cast<uint32_t>(_adjacentVertices.size()));
+        for (auto &adjPointIdx : points[i].adjPoints) {
+            if (adjPointIdx >= 0 && adjPointIdx < static_cast<int>(points.size()) && vertexByPoint[adjPointIdx] != -1) {
+                _adjacentVertices.push_back(static_cast<uint16_t>(vertexByPoint[adjPointIdx]));
+            }
         }
     }
+    _adjacencyOffsets.push_back(static_cast<uint32_t>(_adjacentVertices.size()));
+
+    _kdTree.resize(_vertices.size());
+    for (size_t i = 0; i < _vertices.size(); ++i) {
+        _kdTree[i] = static_cast<uint16_t>(i);
+    }
+    computeKdTree(0, static_cast<int>(_kdTree.size()), 0);
+
+    _searchVertices.resize(_vertices.size());
+    _openHeap.reserve(_vertices.size());
+}
+
+void Pathfinder::computeKdTree(int begin, int end, int depth) {
+    if (end - begin < 2) {
+        return;
+    }
+    int axis = depth % 3;
+    int mid = (begin + end) / 2;
+    nth_element(_kdTree.begin() + begin, _kdTree.begin() + mid, _kdTree.begin() + end, [this, &axis](uint16_t left, uint16_t right) {
+        return _vertices[left][axis] < _vertices[right][axis];
+    });
+    computeKdTree(begin, mid, depth + 1);
+    computeKdTree(mid + 1, end, depth + 1);
 }
 
 const vector<glm::vec3> Pathfinder::findPath(const glm::vec3 &from, const glm::vec3 &to) const {
@@ -71,86 +109,194 @@ const vector<glm::vec3> Pathfinder::findPath(const glm::vec3 &from, const glm::v
         return vector<glm::vec3> {from, to};
     }
 
-    Context ctx;
+    uint32_t key = (static_cast<uint32_t>(fromIdx) << 16) | toIdx;
+    auto vertexPath = _pathCache.get(key, [this, &fromIdx, &toIdx]() {
+        return make_shared<VertexPath>(searchPath(fromIdx, toIdx));
+    });
+
+    // Return a path of start and end points when end is not reachable
+    if (vertexPath->empty()) {
+        return vector<glm::vec3> {from, to};
+    }
 
-    // Add vertex, nearest to start point, to open list
-    ContextVertex fromVert;
-    fromVert.index = fromIdx;
-    ctx.vertices.insert(make_pair(fromIdx, fromVert));
-    ctx.open.insert(fromIdx);
+    vector<glm::vec3> path;
+    path.reserve(vertexPath->size());
+    for (auto &idx : *vertexPath) {
+        path.push_back(_vertices[idx]);
+    }
 
-    while (!ctx.open.empty()) {
-        // Extract vertex with least total cost from open list
-        const ContextVertex &current = ctx.getVertexWithLeastTotalCostFromOpen();
-        ctx.open.erase(current.index);
+    return path;
+}
 
-        // Add current vertex to closed list
-        ctx.closed.insert(current.index);
+Pathfinder::VertexPath Pathfinder::searchPath(uint16_t fromIdx, uint16_t toIdx) const {
+    // Starting a new generation invalidates search state of all vertices
+    if (++_generation == 0) {
+        for (auto &vert : _searchVertices) {
+            vert.generation = 0;
+        }
+        _generation = 1;
+    }
+    _openHeap.clear();
+
+    const glm::vec3 &toVertex = _vertices[toIdx];
+
+    SearchVertex &fromVert = getSearchVertex(fromIdx);
+    fromVert.totalCost = glm::distance(_vertices[fromIdx], toVertex);
+    pushOpen(fromIdx);
+
+    while (!_openHeap.empty()) {
+        // Extract vertex with least total cost from open heap, and close it
+        uint16_t currentIdx = popOpen();
+        SearchVertex &current = _searchVertices[currentIdx];
+        current.closed = true;
 
         // Reconstruct path if current vertex is nearest to end point
-        if (current.index == toIdx) {
-            vector<glm::vec3> path;
-            uint16_t idx = current.index;
-            do {
-                const ContextVertex &vert = ctx.vertices.find(idx)->second;
-                path.push_back(_vertices[vert.index]);
-                idx = vert.parentIndex;
-            } while (idx != 0xffff);
+        if (currentIdx == toIdx) {
+            VertexPath path;
+            for (uint16_t idx = currentIdx; idx != 0xffff; idx = _searchVertices[idx].parentIndex) {
+                path.push_back(idx);
+            }
             reverse(path.begin(), path.end());
-            return move(path);
+            return path;
         }
 
-        // Skip current vertex if it has no adjacent vertices
-        auto maybeAdjVerts = _adjacentVertices.find(current.index);
-        if (maybeAdjVerts == _adjacentVertices.end())
-            continue;
+        for (uint32_t i = _adjacencyOffsets[currentIdx]; i < _adjacencyOffsets[currentIdx + 1]; ++i) {
+            uint16_t adjVertIdx = _adjacentVertices[i];
+            SearchVertex &adjVert = getSearchVertex(adjVertIdx);
 
-        for (auto &adjVertIdx : maybeAdjVerts->second) {
-            // Skip adjacent vertex if it is present in closed list
-            if (ctx.closed.count(adjVertIdx) > 0)
+            // Skip adjacent vertex if it is closed
+            if (adjVert.closed) {
                 continue;
+            }
 
-            ContextVertex child;
-            child.index = adjVertIdx;
-            child.parentIndex = current.index;
-            child.distance = current.distance + glm::distance2(_vertices[current.index], _vertices[adjVertIdx]);
-            child.heuristic = glm::distance2(_vertices[child.index], _vertices[toIdx]);
-            child.totalCost = child.distance + child.heuristic;
-
-            // Do nothing if adjacent vertex is present in open list and computed distance is greater
-            auto maybeOpenAdjVert = ctx.open.find(adjVertIdx);
-            if (maybeOpenAdjVert != ctx.open.end()) {
-                const ContextVertex &openAdjVert = ctx.vertices.find(*maybeOpenAdjVert)->second;
-                if (child.distance > openAdjVert.distance)
-                    continue;
+            // Skip adjacent vertex if it is open and computed distance is not less
+            float distance = current.distance + glm::distance(_vertices[currentIdx], _vertices[adjVertIdx]);
+            bool open = adjVert.heapIndex != -1;
+            if (open && distance >= adjVert.distance) {
+                continue;
             }
 
-            // Insert or update adjacent vertex in open list
-            ctx.vertices.insert(make_pair(adjVertIdx, child));
-            ctx.open.insert(adjVertIdx);
+            // Insert or update adjacent vertex in open heap
+            adjVert.parentIndex = currentIdx;
+            adjVert.distance = distance;
+            adjVert.totalCost = distance + glm::distance(_vertices[adjVertIdx], toVertex);
+            if (open) {
+                siftUpOpen(adjVert.heapIndex);
+            } else {
+                pushOpen(adjVertIdx);
+            }
         }
     }
 
-    // Return a path of start and end points by default
-    return vector<glm::vec3> {from, to};
+    return VertexPath();
 }
 
-uint16_t Pathfinder::getNearestVertex(const glm::vec3 &point) const {
-    uint16_t index = 0xffff;
-    float minDist = 0.0f;
+Pathfinder::SearchVertex &Pathfinder::getSearchVertex(uint16_t index) const {
+    SearchVertex &vert = _searchVertices[index];
+    if (vert.generation != _generation) {
+        vert.generation = _generation;
+        vert.parentIndex = 0xffff;
+        vert.closed = false;
+        vert.distance = 0.0f;
+        vert.totalCost = 0.0f;
+        vert.heapIndex = -1;
+    }
+    return vert;
+}
 
-    for (int i = 0; i < _vertices.size(); ++i) {
-        float dist = glm::distance2(point, _vertices[i]);
+void Pathfinder::pushOpen(uint16_t index) const {
+    int heapIndex = static_cast<int>(_openHeap.size());
+    _openHeap.push_back(index);
+    _searchVertices[index].heapIndex = heapIndex;
+    siftUpOpen(heapIndex);
+}
 
-        if (index == 0xffff || dist < minDist) {
-            index = i;
-            minDist = dist;
+uint16_t Pathfinder::popOpen() const {
+    uint16_t index = _openHeap.front();
+    swapOpen(0, static_cast<int>(_openHeap.size()) - 1);
+    _openHeap.pop_back();
+    _searchVertices[index].heapIndex = -1;
+    if (!_openHeap.empty()) {
+        siftDownOpen(0);
+    }
+    return index;
+}
+
+void Pathfinder::siftUpOpen(int heapIndex) const {
+    while (heapIndex > 0) {
+        int parent = (heapIndex - 1) / 2;
+        if (_searchVertices[_openHeap[parent]].totalCost <= _searchVertices[_openHeap[heapIndex]].totalCost) {
+            break;
+        }
+        swapOpen(parent, heapIndex);
+        heapIndex = parent;
+    }
+}
+
+void Pathfinder::siftDownOpen(int heapIndex) const {
+    int size = static_cast<int>(_openHeap.size());
+    while (true) {
+        int least = heapIndex;
+        int left = 2 * heapIndex + 1;
+        int right = left + 1;
+        if (left < size && _searchVertices[_openHeap[left]].totalCost < _searchVertices[_openHeap[least]].totalCost) {
+            least = left;
+        }
+        if (right < size && _searchVertices[_openHeap[right]].totalCost < _searchVertices[_openHeap[least]].totalCost) {
+            least = right;
         }
+        if (least == heapIndex) {
+            break;
+        }
+        swapOpen(heapIndex, least);
+        heapIndex = least;
     }
+}
+
+void Pathfinder::swapOpen(int left, int right) const {
+    swap(_openHeap[left], _openHeap[right]);
+    _searchVertices[_openHeap[left]].heapIndex = left;
+    _searchVertices[_openHeap[right]].heapIndex = right;
+}
 
+uint16_t Pathfinder::getNearestVertex(const glm::vec3 &point) const {
+    uint16_t index = 0xffff;
+    float minDist2 = numeric_limits<float>::max();
+    getNearestVertex(point, 0, static_cast<int>(_kdTree.size()), 0, index, minDist2);
     return index;
 }
 
+void Pathfinder::getNearestVertex(const glm::vec3 &point, int begin, int end, int depth, uint16_t &outIndex, float &outDistance2) const {
+    if (begin >= end) {
+        return;
+    }
+    int mid = (begin + end) / 2;
+    uint16_t index = _kdTree[mid];
+    const glm::vec3 &vertex = _vertices[index];
+
+    float dist2 = glm::distance2(point, vertex);
+    if (dist2 < outDistance2 || (dist2 == outDistance2 && index < outIndex)) {
+        outIndex = index;
+        outDistance2 = dist2;
+    }
+
+    // Search the half containing the point first, and the other half only if
+    // it may contain a nearer vertex
+    int axis = depth % 3;
+    float delta = point[axis] - vertex[axis];
+    if (delta < 0.0f) {
+        getNearestVertex(point, begin, mid, depth + 1, outIndex, outDistance2);
+        if (delta * delta <= outDistance2) {
+            getNearestVertex(point, mid + 1, end, depth + 1, outIndex, outDistance2);
+        }
+    } else {
+        getNearestVertex(point, mid + 1, end, depth + 1, outIndex, outDistance2);
+        if (delta * delta <= outDistance2) {
+            getNearestVertex(point, begin, mid, depth + 1, outIndex, outDistance2);
+        }
+    }
+}
+
 } // namespace game
 
 } // namespace reone
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include "../common/memorycache.h"
+
 #include "path.h"
 
 namespace reone {
@@ -24,35 +26,67 @@ namespace reone {
 namespace game {
 
 /**
- * A* pathfinding.
+ * A* pathfinding over points of the area path.
+ *
+ * Search state is kept between queries in flat arrays, stamped with a search
+ * generation, so that it never needs to be cleared. Recent results are cached
+ * by start and end vertex. Not thread-safe.
  */
 class Pathfinder : boost::noncopyable {
 public:
+    Pathfinder();
+
     void load(const std::vector<Path::Point> &points, const std::unordered_map<int, float> &pointZ);
 
     const std::vector<glm::vec3> findPath(const glm::vec3 &from, const glm::vec3 &to) const;
 
 private:
-    struct ContextVertex {
-        uint16_t index {0};
+    typedef std::vector<uint16_t> VertexPath;
+
+    struct SearchVertex {
+        uint32_t generation {0}; /**< search in which this vertex was last reached */
         uint16_t parentIndex {0xffff};
+        bool closed {false};
         float distance {0.0f};
-        float heuristic {0.0f};
         float totalCost {0.0f};
+        int heapIndex {-1}; /**< position in the open heap, or -1 */
     };
 
-    struct Context {
-        std::unordered_map<uint16_t, ContextVertex> vertices;
-        std::set<uint16_t> open;
-        std::set<uint16_t> closed;
+    std::vector<glm::vec3> _vertices;
+    std::vector<uint32_t> _adjacencyOffsets; /**< offsets into _adjacentVertices, one per vertex plus one */
+    std::vector<uint16_t> _adjacentVertices;
+    std::vector<uint16_t> _kdTree; /**< vertex indices, in order of an implicit balanced k-d tree */
 
-        const ContextVertex &getVertexWithLeastTotalCostFromOpen() const;
-    };
+    // Search state
 
-    std::vector<glm::vec3> _vertices;
-    std::unordered_map<uint16_t, std::vector<uint16_t>> _adjacentVertices;
+    mutable std::vector<SearchVertex> _searchVertices;
+    mutable std::vector<uint16_t> _openHeap; /**< binary min-heap of vertex indices, by total cost */
+    mutable uint32_t _generation {0};
+    mutable MemoryCache<uint32_t, VertexPath> _pathCache; /**< by start and end vertex */
+
+    // END Search state
+
+    void computeKdTree(int begin, int end, int depth);
 
     uint16_t getNearestVertex(const glm::vec3 &point) const;
+    void getNearestVertex(const glm::vec3 &point, int begin, int end, int depth, uint16_t &outIndex, float &outDistance2) const;
+
+    /**
+     * @return vertices from start to end inclusive, or empty path if end is not reachable
+     */
+    VertexPath searchPath(uint16_t fromIdx, uint16_t toIdx) const;
+
+    SearchVertex &getSearchVertex(uint16_t index) const;
+
+    // Open heap
+
+    void pushOpen(uint16_t index) const;
+    uint16_t popOpen() const;
+    void siftUpOpen(int heapIndex) const;
+    void siftDownOpen(int heapIndex) const;
+    void swapOpen(int left, int right) const;
+
+    // END Open heap
 };
 
 } // namespace game
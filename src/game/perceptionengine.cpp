@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "perceptionengine.h"
+
+#include "../common/logutil.h"
+#include "../scene/graph.h"
+
+#include "object/area.h"
+#include "object/creature.h"
+
+using namespace std;
+
+using namespace reone::scene;
+
+namespace reone {
+
+namespace game {
+
+static constexpr float kCellSize = 10.0f;
+
+static constexpr float kLineOfSightFOV = glm::radians(60.0f);
+
+static uint64_t getCellKey(int x, int y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+static int getCellCoord(float value) {
+    return static_cast<int>(glm::floor(value / kCellSize));
+}
+
+void PerceptionEngine::update(
+    const vector<shared_ptr<Creature>> &subjects,
+    const vector<shared_ptr<Object>> &creatures,
+    const SceneGraph &sceneGraph,
+    ThreadPool *pool) {
+
+    indexCreatures(creatures);
+
+    _queries.clear();
+    _candidates.resize(subjects.size());
+    for (size_t i = 0; i < subjects.size(); ++i) {
+        _candidates[i].clear();
+        if (!subjects[i]->isDead()) {
+            findCandidates(*subjects[i], _candidates[i]);
+        }
+    }
+
+    sceneGraph.testLineOfSight(_queries, pool);
+
+    for (size_t i = 0; i < subjects.size(); ++i) {
+        if (!subjects[i]->isDead()) {
+            fireEvents(*subjects[i], _candidates[i]);
+        }
+    }
+}
+
+void PerceptionEngine::indexCreatures(const vector<shared_ptr<Object>> &creatures) {
+    // Creatures are copied, so that perception scripts may safely modify the original list
+    _creatures = creatures;
+    _indices.clear();
+    for (auto &cell : _cells) {
+        cell.second.clear();
+    }
+    for (size_t i = 0; i < _creatures.size(); ++i) {
+        const glm::vec3 &position = _creatures[i]->position();
+        int idx = static_cast<int>(i);
+        _indices.insert(make_pair(_creatures[i].get(), idx));
+        _cells[getCellKey(getCellCoord(position.x), getCellCoord(position.y))].push_back(idx);
+    }
+}
+
+void PerceptionEngine::findCandidates(const Creature &subject, vector<Candidate> &outCandidates) {
+    float hearingRange2 = subject.perception().hearingRange * subject.perception().hearingRange;
+    float sightRange2 = subject.perception().sightRange * subject.perception().sightRange;
+    float range = glm::max(subject.perception().hearingRange, subject.perception().sightRange);
+
+    const glm::vec3 &position = subject.position();
+    int minX = getCellCoord(position.x - range);
+    int minY = getCellCoord(position.y - range);
+    int maxX = getCellCoord(position.x + range);
+    int maxY = getCellCoord(position.y + range);
+
+    for (int y = minY; y <= maxY; ++y) {
+        for (int x = minX; x <= maxX; ++x) {
+            auto maybeCell = _cells.find(getCellKey(x, y));
+            if (maybeCell == _cells.end()) {
+                continue;
+            }
+            for (int objectIdx : maybeCell->second) {
+                const Object &other = *_creatures[objectIdx];
+                if (&other == &subject) {
+                    continue;
+                }
+                float distance2 = subject.getSquareDistanceTo(other);
+                bool inSightRange = distance2 <= sightRange2;
+                if (distance2 > hearingRange2 && !inSightRange) {
+                    continue;
+                }
+                Candidate candidate;
+                candidate.objectIdx = objectIdx;
+                candidate.heard = distance2 <= hearingRange2;
+                if (inSightRange && subject.isInLineOfSight(other, kLineOfSightFOV)) {
+                    LineOfSightQuery query;
+                    query.origin = subject.position() + glm::vec3(0.0f, 0.0f, kLineOfSightHeight);
+                    query.dest = other.position() + glm::vec3(0.0f, 0.0f, kLineOfSightHeight);
+                    candidate.queryIdx = static_cast<int>(_queries.size());
+                    _queries.push_back(move(query));
+                }
+                outCandidates.push_back(move(candidate));
+            }
+        }
+    }
+
+    // Objects perceived before, but now out of range, must also be visited
+    // to fire inaudible and vanished events
+    sort(outCandidates.begin(), outCandidates.end(), [](auto &left, auto &right) { return left.objectIdx < right.objectIdx; });
+    size_t numInRange = outCandidates.size();
+    auto addPerceived = [this, &outCandidates, &numInRange](const set<shared_ptr<Object>> &perceived) {
+        for (auto &object : perceived) {
+            auto maybeIdx = _indices.find(object.get());
+            if (maybeIdx == _indices.end()) {
+                continue;
+            }
+            int objectIdx = maybeIdx->second;
+            auto inRangeEnd = outCandidates.begin() + numInRange;
+            auto maybeCandidate = lower_bound(outCandidates.begin(), inRangeEnd, objectIdx, [](auto &candidate, int idx) { return candidate.objectIdx < idx; });
+            if (maybeCandidate != inRangeEnd && maybeCandidate->objectIdx == objectIdx) {
+                continue;
+            }
+            Candidate candidate;
+            candidate.objectIdx = objectIdx;
+            outCandidates.push_back(move(candidate));
+        }
+    };
+    addPerceived(subject.perception().heard);
+    addPerceived(subject.perception().seen);
+    if (outCandidates.size() > numInRange) {
+        sort(outCandidates.begin(), outCandidates.end(), [](auto &left, auto &right) { return left.objectIdx < right.objectIdx; });
+        outCandidates.erase(
+            unique(outCandidates.begin(), outCandidates.end(), [](auto &left, auto &right) { return left.objectIdx == right.objectIdx; }),
+            outCandidates.end());
+    }
+}
+
+void PerceptionEngine::fireEvents(Creature &subject, const vector<Candidate> &candidates) {
+    for (auto &candidate : candidates) {
+        const shared_ptr<Object> &other = _creatures[candidate.objectIdx];
+        bool heard = candidate.heard;
+        bool seen = candidate.queryIdx != -1 && _queries[candidate.queryIdx].isVisible(other.get());
+
+        // Hearing
+        bool wasHeard = subject.perception().heard.count(other) > 0;
+        if (!wasHeard && heard) {
+            debug(boost::format("%s heard by %s") % other->tag() % subject.tag(), LogChannels::perception);
+            subject.onObjectHeard(other);
+        } else if (wasHeard && !heard) {
+            debug(boost::format("%s inaudible to %s") % other->tag() % subject.tag(), LogChannels::perception);
+            subject.onObjectInaudible(other);
+        }
+
+        // Sight
+        bool wasSeen = subject.perception().seen.count(other) > 0;
+        if (!wasSeen && seen) {
+            debug(boost::format("%s seen by %s") % other->tag() % subject.tag(), LogChannels::perception);
+            subject.onObjectSeen(other);
+        } else if (wasSeen && !seen) {
+            debug(boost::format("%s vanished from %s") % other->tag() % subject.tag(), LogChannels::perception);
+            subject.onObjectVanished(other);
+        }
+    }
+}
+
+} // namespace game
+
+} // namespace reone
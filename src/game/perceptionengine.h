@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../scene/collision.h"
+
+namespace reone {
+
+class ThreadPool;
+
+namespace scene {
+
+class SceneGraph;
+
+}
+
+namespace game {
+
+class Creature;
+class Object;
+
+/**
+ * Updates what a batch of creatures hears and sees. Candidate pairs are
+ * pruned by hearing and sight range using a spatial hash over creature
+ * positions. Line of sight of all remaining pairs is then tested in a single
+ * batch, optionally distributed across worker threads.
+ *
+ * Perception events are fired on the calling thread, in the same order as if
+ * subjects were updated one by one, iterating over creatures in order.
+ */
+class PerceptionEngine : boost::noncopyable {
+public:
+    /**
+     * @param subjects creatures to update perception of
+     * @param creatures all creatures in the area
+     * @param pool worker threads to test line of sight on, or nullptr
+     */
+    void update(
+        const std::vector<std::shared_ptr<Creature>> &subjects,
+        const std::vector<std::shared_ptr<Object>> &creatures,
+        const scene::SceneGraph &sceneGraph,
+        ThreadPool *pool = nullptr);
+
+private:
+    struct Candidate {
+        int objectIdx {0};
+        bool heard {false};
+        int queryIdx {-1}; /**< index of the line of sight query, or -1 when object cannot be seen */
+    };
+
+    // Reused between updates
+
+    std::vector<std::shared_ptr<Object>> _creatures;
+    std::unordered_map<const Object *, int> _indices;
+    std::unordered_map<uint64_t, std::vector<int>> _cells;
+    std::vector<std::vector<Candidate>> _candidates;
+    std::vector<scene::LineOfSightQuery> _queries;
+
+    // END Reused between updates
+
+    void indexCreatures(const std::vector<std::shared_ptr<Object>> &creatures);
+    void findCandidates(const Creature &subject, std::vector<Candidate> &outCandidates);
+    void fireEvents(Creature &subject, const std::vector<Candidate> &candidates);
+};
+
+} // namespace game
+
+} // namespace reone
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "periodicscheduler.h"
+
+using namespace std;
+
+namespace reone {
+
+namespace game {
+
+static constexpr double kGoldenRatioFraction = 0.6180339887498949;
+
+static uint64_t getJobKey(int type, uint32_t objectId) {
+    return (static_cast<uint64_t>(type) << 32) | objectId;
+}
+
+/**
+ * @return fraction of a period, uniformly distributed for consecutive object ids
+ */
+static double getJobPhase(int type, uint32_t objectId) {
+    double phase = (objectId + 0.5 * type) * kGoldenRatioFraction;
+    return phase - floor(phase);
+}
+
+void PeriodicScheduler::add(int type, uint32_t objectId, float period) {
+    uint64_t key = getJobKey(type, objectId);
+    if (_jobs.count(key) > 0) {
+        return;
+    }
+    Job job;
+    job.type = type;
+    job.objectId = objectId;
+    job.period = period;
+    job.generation = ++_generation;
+    _jobs.insert(make_pair(key, job));
+
+    pushDueJob(_time + period * getJobPhase(type, objectId), key, job.generation);
+}
+
+void PeriodicScheduler::remove(int type, uint32_t objectId) {
+    // Due jobs of removed jobs are discarded lazily, by generation mismatch
+    _jobs.erase(getJobKey(type, objectId));
+}
+
+void PeriodicScheduler::clear() {
+    _jobs.clear();
+    _dueJobs.clear();
+}
+
+void PeriodicScheduler::update(float dt, const JobHandler &handler) {
+    _time += dt;
+    _charged = 0.0f;
+
+    auto startTime = chrono::steady_clock::now();
+    bool anyJobRun = false;
+
+    while (!_dueJobs.empty() && _dueJobs.front().time <= _time) {
+        if (anyJobRun && _budget > 0.0f) {
+            chrono::duration<float> elapsed(chrono::steady_clock::now() - startTime);
+            if (elapsed.count() + _charged >= _budget) {
+                break;
+            }
+        }
+        DueJob dueJob(popDueJob());
+
+        auto maybeJob = _jobs.find(dueJob.key);
+        if (maybeJob == _jobs.end() || maybeJob->second.generation != dueJob.generation) {
+            continue;
+        }
+        Job job(maybeJob->second);
+
+        // Schedule relative to the due time to retain cadence, but skip
+        // periods that were missed entirely
+        double nextTime = dueJob.time + job.period;
+        if (nextTime <= _time) {
+            nextTime = _time + job.period;
+        }
+        pushDueJob(nextTime, dueJob.key, dueJob.generation);
+
+        handler(job.type, job.objectId);
+        anyJobRun = true;
+    }
+}
+
+void PeriodicScheduler::pushDueJob(double time, uint64_t key, uint32_t generation) {
+    DueJob dueJob;
+    dueJob.time = time;
+    dueJob.key = key;
+    dueJob.generation = generation;
+    _dueJobs.push_back(move(dueJob));
+    push_heap(_dueJobs.begin(), _dueJobs.end(), greater<DueJob>());
+}
+
+PeriodicScheduler::DueJob PeriodicScheduler::popDueJob() {
+    pop_heap(_dueJobs.begin(), _dueJobs.end(), greater<DueJob>());
+    DueJob dueJob(_dueJobs.back());
+    _dueJobs.pop_back();
+    return dueJob;
+}
+
+} // namespace game
+
+} // namespace reone
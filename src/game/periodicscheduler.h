@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+namespace reone {
+
+namespace game {
+
+/**
+ * Runs periodic per-object jobs, such as heartbeats and perception updates,
+ * spread evenly across frames. Each job is assigned a phase within its period
+ * based on the object id, and time spent on jobs in a single frame is limited
+ * by a budget. Due jobs that exceed the budget are carried over to the
+ * following frames.
+ */
+class PeriodicScheduler : boost::noncopyable {
+public:
+    typedef std::function<void(int type, uint32_t objectId)> JobHandler;
+
+    /**
+     * Adds a job of the specified type for the specified object, unless it
+     * has already been added.
+     */
+    void add(int type, uint32_t objectId, float period);
+
+    void remove(int type, uint32_t objectId);
+    void clear();
+
+    /**
+     * Advances the scheduler clock and runs due jobs in order of their due
+     * time, until the budget is exhausted. At least one due job is run per
+     * update, so that the scheduler always makes progress.
+     */
+    void update(float dt, const JobHandler &handler);
+
+    /**
+     * Accounts for work, that the running job defers until after the update,
+     * e.g. to run it in a batch, against the budget of the current update.
+     *
+     * @param time estimated time of the deferred work in seconds
+     */
+    void charge(float time) { _charged += time; }
+
+    /**
+     * @param budget time in seconds, or zero for unlimited
+     */
+    void setBudget(float budget) { _budget = budget; }
+
+private:
+    struct Job {
+        int type {0};
+        uint32_t objectId {0};
+        float period {0.0f};
+        uint32_t generation {0};
+    };
+
+    struct DueJob {
+        double time {0.0};
+        uint64_t key {0};
+        uint32_t generation {0};
+
+        bool operator>(const DueJob &other) const {
+            return time > other.time;
+        }
+    };
+
+    std::unordered_map<uint64_t, Job> _jobs;
+    std::vector<DueJob> _dueJobs; /**< min-heap by due time */
+    double _time {0.0};
+    float _budget {0.0f};
+    float _charged {0.0f}; /**< time of deferred work in the current update */
+    uint32_t _generation {0};
+
+    void pushDueJob(double time, uint64_t key, uint32_t generation);
+    DueJob popDueJob();
+};
+
+} // namespace game
+
+} // namespace reone
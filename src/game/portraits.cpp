@@ -38,16 +38,23 @@ void Portraits::init() {
         return;
     }
 
+    TwoDA::ColumnRef resRefColumn(portraits->getColumn("baseresref"));
+    TwoDA::ColumnRef appearanceNumberColumn(portraits->getColumn("appearancenumber"));
+    TwoDA::ColumnRef appearanceSColumn(portraits->getColumn("appearance_s"));
+    TwoDA::ColumnRef appearanceLColumn(portraits->getColumn("appearance_l"));
+    TwoDA::ColumnRef forPCColumn(portraits->getColumn("forpc"));
+    TwoDA::ColumnRef sexColumn(portraits->getColumn("sex"));
+
     for (int row = 0; row < portraits->getRowCount(); ++row) {
-        string resRef(boost::to_lower_copy(portraits->getString(row, "baseresref")));
+        string resRef(boost::to_lower_copy(portraits->getString(row, resRefColumn)));
 
         Portrait portrait;
         portrait.resRef = resRef;
-        portrait.appearanceNumber = portraits->getInt(row, "appearancenumber");
-        portrait.appearanceS = portraits->getInt(row, "appearance_s");
-        portrait.appearanceL = portraits->getInt(row, "appearance_l");
-        portrait.forPC = portraits->getBool(row, "forpc");
-        portrait.sex = portraits->getInt(row, "sex");
+        portrait.appearanceNumber = portraits->getInt(row, appearanceNumberColumn);
+        portrait.appearanceS = portraits->getInt(row, appearanceSColumn);
+        portrait.appearanceL = portraits->getInt(row, appearanceLColumn);
+        portrait.forPC = portraits->getBool(row, forPCColumn);
+        portrait.sex = portraits->getInt(row, sexColumn);
 
         _portraits.push_back(move(portrait));
     }
@@ -41,8 +41,14 @@ void Reputes::init() {
         return;
     }
 
+    TwoDA::ColumnRef labelColumn(repute->getColumn("label"));
     for (int row = 0; row < repute->getRowCount(); ++row) {
-        g_factionLabels.push_back(boost::to_lower_copy(repute->getString(row, "label")));
+        g_factionLabels.push_back(boost::to_lower_copy(repute->getString(row, labelColumn)));
+    }
+
+    vector<TwoDA::ColumnRef> factionColumns;
+    for (auto &label : g_factionLabels) {
+        factionColumns.push_back(repute->getColumn(label));
     }
 
     for (int row = 0; row < repute->getRowCount(); ++row) {
@@ -54,7 +60,7 @@ void Reputes::init() {
             if (label == "player" || label == "glb_xor") {
                 value = kDefaultRepute;
             } else {
-                value = repute->getInt(row, g_factionLabels[i], kDefaultRepute);
+                value = repute->getInt(row, factionColumns[i], kDefaultRepute);
             }
 
             values.push_back(value);
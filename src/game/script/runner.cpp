@@ -20,7 +20,9 @@
 #include "../../script/execution.h"
 #include "../../script/executioncontext.h"
 #include "../../script/routines.h"
+#include "../../script/program.h"
 #include "../../script/scripts.h"
+#include "../../script/verifier.h"
 
 #include "../game.h"
 
@@ -32,26 +34,191 @@ namespace reone {
 
 namespace game {
 
-int ScriptRunner::run(const string &resRef, uint32_t callerId, uint32_t triggerrerId, int userDefinedEventNumber, int scriptVar) {
+static constexpr int kInstructionSlice = 4096;
+
+ScriptRunner::ScriptRunner(IRoutines &routines, Scripts &scripts) :
+    _routines(routines),
+    _scripts(scripts) {
+}
+
+ScriptRunner::~ScriptRunner() {
+}
+
+static void checkInvocation(uint32_t callerId, uint32_t triggerrerId) {
     if (callerId == kObjectSelf) {
         throw invalid_argument("Invalid callerId");
     }
     if (triggerrerId == kObjectSelf) {
         throw invalid_argument("Invalid triggerrerId");
     }
+}
+
+int ScriptRunner::run(const string &resRef, uint32_t callerId, uint32_t triggerrerId, int userDefinedEventNumber, int scriptVar) {
+    checkInvocation(callerId, triggerrerId);
 
     auto program = _scripts.get(resRef);
     if (!program)
         return -1;
 
-    auto ctx = make_unique<ExecutionContext>();
-    ctx->routines = &_routines;
-    ctx->callerId = callerId;
-    ctx->triggererId = triggerrerId;
-    ctx->userDefinedEventNumber = userDefinedEventNumber;
-    ctx->scriptVar = scriptVar;
+    ExecutionContext ctx;
+    ctx.routines = &_routines;
+    ctx.callerId = callerId;
+    ctx.triggererId = triggerrerId;
+    ctx.userDefinedEventNumber = userDefinedEventNumber;
+    ctx.scriptVar = scriptVar;
+
+    PooledExecution execution(*this);
+
+    return execute(move(program), ctx, *execution);
+}
+
+void ScriptRunner::runBatch(const vector<ScriptInvocation> &invocations) {
+    ExecutionContext ctx;
+    ctx.routines = &_routines;
+
+    shared_ptr<ScriptProgram> program;
+
+    for (auto &invocation : invocations) {
+        checkInvocation(invocation.callerId, invocation.triggerrerId);
+
+        // Coalesced with an earlier run, that is still yielded
+        if (isYielded(invocation.resRef, invocation.callerId)) {
+            continue;
+        }
+
+        // Consecutive invocations of the same script share a program lookup
+        if (!program || program->name() != invocation.resRef) {
+            program = _scripts.get(invocation.resRef);
+        }
+        if (!program) {
+            continue;
+        }
+
+        ctx.callerId = invocation.callerId;
+        ctx.triggererId = invocation.triggerrerId;
+        ctx.userDefinedEventNumber = invocation.userDefinedEventNumber;
+        ctx.scriptVar = invocation.scriptVar;
+
+        runPreemptible(program, ctx, invocation);
+    }
+}
+
+void ScriptRunner::runPreemptible(shared_ptr<ScriptProgram> program, const ExecutionContext &ctx, const ScriptInvocation &invocation) {
+    PooledExecution execution(*this);
+
+    // Verified scripts are run synchronously
+    if (program->original()) {
+        execute(move(program), ctx, *execution);
+        return;
+    }
+
+    execution->reset(move(program), ctx);
+    if (execution->run(kInstructionSlice) == ExecutionStatus::Finished) {
+        return;
+    }
+
+    YieldedExecution yielded;
+    yielded.execution = execution.release();
+    yielded.resRef = invocation.resRef;
+    yielded.callerId = invocation.callerId;
+    _yieldedExecutions.push_back(move(yielded));
+}
+
+void ScriptRunner::resumeYielded(float budget) {
+    if (_yieldedExecutions.empty()) {
+        return;
+    }
+    auto startTime = chrono::steady_clock::now();
+    do {
+        if (_nextYielded >= _yieldedExecutions.size()) {
+            _nextYielded = 0;
+        }
+        // Execution is moved out while running, and its slot is looked up
+        // afterwards, as nested preemptible scripts may change the list
+        unique_ptr<ScriptExecution> execution(move(_yieldedExecutions[_nextYielded].execution));
+        ExecutionStatus status = execution->run(kInstructionSlice);
+
+        auto slot = find_if(_yieldedExecutions.begin(), _yieldedExecutions.end(), [](auto &yielded) { return !yielded.execution; });
+        if (slot == _yieldedExecutions.end()) {
+            // Yielded executions were cancelled by a nested script
+            releaseExecution(move(execution));
+            continue;
+        }
+        if (status == ExecutionStatus::Finished) {
+            _nextYielded = distance(_yieldedExecutions.begin(), slot);
+            _yieldedExecutions.erase(slot);
+            releaseExecution(move(execution));
+        } else {
+            _nextYielded = distance(_yieldedExecutions.begin(), slot) + 1;
+            slot->execution = move(execution);
+        }
+    } while (!_yieldedExecutions.empty() && chrono::duration<float>(chrono::steady_clock::now() - startTime).count() < budget);
+}
+
+void ScriptRunner::cancelYielded() {
+    for (auto &yielded : _yieldedExecutions) {
+        // Execution being resumed is moved out of its slot
+        if (yielded.execution) {
+            releaseExecution(move(yielded.execution));
+        }
+    }
+    _yieldedExecutions.clear();
+    _nextYielded = 0;
+}
+
+bool ScriptRunner::isYielded(const string &resRef, uint32_t callerId) const {
+    // Execution being resumed is moved out of its slot, but is still yielded
+    return any_of(_yieldedExecutions.begin(), _yieldedExecutions.end(), [&](auto &yielded) {
+        return yielded.callerId == callerId && yielded.resRef == resRef;
+    });
+}
+
+int ScriptRunner::execute(shared_ptr<ScriptProgram> program, const ExecutionContext &ctx, ScriptExecution &execution) {
+    if (program->original()) {
+        if (!_verifier) {
+            _verifier = make_unique<OptimizationVerifier>(_routines);
+        }
+        if (!_verifier->isRunning()) {
+            return _verifier->run(move(program), ctx);
+        }
+    }
+
+    execution.reset(move(program), ctx);
+
+    return execution.run();
+}
+
+unique_ptr<ScriptExecution> ScriptRunner::acquireExecution() {
+    // Scripts can run other scripts, hence a pool rather than a single execution
+    if (_executionPool.empty()) {
+        return make_unique<ScriptExecution>();
+    }
+    unique_ptr<ScriptExecution> execution(move(_executionPool.back()));
+    _executionPool.pop_back();
+
+    return execution;
+}
+
+void ScriptRunner::releaseExecution(unique_ptr<ScriptExecution> execution) {
+    // Do not keep programs and engine types alive while idle
+    execution->reset(nullptr, ExecutionContext());
+    _executionPool.push_back(move(execution));
+}
+
+ScriptRunner::PooledExecution::PooledExecution(ScriptRunner &runner) :
+    _runner(runner),
+    _execution(runner.acquireExecution()) {
+}
+
+ScriptRunner::PooledExecution::~PooledExecution() {
+    // Also released when a script throws
+    if (_execution) {
+        _runner.releaseExecution(move(_execution));
+    }
+}
 
-    return ScriptExecution(program, move(ctx)).run();
+unique_ptr<ScriptExecution> ScriptRunner::PooledExecution::release() {
+    return move(_execution);
 }
 
 } // namespace game
@@ -23,19 +23,48 @@ namespace reone {
 
 namespace script {
 
+struct ExecutionContext;
+
 class IRoutines;
+class OptimizationVerifier;
+class ScriptExecution;
+class ScriptProgram;
 class Scripts;
 
 } // namespace script
 
 namespace game {
 
+struct ScriptInvocation {
+    std::string resRef;
+    uint32_t callerId {script::kObjectInvalid};
+    uint32_t triggerrerId {script::kObjectInvalid};
+    int userDefinedEventNumber {-1};
+    int scriptVar {-1};
+};
+
+/**
+ * Runs scripts by ResRef. Executions are pooled and reused, so that running
+ * a script does not allocate memory in a steady state.
+ *
+ * Scripts whose results are not needed can be run preemptibly: such scripts
+ * yield after a slice of instructions and are resumed on following frames,
+ * within a time budget. The following rules limit how their side effects
+ * interleave with the rest of the engine:
+ *
+ * - preemption only happens between instructions, never inside a routine
+ * - scripts run by the preemptible ones, e.g. by ExecuteScript, run to completion
+ * - while a script is yielded, further preemptible runs of it by the same
+ *   caller are skipped, so that such runs on an object never overlap; the
+ *   yielded run keeps being resumed within the time budget
+ * - synchronous runs are not affected by yielded scripts and may overlap
+ *   with them, as their callers need results immediately
+ * - yielded scripts are cancelled when the module changes
+ */
 class ScriptRunner {
 public:
-    ScriptRunner(script::IRoutines &routines, script::Scripts &scripts) :
-        _routines(routines),
-        _scripts(scripts) {
-    }
+    ScriptRunner(script::IRoutines &routines, script::Scripts &scripts);
+    ~ScriptRunner();
 
     int run(
         const std::string &resRef,
@@ -44,9 +73,68 @@ public:
         int userDefinedEventNumber = -1,
         int scriptVar = -1);
 
+    /**
+     * Runs a batch of scripts, whose results are not needed, allowing them
+     * to yield. Execution context is set up once for the whole batch, and
+     * consecutive invocations of the same script share a program lookup.
+     */
+    void runBatch(const std::vector<ScriptInvocation> &invocations);
+
+    /**
+     * Resumes yielded scripts in round-robin order, until either all of them
+     * finish or the time budget is exhausted.
+     *
+     * @param budget time in seconds
+     */
+    void resumeYielded(float budget);
+
+    /**
+     * Discards yielded scripts without completing them.
+     */
+    void cancelYielded();
+
 private:
+    /**
+     * Execution acquired from the pool, that is released back to it when
+     * leaving scope, unless moved out.
+     */
+    class PooledExecution : boost::noncopyable {
+    public:
+        PooledExecution(ScriptRunner &runner);
+        ~PooledExecution();
+
+        std::unique_ptr<script::ScriptExecution> release();
+
+        script::ScriptExecution &operator*() const { return *_execution; }
+        script::ScriptExecution *operator->() const { return _execution.get(); }
+
+    private:
+        ScriptRunner &_runner;
+        std::unique_ptr<script::ScriptExecution> _execution;
+    };
+
     script::IRoutines &_routines;
     script::Scripts &_scripts;
+
+    struct YieldedExecution {
+        std::unique_ptr<script::ScriptExecution> execution;
+        std::string resRef;
+        uint32_t callerId {script::kObjectInvalid};
+    };
+
+    std::vector<std::unique_ptr<script::ScriptExecution>> _executionPool; /**< idle executions */
+    std::vector<YieldedExecution> _yieldedExecutions;
+    size_t _nextYielded {0}; /**< round-robin position in yielded executions */
+    std::unique_ptr<script::OptimizationVerifier> _verifier;
+
+    int execute(std::shared_ptr<script::ScriptProgram> program, const script::ExecutionContext &ctx, script::ScriptExecution &execution);
+
+    void runPreemptible(std::shared_ptr<script::ScriptProgram> program, const script::ExecutionContext &ctx, const ScriptInvocation &invocation);
+
+    bool isYielded(const std::string &resRef, uint32_t callerId) const;
+
+    std::unique_ptr<script::ScriptExecution> acquireExecution();
+    void releaseExecution(std::unique_ptr<script::ScriptExecution> execution);
 };
 
 } // namespace game
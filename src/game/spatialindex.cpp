@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "spatialindex.h"
+
+#include "object.h"
+
+using namespace std;
+
+namespace reone {
+
+namespace game {
+
+static constexpr float kCellSize = 10.0f;
+
+static uint64_t getCellKey(int x, int y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+static int getCellCoord(float value) {
+    return static_cast<int>(glm::floor(value / kCellSize));
+}
+
+static bool matchesTypeMask(int type, int typeMask) {
+    return (type & typeMask) == type;
+}
+
+void SpatialIndex::add(const shared_ptr<Object> &object) {
+    if (_entries.count(object.get()) > 0) {
+        return;
+    }
+    Entry entry;
+    entry.type = static_cast<int>(object->type());
+    entry.cellX = getCellCoord(object->position().x);
+    entry.cellY = getCellCoord(object->position().y);
+    _entries.insert(make_pair(object.get(), entry));
+
+    insertIntoCell(object, _grids[entry.type], entry.cellX, entry.cellY);
+}
+
+void SpatialIndex::remove(const Object &object) {
+    auto maybeEntry = _entries.find(&object);
+    if (maybeEntry == _entries.end()) {
+        return;
+    }
+    const Entry &entry = maybeEntry->second;
+    removeFromCell(object, _grids[entry.type], entry.cellX, entry.cellY);
+    _entries.erase(maybeEntry);
+}
+
+void SpatialIndex::update(const Object &object) {
+    auto maybeEntry = _entries.find(&object);
+    if (maybeEntry == _entries.end()) {
+        return;
+    }
+    Entry &entry = maybeEntry->second;
+    int cellX = getCellCoord(object.position().x);
+    int cellY = getCellCoord(object.position().y);
+    if (cellX == entry.cellX && cellY == entry.cellY) {
+        return;
+    }
+    Grid &grid = _grids[entry.type];
+    shared_ptr<Object> sharedObject(removeFromCell(object, grid, entry.cellX, entry.cellY));
+    insertIntoCell(sharedObject, grid, cellX, cellY);
+    entry.cellX = cellX;
+    entry.cellY = cellY;
+}
+
+void SpatialIndex::clear() {
+    _grids.clear();
+    _entries.clear();
+}
+
+void SpatialIndex::insertIntoCell(const shared_ptr<Object> &object, Grid &grid, int cellX, int cellY) {
+    grid.cells[getCellKey(cellX, cellY)].push_back(object);
+    grid.minX = min(grid.minX, cellX);
+    grid.minY = min(grid.minY, cellY);
+    grid.maxX = max(grid.maxX, cellX);
+    grid.maxY = max(grid.maxY, cellY);
+}
+
+shared_ptr<Object> SpatialIndex::removeFromCell(const Object &object, Grid &grid, int cellX, int cellY) {
+    shared_ptr<Object> result;
+    auto maybeCell = grid.cells.find(getCellKey(cellX, cellY));
+    if (maybeCell == grid.cells.end()) {
+        return nullptr;
+    }
+    auto &objects = maybeCell->second;
+    auto maybeObject = find_if(objects.begin(), objects.end(), [&object](auto &o) { return o.get() == &object; });
+    if (maybeObject != objects.end()) {
+        result = move(*maybeObject);
+        objects.erase(maybeObject);
+    }
+    if (objects.empty()) {
+        grid.cells.erase(maybeCell);
+    }
+    return move(result);
+}
+
+shared_ptr<Object> SpatialIndex::getNearest(const glm::vec3 &origin, int nth, int typeMask, const Predicate &predicate) const {
+    if (nth < 0) {
+        return nullptr;
+    }
+    vector<const Grid *> grids;
+    int minX = numeric_limits<int>::max();
+    int minY = numeric_limits<int>::max();
+    int maxX = numeric_limits<int>::min();
+    int maxY = numeric_limits<int>::min();
+    for (auto &grid : _grids) {
+        if (!matchesTypeMask(grid.first, typeMask) || grid.second.cells.empty()) {
+            continue;
+        }
+        grids.push_back(&grid.second);
+        minX = min(minX, grid.second.minX);
+        minY = min(minY, grid.second.minY);
+        maxX = max(maxX, grid.second.maxX);
+        maxY = max(maxY, grid.second.maxY);
+    }
+    if (grids.empty()) {
+        return nullptr;
+    }
+
+    vector<pair<float, shared_ptr<Object>>> candidates;
+    auto byDistance = [](auto &left, auto &right) { return left.first < right.first; };
+    auto visitCell = [&](int x, int y) {
+        if (x < minX || x > maxX || y < minY || y > maxY) {
+            return;
+        }
+        uint64_t key = getCellKey(x, y);
+        for (auto &grid : grids) {
+            auto maybeCell = grid->cells.find(key);
+            if (maybeCell == grid->cells.end()) {
+                continue;
+            }
+            for (auto &object : maybeCell->second) {
+                if (!predicate || predicate(object)) {
+                    candidates.push_back(make_pair(object->getSquareDistanceTo(origin), object));
+                }
+            }
+        }
+    };
+
+    // Visit rings of cells around the origin, until the nth nearest candidate
+    // is closer than any object in cells not yet visited
+    int originX = getCellCoord(origin.x);
+    int originY = getCellCoord(origin.y);
+    for (int ring = 0;; ++ring) {
+        if (ring == 0) {
+            visitCell(originX, originY);
+        } else {
+            for (int x = originX - ring; x <= originX + ring; ++x) {
+                visitCell(x, originY - ring);
+                visitCell(x, originY + ring);
+            }
+            for (int y = originY - ring + 1; y <= originY + ring - 1; ++y) {
+                visitCell(originX - ring, y);
+                visitCell(originX + ring, y);
+            }
+        }
+        bool allVisited = originX - ring <= minX && originX + ring >= maxX && originY - ring <= minY && originY + ring >= maxY;
+        if (static_cast<int>(candidates.size()) > nth) {
+            float visitedRadius = glm::min(
+                glm::min(origin.x - (originX - ring) * kCellSize, (originX + ring + 1) * kCellSize - origin.x),
+                glm::min(origin.y - (originY - ring) * kCellSize, (originY + ring + 1) * kCellSize - origin.y));
+
+            nth_element(candidates.begin(), candidates.begin() + nth, candidates.end(), byDistance);
+            if (allVisited || candidates[nth].first <= visitedRadius * visitedRadius) {
+                return candidates[nth].second;
+            }
+        }
+        if (allVisited) {
+            return nullptr;
+        }
+    }
+}
+
+void SpatialIndex::getInSphere(const glm::vec3 &center, float radius, int typeMask, const Predicate &predicate, vector<shared_ptr<Object>> &outObjects) const {
+    float radius2 = radius * radius;
+    getInBounds(center - radius, center + radius, typeMask, predicate, [&](auto &position) { return glm::distance2(center, position) <= radius2; }, outObjects);
+}
+
+void SpatialIndex::getInCube(const glm::vec3 &center, float halfSize, int typeMask, const Predicate &predicate, vector<shared_ptr<Object>> &outObjects) const {
+    getInBounds(center - halfSize, center + halfSize, typeMask, predicate, [](auto &position) { return true; }, outObjects);
+}
+
+void SpatialIndex::getInCone(const glm::vec3 &origin, const glm::vec3 &dir, float length, float halfAngle, int typeMask, const Predicate &predicate, vector<shared_ptr<Object>> &outObjects) const {
+    float cosHalfAngle = glm::cos(halfAngle);
+    getInBounds(origin - length, origin + length, typeMask, predicate, [&](auto &position) {
+        glm::vec3 originToPosition(position - origin);
+        float distance = glm::length(originToPosition);
+        if (distance > length) {
+            return false;
+        }
+        return distance == 0.0f || glm::dot(originToPosition, dir) >= cosHalfAngle * distance;
+    },
+                outObjects);
+}
+
+void SpatialIndex::getInCylinder(const glm::vec3 &origin, const glm::vec3 &dir, float length, float radius, int typeMask, const Predicate &predicate, vector<shared_ptr<Object>> &outObjects) const {
+    glm::vec3 end(origin + length * dir);
+    float radius2 = radius * radius;
+    getInBounds(glm::min(origin, end) - radius, glm::max(origin, end) + radius, typeMask, predicate, [&](auto &position) {
+        glm::vec3 originToPosition(position - origin);
+        float along = glm::dot(originToPosition, dir);
+        if (along < 0.0f || along > length) {
+            return false;
+        }
+        return glm::length2(originToPosition - along * dir) <= radius2;
+    },
+                outObjects);
+}
+
+void SpatialIndex::getInBounds(
+    const glm::vec3 &min,
+    const glm::vec3 &max,
+    int typeMask,
+    const Predicate &predicate,
+    const function<bool(const glm::vec3 &)> &test,
+    vector<shared_ptr<Object>> &outObjects) const {
+
+    int minX = getCellCoord(min.x);
+    int minY = getCellCoord(min.y);
+    int maxX = getCellCoord(max.x);
+    int maxY = getCellCoord(max.y);
+
+    for (auto &grid : _grids) {
+        if (!matchesTypeMask(grid.first, typeMask) || grid.second.cells.empty()) {
+            continue;
+        }
+        for (int y = glm::max(minY, grid.second.minY); y <= glm::min(maxY, grid.second.maxY); ++y) {
+            for (int x = glm::max(minX, grid.second.minX); x <= glm::min(maxX, grid.second.maxX); ++x) {
+                auto maybeCell = grid.second.cells.find(getCellKey(x, y));
+                if (maybeCell == grid.second.cells.end()) {
+                    continue;
+                }
+                for (auto &object : maybeCell->second) {
+                    const glm::vec3 &position = object->position();
+                    if (position.x < min.x || position.y < min.y || position.z < min.z ||
+                        position.x > max.x || position.y > max.y || position.z > max.z) {
+                        continue;
+                    }
+                    if (test(position) && (!predicate || predicate(object))) {
+                        outObjects.push_back(object);
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace game
+
+} // namespace reone
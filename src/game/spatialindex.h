@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+namespace reone {
+
+namespace game {
+
+class Object;
+
+/**
+ * Uniform grid over the XY plane, one per object type, indexing objects by
+ * their positions. Answers nearest object and shape queries, visiting only
+ * grid cells that may contain matching objects.
+ *
+ * Objects are assigned to cells on add and update, so update must be called
+ * whenever an object moves. Area does so from Object::setPosition, so the
+ * index is never stale between frames. Query results use actual object
+ * positions.
+ */
+class SpatialIndex : boost::noncopyable {
+public:
+    typedef std::function<bool(const std::shared_ptr<Object> &)> Predicate;
+
+    void add(const std::shared_ptr<Object> &object);
+    void remove(const Object &object);
+
+    /**
+     * Moves the object to another cell, if its position has changed
+     * sufficiently. Does nothing if the object has not been added.
+     */
+    void update(const Object &object);
+
+    void clear();
+
+    bool contains(const Object &object) const { return _entries.count(&object) > 0; }
+
+    /**
+     * @param nth 0-based index of the object
+     * @param typeMask bitwise OR of object types to consider
+     * @param predicate optional filter
+     * @return nth nearest object to the origin, or nullptr
+     */
+    std::shared_ptr<Object> getNearest(const glm::vec3 &origin, int nth, int typeMask, const Predicate &predicate = nullptr) const;
+
+    void getInSphere(const glm::vec3 &center, float radius, int typeMask, const Predicate &predicate, std::vector<std::shared_ptr<Object>> &outObjects) const;
+
+    /**
+     * @param halfSize half the length of a cube side
+     */
+    void getInCube(const glm::vec3 &center, float halfSize, int typeMask, const Predicate &predicate, std::vector<std::shared_ptr<Object>> &outObjects) const;
+
+    /**
+     * @param dir normalized direction of the cone axis
+     * @param halfAngle angle between the cone axis and its surface, in radians
+     */
+    void getInCone(const glm::vec3 &origin, const glm::vec3 &dir, float length, float halfAngle, int typeMask, const Predicate &predicate, std::vector<std::shared_ptr<Object>> &outObjects) const;
+
+    /**
+     * @param dir normalized direction of the cylinder axis
+     */
+    void getInCylinder(const glm::vec3 &origin, const glm::vec3 &dir, float length, float radius, int typeMask, const Predicate &predicate, std::vector<std::shared_ptr<Object>> &outObjects) const;
+
+private:
+    struct Grid {
+        std::unordered_map<uint64_t, std::vector<std::shared_ptr<Object>>> cells;
+
+        // Bounds of cells that have ever been occupied
+        int minX {std::numeric_limits<int>::max()};
+        int minY {std::numeric_limits<int>::max()};
+        int maxX {std::numeric_limits<int>::min()};
+        int maxY {std::numeric_limits<int>::min()};
+    };
+
+    struct Entry {
+        int type {0};
+        int cellX {0};
+        int cellY {0};
+    };
+
+    std::map<int, Grid> _grids; /**< by object type */
+    std::unordered_map<const Object *, Entry> _entries;
+
+    void insertIntoCell(const std::shared_ptr<Object> &object, Grid &grid, int cellX, int cellY);
+    std::shared_ptr<Object> removeFromCell(const Object &object, Grid &grid, int cellX, int cellY);
+
+    /**
+     * Appends objects within the bounds, for which the test returns true.
+     */
+    void getInBounds(
+        const glm::vec3 &min,
+        const glm::vec3 &max,
+        int typeMask,
+        const Predicate &predicate,
+        const std::function<bool(const glm::vec3 &)> &test,
+        std::vector<std::shared_ptr<Object>> &outObjects) const;
+};
+
+} // namespace game
+
+} // namespace reone
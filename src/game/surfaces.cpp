@@ -33,14 +33,21 @@ void Surfaces::init() {
     if (!surfacemat) {
         return;
     }
+    TwoDA::ColumnRef labelColumn(surfacemat->getColumn("label"));
+    TwoDA::ColumnRef walkColumn(surfacemat->getColumn("walk"));
+    TwoDA::ColumnRef walkCheckColumn(surfacemat->getColumn("walkcheck"));
+    TwoDA::ColumnRef lineOfSightColumn(surfacemat->getColumn("lineofsight"));
+    TwoDA::ColumnRef grassColumn(surfacemat->getColumn("grass"));
+    TwoDA::ColumnRef soundColumn(surfacemat->getColumn("sound"));
+
     for (int row = 0; row < surfacemat->getRowCount(); ++row) {
         Surface surface;
-        surface.label = surfacemat->getString(row, "label");
-        surface.walk = surfacemat->getBool(row, "walk");
-        surface.walkcheck = surfacemat->getBool(row, "walkcheck");
-        surface.lineOfSight = surfacemat->getBool(row, "lineofsight");
-        surface.grass = surfacemat->getBool(row, "grass");
-        surface.sound = surfacemat->getString(row, "sound");
+        surface.label = surfacemat->getString(row, labelColumn);
+        surface.walk = surfacemat->getBool(row, walkColumn);
+        surface.walkcheck = surfacemat->getBool(row, walkCheckColumn);
+        surface.lineOfSight = surfacemat->getBool(row, lineOfSightColumn);
+        surface.grass = surfacemat->getBool(row, grassColumn);
+        surface.sound = surfacemat->getString(row, soundColumn);
         _surfaces.push_back(move(surface));
     }
 }
@@ -31,19 +31,18 @@ AABB::AABB(const glm::vec3 &min, const glm::vec3 &max) :
 AABB AABB::operator*(const glm::mat4 &m) const {
     AABB aabb;
     if (!_empty) {
-        glm::vec3 a(m * glm::vec4(_min, 1.0f));
-        glm::vec3 b(m * glm::vec4(_max, 1.0f));
-
-        glm::vec3 min(
-            glm::min(a.x, b.x),
-            glm::min(a.y, b.y),
-            glm::min(a.z, b.z));
-
-        glm::vec3 max(
-            glm::max(a.x, b.x),
-            glm::max(a.y, b.y),
-            glm::max(a.z, b.z));
-
+        // Transform all corners, so that the result also bounds rotated boxes
+        glm::vec3 min(numeric_limits<float>::max());
+        glm::vec3 max(numeric_limits<float>::lowest());
+        for (int i = 0; i < 8; ++i) {
+            glm::vec3 corner(
+                (i & 1) ? _max.x : _min.x,
+                (i & 2) ? _max.y : _min.y,
+                (i & 4) ? _max.z : _min.z);
+            glm::vec3 transformed(m * glm::vec4(corner, 1.0f));
+            min = glm::min(min, transformed);
+            max = glm::max(max, transformed);
+        }
         aabb = AABB(min, max);
     }
 
@@ -53,9 +53,7 @@ void BwmReader::doLoad() {
     _offPlanarDistances = readUint32();
 
     if (_type == WalkmeshType::WOK) {
-        _numAabb = readUint32();
-        _offAabb = readUint32();
-
+        ignore(8); // AABB tree, which is rebuilt on load
         ignore(4); // unknown
 
         _numAdjacencies = readUint32();
@@ -89,88 +87,23 @@ void BwmReader::doLoad() {
         _walkmesh->_faces.push_back(move(face));
     }
 
-    if (_type == WalkmeshType::WOK) {
-        loadAABB();
-    }
+    _walkmesh->computeBvh();
 }
 
 void BwmReader::loadVertices() {
-    seek(_offVertices);
-    _vertices.reserve(3 * _numVertices);
-
-    for (uint32_t i = 0; i < _numVertices; ++i) {
-        _vertices.push_back(readFloat());
-        _vertices.push_back(readFloat());
-        _vertices.push_back(readFloat());
-    }
+    _vertices = readFloatArray(_offVertices, 3 * _numVertices);
 }
 
 void BwmReader::loadIndices() {
-    seek(_offIndices);
-    _indices.reserve(3 * _numFaces);
-
-    for (uint32_t i = 0; i < _numFaces; ++i) {
-        _indices.push_back(readUint32());
-        _indices.push_back(readUint32());
-        _indices.push_back(readUint32());
-    }
+    _indices = readUint32Array(_offIndices, 3 * _numFaces);
 }
 
 void BwmReader::loadMaterials() {
-    seek(_offMaterials);
-    _materials.reserve(_numFaces);
-
-    for (uint32_t i = 0; i < _numFaces; ++i) {
-        _materials.push_back(readUint32());
-    }
+    _materials = readUint32Array(_offMaterials, _numFaces);
 }
 
 void BwmReader::loadNormals() {
-    seek(_offNormals);
-    _normals.reserve(3 * _numFaces);
-
-    for (uint32_t i = 0; i < _numFaces; ++i) {
-        _normals.push_back(readFloat());
-        _normals.push_back(readFloat());
-        _normals.push_back(readFloat());
-    }
-}
-
-void BwmReader::loadAABB() {
-    seek(_offAabb);
-
-    vector<shared_ptr<Walkmesh::AABB>> aabbs;
-    aabbs.resize(_numAabb);
-
-    vector<pair<uint32_t, uint32_t>> aabbChildren;
-    aabbChildren.resize(_numAabb);
-
-    for (uint32_t i = 0; i < _numAabb; ++i) {
-        vector<float> bounds(readFloatArray(6));
-        int faceIdx = readInt32();
-        ignore(4); // unknown
-        uint32_t mostSignificantPlane = readUint32();
-        uint32_t childIdx1 = readUint32();
-        uint32_t childIdx2 = readUint32();
-
-        aabbs[i] = make_shared<Walkmesh::AABB>();
-        aabbs[i]->value = AABB(glm::make_vec3(&bounds[0]), glm::make_vec3(&bounds[3]));
-        aabbs[i]->faceIdx = faceIdx;
-
-        aabbChildren[i] = make_pair(childIdx1, childIdx2);
-    }
-
-    for (uint32_t i = 0; i < _numAabb; ++i) {
-        if (aabbs[i]->faceIdx != -1) {
-            continue;
-        }
-        uint32_t childIdx1 = aabbChildren[i].first;
-        uint32_t childIdx2 = aabbChildren[i].second;
-        aabbs[i]->child1 = aabbs[childIdx1];
-        aabbs[i]->child2 = aabbs[childIdx2];
-    }
-
-    _walkmesh->_rootAabb = aabbs[0];
+    _normals = readFloatArray(_offNormals, 3 * _numFaces);
 }
 
 } // namespace graphics
@@ -47,8 +47,6 @@ private:
     uint32_t _offMaterials {0};
     uint32_t _offNormals {0};
     uint32_t _offPlanarDistances {0};
-    uint32_t _numAabb {0};
-    uint32_t _offAabb {0};
     uint32_t _numAdjacencies {0};
     uint32_t _offAdjacencies {0};
     uint32_t _numEdges {0};
@@ -69,7 +67,6 @@ private:
     void loadIndices();
     void loadMaterials();
     void loadNormals();
-    void loadAABB();
 };
 
 } // namespace graphics
@@ -67,6 +67,12 @@ void MdlReader::load(const shared_ptr<istream> &mdl, const shared_ptr<istream> &
     BinaryReader::load(mdl);
 }
 
+void MdlReader::load(ByteView mdl, ByteView mdx) {
+    _mdxReader = make_unique<StreamReader>(move(mdx));
+
+    BinaryReader::load(move(mdl));
+}
+
 static bool isTSLFunctionPointer(uint32_t ptr) {
     return ptr == kMdlModelFuncPtr1TslPC || ptr == kMdlModelFuncPtr1TslXbox;
 }
@@ -416,22 +422,12 @@ shared_ptr<ModelNode::TriangleMesh> MdlReader::readMesh(int flags) {
         // Faces
         seek(kMdlDataOffset + faceArrayDef.offset);
         for (uint32_t i = 0; i < faceArrayDef.count; ++i) {
-            vector<float> normalValues(readFloatArray(3));
+            Mesh::Face &face = faces[i];
+            readFloatArray(glm::value_ptr(face.normal), 3);
             float distance = readFloat();
-            uint32_t material = readUint32();
-            vector<uint16_t> adjacentFaces(readUint16Array(3));
-            vector<uint16_t> faceIndices(readUint16Array(3));
-
-            Mesh::Face face;
-            face.indices[0] = faceIndices[0];
-            face.indices[1] = faceIndices[1];
-            face.indices[2] = faceIndices[2];
-            face.adjacentFaces[0] = adjacentFaces[0];
-            face.adjacentFaces[1] = adjacentFaces[1];
-            face.adjacentFaces[2] = adjacentFaces[2];
-            face.normal = glm::make_vec3(&normalValues[0]);
-            face.material = material;
-            faces[i] = move(face);
+            face.material = readUint32();
+            readUint16Array(face.adjacentFaces, 3);
+            readUint16Array(face.indices, 3);
         }
 
         // Indices
@@ -35,6 +35,7 @@ public:
     MdlReader(Models &models, Textures &textures);
 
     void load(const std::shared_ptr<std::istream> &mdl, const std::shared_ptr<std::istream> &mdx);
+    void load(ByteView mdl, ByteView mdx);
 
     std::shared_ptr<graphics::Model> model() const { return _model; }
 
@@ -18,7 +18,6 @@
 
 #include "lipanimations.h"
 
-#include "../common/streamutil.h"
 #include "../resource/resources.h"
 
 #include "format/lipreader.h"
@@ -33,12 +32,12 @@ namespace reone {
 namespace graphics {
 
 shared_ptr<LipAnimation> LipAnimations::doGet(string resRef) {
-    shared_ptr<ByteArray> lipData(_resources.get(resRef, ResourceType::Lip));
+    ByteView lipData(_resources.getView(resRef, ResourceType::Lip));
     if (!lipData) {
         return nullptr;
     }
     LipReader lip(resRef);
-    lip.load(wrap(lipData));
+    lip.load(move(lipData));
 
     return lip.animation();
 }
@@ -72,6 +72,7 @@ public:
     glm::vec2 getUV1(const Face &face, const glm::vec3 &baryPosition) const;
     glm::vec2 getUV2(const Face &face, const glm::vec3 &baryPosition) const;
 
+    const std::vector<float> &vertices() const { return _vertices; }
     const std::vector<Face> &faces() const { return _faces; }
     const AABB &aabb() const { return _aabb; }
 
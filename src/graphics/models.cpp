@@ -19,10 +19,10 @@
 
 #include "../common/exception/validation.h"
 #include "../common/logutil.h"
-#include "../common/streamutil.h"
 #include "../resource/resources.h"
 
 #include "format/mdlreader.h"
+#include "mesh.h"
 #include "model.h"
 #include "textures.h"
 
@@ -34,39 +34,69 @@ namespace reone {
 
 namespace graphics {
 
+static constexpr size_t kCacheByteBudget = 256 * 1024 * 1024;
+
+static size_t getModelNodeSize(const ModelNode &node) {
+    size_t size = sizeof(ModelNode);
+    shared_ptr<ModelNode::TriangleMesh> mesh(node.mesh());
+    if (mesh && mesh->mesh) {
+        size += sizeof(ModelNode::TriangleMesh);
+        size += mesh->mesh->vertices().size() * sizeof(float);
+        size += mesh->mesh->faces().size() * sizeof(Mesh::Face);
+    }
+    for (auto &child : node.children()) {
+        size += getModelNodeSize(*child);
+    }
+    return size;
+}
+
+/**
+ * Estimates memory usage of a model, excluding its textures and supermodel,
+ * which are accounted for separately.
+ */
+static size_t getModelSize(const Model &model) {
+    size_t size = sizeof(Model);
+    if (model.rootNode()) {
+        size += getModelNodeSize(*model.rootNode());
+    }
+    return size;
+}
+
 Models::Models(Textures &textures, Resources &resources) :
     _textures(textures), _resources(resources) {
+
+    CachePolicy<string, Model> policy;
+    policy.byteBudget = kCacheByteBudget;
+    policy.sizeOf = &getModelSize;
+    policy.retain = [this](const string &resRef) {
+        return !_resources.isTransient(resRef, ResourceType::Mdl) &&
+               !_resources.isTransient(resRef, ResourceType::Mdx);
+    };
+    _cache.setPolicy(move(policy));
 }
 
 void Models::invalidate() {
-    _cache.clear();
+    _cache.invalidate();
 }
 
 shared_ptr<Model> Models::get(const string &resRef) {
     if (resRef.empty()) {
         return nullptr;
     }
-
-    auto maybeModel = _cache.find(resRef);
-    if (maybeModel != _cache.end()) {
-        return maybeModel->second;
-    }
-
-    auto inserted = _cache.insert(make_pair(resRef, doGet(resRef)));
-    return inserted.first->second;
+    return _cache.get(resRef, [this, &resRef]() { return doGet(resRef); });
 }
 
 shared_ptr<Model> Models::doGet(const string &resRef) {
     debug("Load model " + resRef, LogChannels::graphics);
 
-    shared_ptr<ByteArray> mdlData(_resources.get(resRef, ResourceType::Mdl));
-    shared_ptr<ByteArray> mdxData(_resources.get(resRef, ResourceType::Mdx));
+    ByteView mdlData(_resources.getView(resRef, ResourceType::Mdl));
+    ByteView mdxData(_resources.getView(resRef, ResourceType::Mdx));
     shared_ptr<Model> model;
 
     if (mdlData && mdxData) {
         MdlReader mdl(*this, _textures);
         try {
-            mdl.load(wrap(mdlData), wrap(mdxData));
+            mdl.load(move(mdlData), move(mdxData));
             model = mdl.model();
             if (model) {
                 model->init();
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include "../common/memorycache.h"
+
 #include "types.h"
 
 namespace reone {
@@ -36,6 +38,9 @@ class Models : boost::noncopyable {
 public:
     Models(Textures &textures, resource::Resources &resources);
 
+    /**
+     * Removes cached models, except those that cannot be overridden by module archives.
+     */
     void invalidate();
 
     std::shared_ptr<Model> get(const std::string &resRef);
@@ -44,7 +49,7 @@ private:
     Textures &_textures;
     resource::Resources &_resources;
 
-    std::unordered_map<std::string, std::shared_ptr<Model>> _cache;
+    MemoryCache<std::string, Model> _cache;
 
     std::shared_ptr<Model> doGet(const std::string &resRef);
 };
@@ -39,6 +39,42 @@ namespace reone {
 
 namespace graphics {
 
+static constexpr size_t kCacheByteBudget = 512 * 1024 * 1024;
+
+/**
+ * Estimates memory usage of a texture. Pixels of textures that have already
+ * been uploaded are not retained, so their size is approximated from dimensions.
+ */
+static size_t getTextureSize(const Texture &texture) {
+    size_t size = sizeof(Texture);
+    size_t pixelsSize = 0;
+    for (auto &layer : texture.layers()) {
+        if (layer.pixels) {
+            pixelsSize += layer.pixels->size();
+        }
+    }
+    if (pixelsSize == 0) {
+        size_t numLayers = max<size_t>(1, texture.layers().size());
+        pixelsSize = 4 * static_cast<size_t>(texture.width()) * texture.height() * numLayers;
+    }
+    return size + pixelsSize;
+}
+
+Textures::Textures(GraphicsOptions &options, Resources &resources) :
+    _options(options),
+    _resources(resources) {
+
+    CachePolicy<string, Texture> policy;
+    policy.byteBudget = kCacheByteBudget;
+    policy.sizeOf = &getTextureSize;
+    policy.retain = [this](const string &resRef) {
+        return !_resources.isTransient(resRef, ResourceType::Tga) &&
+               !_resources.isTransient(resRef, ResourceType::Txi) &&
+               !_resources.isTransient(resRef, ResourceType::Tpc);
+    };
+    _cache.setPolicy(move(policy));
+}
+
 void Textures::init() {
     _default2DRGB = make_shared<Texture>("default_rgb", getTextureProperties(TextureUsage::Default));
     _default2DRGB->clear(1, 1, PixelFormat::RGB8);
@@ -94,7 +130,7 @@ void Textures::init() {
 }
 
 void Textures::invalidate() {
-    _cache.clear();
+    _cache.invalidate();
 }
 
 void Textures::bind(Texture &texture, int unit) {
@@ -131,14 +167,8 @@ shared_ptr<Texture> Textures::get(const string &resRef, TextureUsage usage) {
     if (resRef.empty()) {
         return nullptr;
     }
-    auto maybeTexture = _cache.find(resRef);
-    if (maybeTexture != _cache.end()) {
-        return maybeTexture->second;
-    }
     string lcResRef(boost::to_lower_copy(resRef));
-    auto inserted = _cache.insert(make_pair(lcResRef, doGet(lcResRef, usage)));
-
-    return inserted.first->second;
+    return _cache.get(lcResRef, [this, &lcResRef, &usage]() { return doGet(lcResRef, usage); });
 }
 
 shared_ptr<Texture> Textures::doGet(const string &resRef, TextureUsage usage) {
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include "../common/memorycache.h"
+
 #include "types.h"
 
 namespace reone {
@@ -34,12 +36,13 @@ class Texture;
 
 class Textures : boost::noncopyable {
 public:
-    Textures(GraphicsOptions &options, resource::Resources &resources) :
-        _options(options),
-        _resources(resources) {
-    }
+    Textures(GraphicsOptions &options, resource::Resources &resources);
 
     void init();
+
+    /**
+     * Removes cached textures, except those that cannot be overridden by module archives.
+     */
     void invalidate();
 
     void bind(Texture &texture, int unit = TextureUnits::mainTex);
@@ -66,7 +69,7 @@ private:
     GraphicsOptions &_options;
     resource::Resources &_resources;
 
-    std::unordered_map<std::string, std::shared_ptr<Texture>> _cache;
+    MemoryCache<std::string, Texture> _cache;
 
     // Built-in
 
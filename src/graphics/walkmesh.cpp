@@ -23,99 +23,251 @@ namespace reone {
 
 namespace graphics {
 
-const Walkmesh::Face *Walkmesh::raycast(
-    set<uint32_t> surfaces,
+static constexpr int kMaxBvhDepth = 64;
+
+static uint32_t getSurfaceBit(uint32_t material) {
+    return material < 32 ? (1u << material) : 0u;
+}
+
+static bool raycastBox(
+    const glm::vec3 &min,
+    const glm::vec3 &max,
     const glm::vec3 &origin,
-    const glm::vec3 &dir,
+    const glm::vec3 &invDir,
     float maxDistance,
-    float &outDistance) const {
+    float &outDistance) {
 
-    // For area walkmeshes, find intersection via AABB tree
-    if (_rootAabb) {
-        return raycastAABB(surfaces, origin, dir, maxDistance, outDistance);
-    }
+    glm::vec3 t1((min - origin) * invDir);
+    glm::vec3 t2((max - origin) * invDir);
+    glm::vec3 tNear(glm::min(t1, t2));
+    glm::vec3 tFar(glm::max(t1, t2));
 
-    // For placeable and door walkmeshes, test all faces for intersection
-    glm::vec2 baryPosition(0.0f);
-    float distance = 0.0f;
-    for (auto &face : _faces) {
-        if (raycastFace(surfaces, face, origin, dir, maxDistance, distance)) {
-            outDistance = distance;
-            return &face;
-        }
+    float tmin = glm::max(glm::max(tNear.x, tNear.y), glm::max(tNear.z, 0.0f));
+    float tmax = glm::min(glm::min(tFar.x, tFar.y), tFar.z);
+    if (tmax < tmin || tmin >= maxDistance) {
+        return false;
     }
 
-    return nullptr;
+    outDistance = tmin;
+    return true;
 }
 
-const Walkmesh::Face *Walkmesh::raycastAABB(
-    set<uint32_t> surfaces,
+const Walkmesh::Face *Walkmesh::raycast(
+    uint32_t surfaces,
     const glm::vec3 &origin,
     const glm::vec3 &dir,
     float maxDistance,
     float &outDistance) const {
 
-    float distance = 0.0f;
+    if (_bvhNodes.empty()) {
+        return nullptr;
+    }
+    glm::vec3 invDir(1.0f / dir);
+    float distance = maxDistance;
+    int faceIdx = -1;
 
-    stack<AABB *> aabbs;
-    aabbs.push(_rootAabb.get());
+    // Entry distance is kept alongside pending nodes, so that nodes farther
+    // than the closest intersection found so far can be skipped
+    pair<int, float> pending[kMaxBvhDepth];
+    int numPending = 0;
 
-    while (!aabbs.empty()) {
-        auto aabb = aabbs.top();
-        aabbs.pop();
+    float rootDistance = 0.0f;
+    const BvhNode &root = _bvhNodes[0];
+    if ((root.surfaces & surfaces) == 0 || !raycastBox(root.min, root.max, origin, invDir, distance, rootDistance)) {
+        return nullptr;
+    }
+    int nodeIdx = 0;
 
-        // Test ray/face intersection for tree leafs
-        if (aabb->faceIdx != -1) {
-            const Face &face = _faces[aabb->faceIdx];
-            if (raycastFace(surfaces, face, origin, dir, maxDistance, distance)) {
-                outDistance = distance;
-                return &face;
+    while (true) {
+        const BvhNode &node = _bvhNodes[nodeIdx];
+        if (node.index < 0) {
+            raycastPacket(_bvhPackets[~node.index], surfaces, origin, dir, distance, faceIdx);
+        } else {
+            // Descend into the nearest intersected child, defer the other one
+            int childIdx[2] {nodeIdx + 1, node.index};
+            float childDistance[2] {0.0f, 0.0f};
+            bool childHit[2];
+            for (int i = 0; i < 2; ++i) {
+                const BvhNode &child = _bvhNodes[childIdx[i]];
+                childHit[i] = (child.surfaces & surfaces) != 0 && raycastBox(child.min, child.max, origin, invDir, distance, childDistance[i]);
+            }
+            if (childHit[0] && childHit[1]) {
+                int nearIdx = childDistance[0] <= childDistance[1] ? 0 : 1;
+                pending[numPending++] = make_pair(childIdx[1 - nearIdx], childDistance[1 - nearIdx]);
+                nodeIdx = childIdx[nearIdx];
+                continue;
+            }
+            if (childHit[0] || childHit[1]) {
+                nodeIdx = childIdx[childHit[0] ? 0 : 1];
+                continue;
             }
-            continue;
-        }
-
-        // Test ray/AABB intersection
-        if (!aabb->value.raycast(origin, dir, maxDistance, distance)) {
-            continue;
         }
-
-        // Find intersection with child AABB nodes
-        if (aabb->child1) {
-            aabbs.push(aabb->child1.get());
+        while (numPending > 0 && pending[numPending - 1].second >= distance) {
+            --numPending;
         }
-        if (aabb->child2) {
-            aabbs.push(aabb->child2.get());
+        if (numPending == 0) {
+            break;
         }
+        nodeIdx = pending[--numPending].first;
+    }
+
+    if (faceIdx == -1) {
+        return nullptr;
     }
+    outDistance = distance;
+
+    return &_faces[faceIdx];
+}
 
-    return nullptr;
+uint32_t Walkmesh::getSurfaceMask(const set<uint32_t> &materials) {
+    uint32_t mask = 0;
+    for (auto &material : materials) {
+        mask |= getSurfaceBit(material);
+    }
+    return mask;
 }
 
-bool Walkmesh::raycastFace(
-    set<uint32_t> surfaces,
-    const Face &face,
+void Walkmesh::raycastPacket(
+    const TrianglePacket &packet,
+    uint32_t surfaces,
     const glm::vec3 &origin,
     const glm::vec3 &dir,
-    float maxDistance,
-    float &outDistance) const {
+    float &inOutDistance,
+    int &outFaceIdx) const {
 
-    if (surfaces.count(face.material) == 0) {
-        return false;
+    // Two-sided Moller-Trumbore test, written without branches over lanes,
+    // so that it is vectorized by the compiler
+    float distances[kPacketSize];
+    bool hits[kPacketSize];
+    for (int i = 0; i < kPacketSize; ++i) {
+        float e1x = packet.edge1[0][i], e1y = packet.edge1[1][i], e1z = packet.edge1[2][i];
+        float e2x = packet.edge2[0][i], e2y = packet.edge2[1][i], e2z = packet.edge2[2][i];
+
+        float px = dir.y * e2z - dir.z * e2y;
+        float py = dir.z * e2x - dir.x * e2z;
+        float pz = dir.x * e2y - dir.y * e2x;
+        float det = e1x * px + e1y * py + e1z * pz;
+        float invDet = 1.0f / det;
+
+        float sx = origin.x - packet.v0[0][i];
+        float sy = origin.y - packet.v0[1][i];
+        float sz = origin.z - packet.v0[2][i];
+        float u = (sx * px + sy * py + sz * pz) * invDet;
+
+        float qx = sy * e1z - sz * e1y;
+        float qy = sz * e1x - sx * e1z;
+        float qz = sx * e1y - sy * e1x;
+        float v = (dir.x * qx + dir.y * qy + dir.z * qz) * invDet;
+        float t = (e2x * qx + e2y * qy + e2z * qz) * invDet;
+
+        distances[i] = t;
+        hits[i] = (packet.surfaces[i] & surfaces) != 0 &&
+                  glm::abs(det) > numeric_limits<float>::epsilon() &&
+                  u >= 0.0f && v >= 0.0f && u + v <= 1.0f &&
+                  t > 0.0f && t < inOutDistance;
+    }
+    for (int i = 0; i < kPacketSize; ++i) {
+        if (hits[i] && distances[i] < inOutDistance) {
+            inOutDistance = distances[i];
+            outFaceIdx = packet.faceIdx[i];
+        }
+    }
+}
+
+void Walkmesh::computeBvh() {
+    _bvhNodes.clear();
+    _bvhPackets.clear();
+    _aabb.reset();
+    if (_faces.empty()) {
+        return;
+    }
+    vector<int> faceIndices;
+    vector<glm::vec3> centroids;
+    faceIndices.reserve(_faces.size());
+    centroids.reserve(_faces.size());
+    for (size_t i = 0; i < _faces.size(); ++i) {
+        auto &vertices = _faces[i].vertices;
+        faceIndices.push_back(static_cast<int>(i));
+        centroids.push_back((vertices[0] + vertices[1] + vertices[2]) / 3.0f);
+    }
+    _bvhNodes.reserve(2 * (_faces.size() / kPacketSize + 1));
+    _bvhPackets.reserve(_faces.size() / kPacketSize + 1);
+
+    computeBvhNode(faceIndices, 0, static_cast<int>(faceIndices.size()), centroids);
+
+    _aabb = AABB(_bvhNodes[0].min, _bvhNodes[0].max);
+}
+
+int Walkmesh::computeBvhNode(vector<int> &faceIndices, int begin, int end, const vector<glm::vec3> &centroids) {
+    int nodeIdx = static_cast<int>(_bvhNodes.size());
+    _bvhNodes.push_back(BvhNode());
+
+    AABB bounds;
+    AABB centroidBounds;
+    uint32_t surfaces = 0;
+    for (int i = begin; i < end; ++i) {
+        const Face &face = _faces[faceIndices[i]];
+        for (auto &vertex : face.vertices) {
+            bounds.expand(vertex);
+        }
+        centroidBounds.expand(centroids[faceIndices[i]]);
+        surfaces |= getSurfaceBit(face.material);
     }
 
-    const glm::vec3 &p0 = face.vertices[0];
-    const glm::vec3 &p1 = face.vertices[1];
-    const glm::vec3 &p2 = face.vertices[2];
+    int index;
+    if (end - begin <= kPacketSize) {
+        index = ~computeBvhPacket(faceIndices, begin, end);
+    } else {
+        // Split at the median centroid along the longest axis, rounded to
+        // packet size so that leaf packets are full
+        glm::vec3 size(centroidBounds.getSize());
+        int axis = size.x >= size.y && size.x >= size.z ? 0 : (size.y >= size.z ? 1 : 2);
+        int numPackets = (end - begin + kPacketSize - 1) / kPacketSize;
+        int mid = begin + (numPackets / 2) * kPacketSize;
+        nth_element(
+            faceIndices.begin() + begin,
+            faceIndices.begin() + mid,
+            faceIndices.begin() + end,
+            [&centroids, &axis](int left, int right) { return centroids[left][axis] < centroids[right][axis]; });
 
-    glm::vec2 baryPosition(0.0f);
-    float distance = 0.0f;
+        computeBvhNode(faceIndices, begin, mid, centroids);
+        index = computeBvhNode(faceIndices, mid, end, centroids);
+    }
+
+    BvhNode &node = _bvhNodes[nodeIdx];
+    node.min = bounds.min();
+    node.max = bounds.max();
+    node.index = index;
+    node.surfaces = surfaces;
+
+    return nodeIdx;
+}
 
-    if (glm::intersectRayTriangle(origin, dir, p0, p1, p2, baryPosition, distance) && distance > 0.0f && distance < maxDistance) {
-        outDistance = distance;
-        return true;
+int Walkmesh::computeBvhPacket(const vector<int> &faceIndices, int begin, int end) {
+    TrianglePacket packet;
+    for (int i = 0; i < kPacketSize; ++i) {
+        glm::vec3 v0(0.0f), edge1(0.0f), edge2(0.0f);
+        uint32_t surfaces = 0;
+        int faceIdx = -1;
+        if (begin + i < end) {
+            faceIdx = faceIndices[begin + i];
+            const Face &face = _faces[faceIdx];
+            v0 = face.vertices[0];
+            edge1 = face.vertices[1] - face.vertices[0];
+            edge2 = face.vertices[2] - face.vertices[0];
+            surfaces = getSurfaceBit(face.material);
+        }
+        for (int j = 0; j < 3; ++j) {
+            packet.v0[j][i] = v0[j];
+            packet.edge1[j][i] = edge1[j];
+            packet.edge2[j][i] = edge2[j];
+        }
+        packet.surfaces[i] = surfaces;
+        packet.faceIdx[i] = faceIdx;
     }
+    _bvhPackets.push_back(move(packet));
 
-    return false;
+    return static_cast<int>(_bvhPackets.size()) - 1;
 }
 
 } // namespace graphics
@@ -35,18 +35,15 @@ public:
         glm::vec3 normal {0.0f};
     };
 
-    struct AABB {
-        graphics::AABB value;
-        int faceIdx {-1};
-        std::shared_ptr<AABB> child1;
-        std::shared_ptr<AABB> child2;
-    };
-
     /**
+     * Finds the closest face intersected by the ray, considering only faces
+     * whose material is in the surface mask.
+     *
+     * @param surfaces bitmask of materials, where bit N stands for material N
      * @return pointer to intersected face or nullptr, when no intersection
      */
     const Walkmesh::Face *raycast(
-        std::set<uint32_t> walkcheckSurfaces,
+        uint32_t surfaces,
         const glm::vec3 &origin,
         const glm::vec3 &dir,
         float maxDistance,
@@ -54,28 +51,59 @@ public:
 
     bool isAreaWalkmesh() const { return _area; }
 
+    /**
+     * @return bitmask of the specified materials, ignoring materials above 31
+     */
+    static uint32_t getSurfaceMask(const std::set<uint32_t> &materials);
+
     const std::vector<Face> &faces() const { return _faces; }
+    const AABB &aabb() const { return _aabb; }
 
 private:
+    static constexpr int kPacketSize = 4;
+
+    /**
+     * Node of a flattened BVH. Left child of an inner node immediately
+     * follows it, right child is referenced by index.
+     */
+    struct BvhNode {
+        glm::vec3 min {0.0f};
+        int index {0}; /**< right child index, or bitwise negation of the packet index for leaves */
+        glm::vec3 max {0.0f};
+        uint32_t surfaces {0}; /**< union of material bits of faces in this subtree */
+    };
+
+    /**
+     * Up to kPacketSize triangles in SoA layout, so that they can be tested
+     * against a ray simultaneously. Unused lanes have an empty surface mask.
+     */
+    struct alignas(16) TrianglePacket {
+        float v0[3][kPacketSize];
+        float edge1[3][kPacketSize];
+        float edge2[3][kPacketSize];
+        uint32_t surfaces[kPacketSize];
+        int faceIdx[kPacketSize];
+    };
+
     std::vector<Face> _faces;
-    std::shared_ptr<AABB> _rootAabb;
+    std::vector<BvhNode> _bvhNodes;
+    std::vector<TrianglePacket> _bvhPackets;
+    AABB _aabb;
 
     bool _area {false};
 
-    const Walkmesh::Face *raycastAABB(
-        std::set<uint32_t> surfaces,
-        const glm::vec3 &origin,
-        const glm::vec3 &dir,
-        float maxDistance,
-        float &outDistance) const;
+    void computeBvh();
+
+    int computeBvhNode(std::vector<int> &faceIndices, int begin, int end, const std::vector<glm::vec3> &centroids);
+    int computeBvhPacket(const std::vector<int> &faceIndices, int begin, int end);
 
-    bool raycastFace(
-        std::set<uint32_t> surfaces,
-        const Walkmesh::Face &face,
+    void raycastPacket(
+        const TrianglePacket &packet,
+        uint32_t surfaces,
         const glm::vec3 &origin,
         const glm::vec3 &dir,
-        float maxDistance,
-        float &outDistance) const;
+        float &inOutDistance,
+        int &outFaceIdx) const;
 
     friend class BwmReader;
 };
@@ -17,7 +17,6 @@
 
 #include "walkmeshes.h"
 
-#include "../common/streamutil.h"
 #include "../resource/resources.h"
 
 #include "format/bwmreader.h"
@@ -49,12 +48,12 @@ shared_ptr<Walkmesh> Walkmeshes::get(const string &resRef, ResourceType type) {
 }
 
 shared_ptr<Walkmesh> Walkmeshes::doGet(const string &resRef, ResourceType type) {
-    shared_ptr<ByteArray> data(_resources.get(resRef, type));
+    ByteView data(_resources.getView(resRef, type));
     shared_ptr<Walkmesh> walkmesh;
 
     if (data) {
         BwmReader bwm;
-        bwm.load(wrap(data));
+        bwm.load(move(data));
         walkmesh = bwm.walkmesh();
     }
 
@@ -36,6 +36,8 @@
 #include "../../resource/resources.h"
 #include "../../scene/types.h"
 #include "../../script/executioncontext.h"
+#include "../../script/instrutil.h"
+#include "../../script/profiler.h"
 #include "../../script/routine.h"
 #include "../../script/routines.h"
 #include "../../script/variable.h"
@@ -74,6 +76,7 @@ void Console::init() {
     addCommand("givexp", "xp", "give experience to selected creature", bind(&Console::cmdGiveXP, this, _1, _2));
     addCommand("showwalkmesh", "sw", "toggle rendering walkmesh", bind(&Console::cmdShowWalkmesh, this, _1, _2));
     addCommand("showtriggers", "st", "toggle rendering triggers", bind(&Console::cmdShowTriggers, this, _1, _2));
+    addCommand("profilescripts", "ps", "profile script execution", bind(&Console::cmdProfileScripts, this, _1, _2));
 
     addCommand("help", "h", "list console commands", bind(&Console::cmdHelp, this, _1, _2));
 }
@@ -449,6 +452,57 @@ void Console::cmdShowTriggers(string input, vector<string> tokens) {
     setShowTriggers(show);
 }
 
+void Console::cmdProfileScripts(string input, vector<string> tokens) {
+    static constexpr int kMaxPrintedEntries = 8;
+
+    if (tokens.size() < 2) {
+        print("Usage: profilescripts on|off|reset|print|save path");
+        return;
+    }
+    const string &action = tokens[1];
+    if (action == "on") {
+        setScriptProfilingEnabled(true);
+    } else if (action == "off") {
+        setScriptProfilingEnabled(false);
+    } else if (action == "reset") {
+        resetScriptProfile();
+    } else if (action == "print") {
+        auto printEntries = [this](const vector<ScriptProfileEntry> &entries) {
+            for (int i = 0; i < static_cast<int>(entries.size()) && i < kMaxPrintedEntries; ++i) {
+                const ScriptProfileEntry &entry = entries[i];
+                print(str(boost::format("  %s: %d calls, %.3f ms incl, %.3f ms excl") %
+                    entry.name %
+                    entry.calls %
+                    (entry.inclusiveTime / 1e6) %
+                    (entry.exclusiveTime / 1e6)));
+            }
+        };
+        print("Scripts:");
+        printEntries(getScriptProfile(ScriptProfileFrameType::Script));
+        print("Routines:");
+        printEntries(getScriptProfile(ScriptProfileFrameType::Routine));
+
+        print("Instructions:");
+        auto histogram = getScriptInstructionHistogram();
+        for (int i = 0; i < static_cast<int>(histogram.size()) && i < kMaxPrintedEntries; ++i) {
+            print(str(boost::format("  %s: %d") % describeInstructionType(histogram[i].first) % histogram[i].second));
+        }
+    } else if (action == "save") {
+        if (tokens.size() < 3) {
+            print("Usage: profilescripts save path");
+            return;
+        }
+        try {
+            saveScriptProfile(tokens[2]);
+            print("Script profile saved to " + tokens[2]);
+        } catch (const runtime_error &e) {
+            print(e.what());
+        }
+    } else {
+        print("Unknown action: " + action);
+    }
+}
+
 void Console::cmdHelp(string input, vector<string> tokens) {
     for (auto &cmd : _commands) {
         auto text = cmd.name;
@@ -110,6 +110,7 @@ private:
     void cmdGiveXP(std::string input, std::vector<std::string> tokens);
     void cmdShowWalkmesh(std::string input, std::vector<std::string> tokens);
     void cmdShowTriggers(std::string input, std::vector<std::string> tokens);
+    void cmdProfileScripts(std::string input, std::vector<std::string> tokens);
     void cmdHelp(std::string input, std::vector<std::string> tokens);
 
     // END Commands
@@ -158,6 +158,9 @@ void KotOR::init() {
 
     auto routines = make_unique<Routines>(*this, _services);
     _scriptRunner = make_unique<ScriptRunner>(*routines, _services.scripts);
+    if (_options.optimizeScripts) {
+        _services.scripts.setOptimizer(make_unique<ScriptOptimizer>(*routines), _options.verifyScripts);
+    }
 
     auto map = make_unique<Map>(*this, _services);
     auto console = make_unique<Console>(*this, _services);
@@ -145,7 +145,10 @@ shared_ptr<Object> getObject(const vector<Variable> &args, int index, const Rout
     throwIfOutOfRange(args, index);
     throwIfUnexpectedType(VariableType::Object, args[index].type);
 
-    uint32_t objectId = args[index].objectId;
+    return getObjectById(args[index].objectId, ctx);
+}
+
+shared_ptr<Object> getObjectById(uint32_t objectId, const RoutineContext &ctx) {
     if (objectId == kObjectSelf) {
         objectId = ctx.execution.callerId;
     }
@@ -52,6 +52,7 @@ struct RoutineContext;
 
 std::shared_ptr<game::Object> getCaller(const RoutineContext &ctx);
 std::shared_ptr<game::Object> getTriggerrer(const RoutineContext &ctx);
+std::shared_ptr<game::Object> getObjectById(uint32_t objectId, const RoutineContext &ctx);
 
 int getInt(const std::vector<script::Variable> &args, int index);
 float getFloat(const std::vector<script::Variable> &args, int index);
@@ -65,8 +65,8 @@ R_ROUTINE(getLastAttacker)
 R_ROUTINE(actionAttack)
 R_ROUTINE(getNearestCreature)
 R_ROUTINE(actionPlayAnimation)
-R_ROUTINE(getDistanceToObject)
-R_ROUTINE(getIsObjectValid)
+float getDistanceToObject(const RoutineContext &ctx, uint32_t objectId);
+int getIsObjectValid(const RoutineContext &ctx, uint32_t objectId);
 R_ROUTINE(actionOpenDoor)
 R_ROUTINE(actionCloseDoor)
 R_ROUTINE(playSound)
@@ -158,7 +158,7 @@ R_ROUTINE(getCommandable)
 R_ROUTINE(effectRegenerate)
 R_ROUTINE(effectMovementSpeedIncrease)
 R_ROUTINE(getHitDice)
-R_ROUTINE(getTag)
+std::string getTag(const RoutineContext &ctx, uint32_t objectId);
 R_ROUTINE(resistForce)
 R_ROUTINE(getEffectType)
 R_ROUTINE(getFactionEqual)
@@ -171,7 +171,7 @@ R_ROUTINE(getListenPatternNumber)
 R_ROUTINE(actionJumpToObject)
 R_ROUTINE(getWaypointByTag)
 R_ROUTINE(effectLinkEffects)
-R_ROUTINE(getObjectByTag)
+uint32_t getObjectByTag(const RoutineContext &ctx, const std::string &tag, int nth);
 R_ROUTINE(adjustAlignment)
 R_ROUTINE(actionWait)
 R_ROUTINE(actionStartConversation)
@@ -419,10 +419,10 @@ R_ROUTINE(aurPostString)
 R_ROUTINE(barkString)
 R_ROUTINE(effectPsychicStatic)
 R_ROUTINE(playVisualAreaEffect)
-R_ROUTINE(getLocalBoolean)
-R_ROUTINE(setLocalBoolean)
-R_ROUTINE(getLocalNumber)
-R_ROUTINE(setLocalNumber)
+int getLocalBoolean(const RoutineContext &ctx, uint32_t objectId, int index);
+void setLocalBoolean(const RoutineContext &ctx, uint32_t objectId, int index, int value);
+int getLocalNumber(const RoutineContext &ctx, uint32_t objectId, int index);
+void setLocalNumber(const RoutineContext &ctx, uint32_t objectId, int index, int value);
 R_ROUTINE(soundObjectGetPitchVariance)
 R_ROUTINE(getGlobalLocation)
 R_ROUTINE(setGlobalLocation)
@@ -267,24 +267,20 @@ Variable getNearestCreature(const vector<Variable> &args, const RoutineContext &
     return Variable::ofObject(getObjectIdOrInvalid(creature));
 }
 
-Variable getDistanceToObject(const vector<Variable> &args, const RoutineContext &ctx) {
+float getDistanceToObject(const RoutineContext &ctx, uint32_t objectId) {
     auto caller = getCaller(ctx);
-    auto object = getObject(args, 0, ctx);
+    auto object = getObjectById(objectId, ctx);
 
-    return Variable::ofFloat(caller->getDistanceTo(*object));
+    return caller->getDistanceTo(*object);
 }
 
-Variable getIsObjectValid(const vector<Variable> &args, const RoutineContext &ctx) {
-    throwIfOutOfRange(args, 0);
-    throwIfUnexpectedType(VariableType::Object, args[0].type);
-
-    uint32_t objectId = args[0].objectId;
+int getIsObjectValid(const RoutineContext &ctx, uint32_t objectId) {
     if (objectId == kObjectSelf) {
         objectId = ctx.execution.callerId;
     }
     auto object = ctx.game.getObjectById(objectId);
 
-    return Variable::ofInt(static_cast<int>(object != nullptr));
+    return static_cast<int>(object != nullptr);
 }
 
 Variable playSound(const vector<Variable> &args, const RoutineContext &ctx) {
@@ -661,19 +657,19 @@ Variable getFirstObjectInShape(const vector<Variable> &args, const RoutineContex
     bool lineOfSight = getIntAsBoolOrElse(args, 3, false);
     int objectFilter = getIntOrElse(args, 4, static_cast<int>(ObjectType::Creature));
     auto origin = getVectorOrElse(args, 5, glm::vec3(0.0f));
+    auto caller = getCaller(ctx);
 
-    throw NotImplementedException();
+    auto object = ctx.game.module()->area()->getFirstObjectInShape(caller->id(), shape, size, *target, lineOfSight, objectFilter, origin);
+
+    return Variable::ofObject(getObjectIdOrInvalid(object));
 }
 
 Variable getNextObjectInShape(const vector<Variable> &args, const RoutineContext &ctx) {
-    auto shape = getIntAsEnum<Shape>(args, 0);
-    float size = getFloat(args, 1);
-    auto target = getLocationArgument(args, 2);
-    bool lineOfSight = getIntAsBoolOrElse(args, 3, false);
-    int objectFilter = getIntOrElse(args, 4, static_cast<int>(ObjectType::Creature));
-    auto origin = getVectorOrElse(args, 5, glm::vec3(0.0f));
+    // Shape arguments are those passed to GetFirstObjectInShape
+    auto caller = getCaller(ctx);
+    auto object = ctx.game.module()->area()->getNextObjectInShape(caller->id());
 
-    throw NotImplementedException();
+    return Variable::ofObject(getObjectIdOrInvalid(object));
 }
 
 Variable signalEvent(const vector<Variable> &args, const RoutineContext &ctx) {
@@ -805,9 +801,9 @@ Variable getHitDice(const vector<Variable> &args, const RoutineContext &ctx) {
     return Variable::ofInt(creature->attributes().getAggregateLevel());
 }
 
-Variable getTag(const vector<Variable> &args, const RoutineContext &ctx) {
-    auto object = getObject(args, 0, ctx);
-    return Variable::ofString(object->tag());
+string getTag(const RoutineContext &ctx, uint32_t objectId) {
+    auto object = getObjectById(objectId, ctx);
+    return object->tag();
 }
 
 Variable resistForce(const vector<Variable> &args, const RoutineContext &ctx) {
@@ -886,18 +882,15 @@ Variable getWaypointByTag(const vector<Variable> &args, const RoutineContext &ct
     return Variable::ofObject(getObjectIdOrInvalid(result));
 }
 
-Variable getObjectByTag(const vector<Variable> &args, const RoutineContext &ctx) {
-    string tag = boost::to_lower_copy(getString(args, 0));
-    int nth = getIntOrElse(args, 1, 0);
-
+uint32_t getObjectByTag(const RoutineContext &ctx, const string &tag, int nth) {
     shared_ptr<Object> object;
     if (!tag.empty()) {
-        object = ctx.game.module()->area()->getObjectByTag(tag, nth);
+        object = ctx.game.module()->area()->getObjectByTag(boost::to_lower_copy(tag), nth);
     } else {
         object = ctx.game.party().player();
     }
 
-    return Variable::ofObject(getObjectIdOrInvalid(object));
+    return getObjectIdOrInvalid(object);
 }
 
 Variable adjustAlignment(const vector<Variable> &args, const RoutineContext &ctx) {
@@ -1006,9 +999,7 @@ Variable getNearestObject(const vector<Variable> &args, const RoutineContext &ct
     auto target = getObjectOrCaller(args, 1, ctx);
     int nth = getIntOrElse(args, 2, 1);
 
-    auto object = ctx.game.module()->area()->getNearestObject(target->position(), nth - 1, [&objectType](auto &object) {
-        return object->type() == objectType;
-    });
+    auto object = ctx.game.module()->area()->getNearestObject(target->position(), nth - 1, static_cast<int>(objectType));
 
     return Variable::ofObject(getObjectIdOrInvalid(object));
 }
@@ -1018,7 +1009,7 @@ Variable getNearestObjectByTag(const vector<Variable> &args, const RoutineContex
     auto target = getObjectOrCaller(args, 1, ctx);
     int nth = getIntOrElse(args, 2, 1);
 
-    auto object = ctx.game.module()->area()->getNearestObject(target->position(), nth - 1, [&tag](auto &object) {
+    auto object = ctx.game.module()->area()->getNearestObject(target->position(), nth - 1, static_cast<int>(ObjectType::All), [&tag](auto &object) {
         return object->tag() == tag;
     });
 
@@ -2479,39 +2470,26 @@ Variable playVisualAreaEffect(const vector<Variable> &args, const RoutineContext
     return Variable::ofNull();
 }
 
-Variable getLocalBoolean(const vector<Variable> &args, const RoutineContext &ctx) {
-    auto object = getObject(args, 0, ctx);
-    int index = getInt(args, 1);
+int getLocalBoolean(const RoutineContext &ctx, uint32_t objectId, int index) {
+    auto object = getObjectById(objectId, ctx);
     bool value = object->getLocalBoolean(index);
 
-    return Variable::ofInt(static_cast<int>(value));
+    return static_cast<int>(value);
 }
 
-Variable setLocalBoolean(const vector<Variable> &args, const RoutineContext &ctx) {
-    auto object = getObject(args, 0, ctx);
-    int index = getInt(args, 1);
-    bool value = getIntAsBool(args, 2);
-
-    object->setLocalBoolean(index, value);
-
-    return Variable::ofNull();
+void setLocalBoolean(const RoutineContext &ctx, uint32_t objectId, int index, int value) {
+    auto object = getObjectById(objectId, ctx);
+    object->setLocalBoolean(index, value != 0);
 }
 
-Variable getLocalNumber(const vector<Variable> &args, const RoutineContext &ctx) {
-    auto object = getObject(args, 0, ctx);
-    int index = getInt(args, 1);
-
-    return Variable::ofInt(object->getLocalNumber(index));
+int getLocalNumber(const RoutineContext &ctx, uint32_t objectId, int index) {
+    auto object = getObjectById(objectId, ctx);
+    return object->getLocalNumber(index);
 }
 
-Variable setLocalNumber(const vector<Variable> &args, const RoutineContext &ctx) {
-    auto object = getObject(args, 0, ctx);
-    int index = getInt(args, 1);
-    int value = getInt(args, 2);
-
+void setLocalNumber(const RoutineContext &ctx, uint32_t objectId, int index, int value) {
+    auto object = getObjectById(objectId, ctx);
     object->setLocalNumber(index, value);
-
-    return Variable::ofNull();
 }
 
 Variable soundObjectGetPitchVariance(const vector<Variable> &args, const RoutineContext &ctx) {
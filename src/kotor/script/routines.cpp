@@ -20,6 +20,7 @@
 #include "../../common/collectionutil.h"
 #include "../../game/services.h"
 #include "../../game/types.h"
+#include "../../script/typedroutine.h"
 #include "../../script/variable.h"
 
 #include "routine/context.h"
@@ -48,6 +49,22 @@ namespace kotor {
 
 static constexpr int kBaseItemInvalid = 256;
 
+static Variable getDefaultReturnValue(VariableType retType) {
+    Variable defRetValue;
+    defRetValue.type = retType;
+    switch (retType) {
+    case VariableType::Float:
+        defRetValue.floatValue = -1.0f;
+        break;
+    case VariableType::Object:
+        defRetValue.objectId = kObjectInvalid;
+        break;
+    default:
+        break;
+    }
+    return move(defRetValue);
+}
+
 void Routines::initForKotOR() {
     add("Random", R_INT, {R_INT}, &routine::random);
     add("PrintString", R_VOID, {R_STRING}, &routine::printString);
@@ -90,8 +107,8 @@ void Routines::initForKotOR() {
     add("GetNearestCreature", R_OBJECT, {R_INT, R_INT, R_OBJECT, R_INT, R_INT, R_INT, R_INT, R_INT}, &routine::getNearestCreature);
     add("ActionSpeakString", R_VOID, {R_STRING, R_INT}, &routine::unsupported);
     add("ActionPlayAnimation", R_VOID, {R_INT, R_FLOAT, R_FLOAT}, &routine::actionPlayAnimation);
-    add("GetDistanceToObject", R_FLOAT, {R_OBJECT}, &routine::getDistanceToObject);
-    add("GetIsObjectValid", R_INT, {R_OBJECT}, &routine::getIsObjectValid);
+    add("GetDistanceToObject", &routine::getDistanceToObject);
+    add("GetIsObjectValid", &routine::getIsObjectValid);
     add("ActionOpenDoor", R_VOID, {R_OBJECT}, &routine::actionOpenDoor);
     add("ActionCloseDoor", R_VOID, {R_OBJECT}, &routine::actionCloseDoor);
     add("SetCameraFacing", R_VOID, {R_FLOAT}, &routine::unsupported);
@@ -217,7 +234,7 @@ void Routines::initForKotOR() {
     add("EffectMovementSpeedIncrease", R_EFFECT, {R_INT}, &routine::effectMovementSpeedIncrease);
     add("GetHitDice", R_INT, {R_OBJECT}, &routine::getHitDice);
     add("ActionForceFollowObject", R_VOID, {R_OBJECT, R_FLOAT}, &routine::unsupported);
-    add("GetTag", R_STRING, {R_OBJECT}, &routine::getTag);
+    add("GetTag", &routine::getTag);
     add("ResistForce", R_INT, {R_OBJECT, R_OBJECT}, &routine::resistForce);
     add("GetEffectType", R_INT, {R_EFFECT}, &routine::getEffectType, Variable::ofInt(static_cast<int>(EffectType::Invalid)));
     add("EffectAreaOfEffect", R_EFFECT, {R_INT, R_STRING, R_STRING, R_STRING}, &routine::unsupported);
@@ -249,7 +266,7 @@ void Routines::initForKotOR() {
     add("GetWaypointByTag", R_OBJECT, {R_STRING}, &routine::getWaypointByTag);
     add("GetTransitionTarget", R_OBJECT, {R_OBJECT}, &routine::unsupported);
     add("EffectLinkEffects", R_EFFECT, {R_EFFECT, R_EFFECT}, &routine::effectLinkEffects);
-    add("GetObjectByTag", R_OBJECT, {R_STRING, R_INT}, &routine::getObjectByTag);
+    add("GetObjectByTag", &routine::getObjectByTag);
     add("AdjustAlignment", R_VOID, {R_OBJECT, R_INT, R_INT}, &routine::adjustAlignment);
     add("ActionWait", R_VOID, {R_FLOAT}, &routine::actionWait);
     add("SetAreaTransitionBMP", R_VOID, {R_INT, R_STRING}, &routine::unsupported);
@@ -734,10 +751,10 @@ void Routines::initForKotOR() {
     add("EffectPsychicStatic", R_EFFECT, {}, &routine::effectPsychicStatic);
     add("PlayVisualAreaEffect", R_VOID, {R_INT, R_LOCATION}, &routine::playVisualAreaEffect);
     add("SetJournalQuestEntryPicture", R_VOID, {R_STRING, R_OBJECT, R_INT, R_INT, R_INT}, &routine::unsupported);
-    add("GetLocalBoolean", R_INT, {R_OBJECT, R_INT}, &routine::getLocalBoolean);
-    add("SetLocalBoolean", R_VOID, {R_OBJECT, R_INT, R_INT}, &routine::setLocalBoolean);
-    add("GetLocalNumber", R_INT, {R_OBJECT, R_INT}, &routine::getLocalNumber);
-    add("SetLocalNumber", R_VOID, {R_OBJECT, R_INT, R_INT}, &routine::setLocalNumber);
+    add("GetLocalBoolean", &routine::getLocalBoolean);
+    add("SetLocalBoolean", &routine::setLocalBoolean);
+    add("GetLocalNumber", &routine::getLocalNumber);
+    add("SetLocalNumber", &routine::setLocalNumber);
 
     add("SWMG_GetSoundFrequency", R_INT, {R_OBJECT, R_INT}, &routine::unsupported);
     add("SWMG_SetSoundFrequency", R_VOID, {R_OBJECT, R_INT, R_INT}, &routine::unsupported);
@@ -875,8 +892,8 @@ void Routines::initForTSL() {
     add("GetNearestCreature", R_OBJECT, {R_INT, R_INT, R_OBJECT, R_INT, R_INT, R_INT, R_INT, R_INT}, &routine::getNearestCreature);
     add("ActionSpeakString", R_VOID, {R_STRING, R_INT}, &routine::unsupported);
     add("ActionPlayAnimation", R_VOID, {R_INT, R_FLOAT, R_FLOAT}, &routine::actionPlayAnimation);
-    add("GetDistanceToObject", R_FLOAT, {R_OBJECT}, &routine::getDistanceToObject);
-    add("GetIsObjectValid", R_INT, {R_OBJECT}, &routine::getIsObjectValid);
+    add("GetDistanceToObject", &routine::getDistanceToObject);
+    add("GetIsObjectValid", &routine::getIsObjectValid);
     add("ActionOpenDoor", R_VOID, {R_OBJECT}, &routine::actionOpenDoor);
     add("ActionCloseDoor", R_VOID, {R_OBJECT}, &routine::actionCloseDoor);
     add("SetCameraFacing", R_VOID, {R_FLOAT}, &routine::unsupported);
@@ -1002,7 +1019,7 @@ void Routines::initForTSL() {
     add("EffectMovementSpeedIncrease", R_EFFECT, {R_INT}, &routine::effectMovementSpeedIncrease);
     add("GetHitDice", R_INT, {R_OBJECT}, &routine::getHitDice);
     add("ActionForceFollowObject", R_VOID, {R_OBJECT, R_FLOAT}, &routine::unsupported);
-    add("GetTag", R_STRING, {R_OBJECT}, &routine::getTag);
+    add("GetTag", &routine::getTag);
     add("ResistForce", R_INT, {R_OBJECT, R_OBJECT}, &routine::resistForce);
     add("GetEffectType", R_INT, {R_EFFECT}, &routine::getEffectType, Variable::ofInt(static_cast<int>(EffectType::Invalid)));
     add("EffectAreaOfEffect", R_EFFECT, {R_INT, R_STRING, R_STRING, R_STRING}, &routine::unsupported);
@@ -1034,7 +1051,7 @@ void Routines::initForTSL() {
     add("GetWaypointByTag", R_OBJECT, {R_STRING}, &routine::getWaypointByTag);
     add("GetTransitionTarget", R_OBJECT, {R_OBJECT}, &routine::unsupported);
     add("EffectLinkEffects", R_EFFECT, {R_EFFECT, R_EFFECT}, &routine::effectLinkEffects);
-    add("GetObjectByTag", R_OBJECT, {R_STRING, R_INT}, &routine::getObjectByTag);
+    add("GetObjectByTag", &routine::getObjectByTag);
     add("AdjustAlignment", R_VOID, {R_OBJECT, R_INT, R_INT, R_INT}, &routine::adjustAlignment);
     add("ActionWait", R_VOID, {R_FLOAT}, &routine::actionWait);
     add("SetAreaTransitionBMP", R_VOID, {R_INT, R_STRING}, &routine::unsupported);
@@ -1519,10 +1536,10 @@ void Routines::initForTSL() {
     add("EffectPsychicStatic", R_EFFECT, {}, &routine::effectPsychicStatic);
     add("PlayVisualAreaEffect", R_VOID, {R_INT, R_LOCATION}, &routine::playVisualAreaEffect);
     add("SetJournalQuestEntryPicture", R_VOID, {R_STRING, R_OBJECT, R_INT, R_INT, R_INT}, &routine::unsupported);
-    add("GetLocalBoolean", R_INT, {R_OBJECT, R_INT}, &routine::getLocalBoolean);
-    add("SetLocalBoolean", R_VOID, {R_OBJECT, R_INT, R_INT}, &routine::setLocalBoolean);
-    add("GetLocalNumber", R_INT, {R_OBJECT, R_INT}, &routine::getLocalNumber);
-    add("SetLocalNumber", R_VOID, {R_OBJECT, R_INT, R_INT}, &routine::setLocalNumber);
+    add("GetLocalBoolean", &routine::getLocalBoolean);
+    add("SetLocalBoolean", &routine::setLocalBoolean);
+    add("GetLocalNumber", &routine::getLocalNumber);
+    add("SetLocalNumber", &routine::setLocalNumber);
 
     add("SWMG_GetSoundFrequency", R_INT, {R_OBJECT, R_INT}, &routine::unsupported);
     add("SWMG_SetSoundFrequency", R_VOID, {R_OBJECT, R_INT, R_INT}, &routine::unsupported);
@@ -1755,23 +1772,10 @@ void Routines::add(
     vector<VariableType> argTypes,
     Variable (*fn)(const vector<Variable> &args, const RoutineContext &ctx)) {
 
-    Variable defRetValue;
-    defRetValue.type = retType;
-    switch (retType) {
-    case VariableType::Float:
-        defRetValue.floatValue = -1.0f;
-        break;
-    case VariableType::Object:
-        defRetValue.objectId = kObjectInvalid;
-        break;
-    default:
-        break;
-    }
-
     _routines.emplace_back(
         move(name),
         retType,
-        move(defRetValue),
+        getDefaultReturnValue(retType),
         move(argTypes),
         [this, fn](auto &args, auto &execution) {
             RoutineContext ctx(*_game, *_services, execution);
@@ -1797,6 +1801,25 @@ void Routines::add(
         });
 }
 
+template <class R, class... Args>
+void Routines::add(string name, R (*fn)(const RoutineContext &ctx, Args...)) {
+    VariableType retType = getRoutineReturnType(fn);
+
+    _routines.emplace_back(
+        move(name),
+        retType,
+        getDefaultReturnValue(retType),
+        getRoutineArgumentTypes(fn),
+        [this, fn](auto &args, auto &execution) {
+            RoutineContext ctx(*_game, *_services, execution);
+            return invokeTypedRoutine(fn, ctx, args);
+        },
+        [this, fn](auto &stack, auto &execution) {
+            RoutineContext ctx(*_game, *_services, execution);
+            invokeTypedRoutine(fn, ctx, stack);
+        });
+}
+
 } // namespace kotor
 
 } // namespace reone
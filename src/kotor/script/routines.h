@@ -69,6 +69,13 @@ private:
         std::vector<script::VariableType> argTypes,
         script::Variable (*fn)(const std::vector<script::Variable> &args, const RoutineContext &ctx),
         script::Variable defRetValue);
+
+    /**
+     * Adds a typed routine, deducing its argument and return types from the
+     * signature of fn.
+     */
+    template <class R, class... Args>
+    void add(std::string name, R (*fn)(const RoutineContext &ctx, Args...));
 };
 
 } // namespace kotor
@@ -28,12 +28,115 @@ namespace resource {
 
 static constexpr char kCellValueDeleted[] = "****";
 
+/**
+ * Only accepts integers written the way to_string would, so that cell value
+ * can be restored from the parsed integer.
+ */
+static bool parseInt(const string &value, int &result) {
+    const char *begin = value.c_str();
+    char *end = nullptr;
+    errno = 0;
+    long l = strtol(begin, &end, 10);
+    if (end != begin + value.size() || errno == ERANGE || l < INT_MIN || l > INT_MAX) {
+        return false;
+    }
+    result = static_cast<int>(l);
+    return to_string(result) == value;
+}
+
+static bool parseFloat(const string &value, float &result) {
+    const char *begin = value.c_str();
+    char *end = nullptr;
+    errno = 0;
+    float f = strtof(begin, &end);
+    if (end != begin + value.size() || errno == ERANGE) {
+        return false;
+    }
+    result = f;
+    return true;
+}
+
+/**
+ * Accepts the same values as stoi with base 16.
+ */
+static bool parseHex(const string &value, uint32_t &result) {
+    const char *begin = value.c_str();
+    char *end = nullptr;
+    errno = 0;
+    long l = strtol(begin, &end, 16);
+    if (end == begin || errno == ERANGE || l < INT_MIN || l > INT_MAX) {
+        return false;
+    }
+    result = static_cast<uint32_t>(l);
+    return true;
+}
+
 void TwoDA::addColumn(string name) {
+    int columnIdx = static_cast<int>(_columns.size());
+    _columnIdxByName.insert(make_pair(name, columnIdx)); // first column with this name wins
     _columns.push_back(move(name));
+    _typedColumns.push_back(TypedColumn());
+
+    for (int i = 0; i < _rowCount; ++i) {
+        appendCell(columnIdx, kCellValueDeleted);
+    }
+
+    invalidateLazyColumns();
 }
 
 void TwoDA::add(Row row) {
-    _rows.push_back(move(row));
+    if (row.values.size() < _columns.size()) {
+        row.values.resize(_columns.size(), kCellValueDeleted);
+    }
+    for (int i = 0; i < getColumnCount(); ++i) {
+        appendCell(i, move(row.values[i]));
+    }
+    ++_rowCount;
+
+    invalidateLazyColumns();
+}
+
+void TwoDA::appendCell(int columnIdx, string value) {
+    TypedColumn &column = _typedColumns[columnIdx];
+    bool null = value == kCellValueDeleted;
+    bool empty = value.empty();
+    column.nulls.push_back(null);
+    column.empties.push_back(empty);
+
+    if (column.type == ColumnType::Int) {
+        TypedValue typed;
+        if (null || empty || parseInt(value, typed.intValue)) {
+            column.values.push_back(typed);
+            return;
+        }
+        // Cell text can no longer be restored from integers, widen to Float
+        // and keep text of previous cells
+        size_t prevCount = column.values.size();
+        column.strings.reserve(column.values.capacity());
+        for (size_t i = 0; i < prevCount; ++i) {
+            column.strings.push_back(getCellValue(static_cast<int>(i), columnIdx));
+            column.values[i].floatValue = static_cast<float>(column.values[i].intValue);
+        }
+        column.type = ColumnType::Float;
+    }
+    if (column.type == ColumnType::Float) {
+        column.strings.push_back(move(value));
+        column.values.push_back(TypedValue());
+        if (null || empty || parseFloat(column.strings.back(), column.values.back().floatValue)) {
+            return;
+        }
+        column.type = ColumnType::String;
+        column.values.clear();
+        column.values.shrink_to_fit();
+        return;
+    }
+    column.strings.push_back(move(value));
+}
+
+void TwoDA::invalidateLazyColumns() {
+    lock_guard<mutex> lock(_lazyColumnsMutex);
+    _valueIndexes.clear();
+    _hexColumns.clear();
 }
 
 int TwoDA::indexByCellValue(const string &column, const string &value) const {
@@ -42,20 +145,57 @@ int TwoDA::indexByCellValue(const string &column, const string &value) const {
         warn("2DA: column not found: " + column);
         return -1;
     }
-    for (size_t i = 0; i < _rows.size(); ++i) {
-        if (_rows[i].values[columnIdx] == value)
-            return static_cast<int>(i);
+    shared_ptr<const ValueIndex> index(getValueIndex(columnIdx));
+    auto maybeRows = index->find(value);
+
+    return maybeRows != index->end() ? maybeRows->second.front() : -1;
+}
+
+shared_ptr<const TwoDA::ValueIndex> TwoDA::getValueIndex(int columnIdx) const {
+    lock_guard<mutex> lock(_lazyColumnsMutex);
+
+    auto maybeIndex = _valueIndexes.find(columnIdx);
+    if (maybeIndex != _valueIndexes.end()) {
+        return maybeIndex->second;
+    }
+    auto index = make_shared<ValueIndex>();
+    for (int i = 0; i < _rowCount; ++i) {
+        (*index)[getCellValue(i, columnIdx)].push_back(i);
     }
+    _valueIndexes.insert(make_pair(columnIdx, index));
 
-    return -1;
+    return index;
 }
 
-int TwoDA::getColumnIndex(const string &column) const {
-    for (size_t i = 0; i < _columns.size(); ++i) {
-        if (_columns[i] == column)
-            return static_cast<int>(i);
+shared_ptr<const TwoDA::HexColumn> TwoDA::getHexColumn(int columnIdx) const {
+    lock_guard<mutex> lock(_lazyColumnsMutex);
+
+    auto maybeColumn = _hexColumns.find(columnIdx);
+    if (maybeColumn != _hexColumns.end()) {
+        return maybeColumn->second;
     }
-    return -1;
+    auto column = make_shared<HexColumn>();
+    column->values.resize(_rowCount);
+    column->valid.resize(_rowCount);
+    for (int i = 0; i < _rowCount; ++i) {
+        uint32_t value = 0;
+        column->valid[i] = parseHex(getCellValue(i, columnIdx), value);
+        column->values[i] = value;
+    }
+    _hexColumns.insert(make_pair(columnIdx, column));
+
+    return column;
+}
+
+int TwoDA::getColumnIndex(const string &column) const {
+    auto maybeIdx = _columnIdxByName.find(column);
+    return maybeIdx != _columnIdxByName.end() ? maybeIdx->second : -1;
+}
+
+TwoDA::ColumnRef TwoDA::getColumn(const string &column) const {
+    ColumnRef ref;
+    ref.index = getColumnIndex(column);
+    return ref;
 }
 
 static vector<string> getColumnNames(const vector<pair<string, string>> &values) {
@@ -63,20 +203,29 @@ static vector<string> getColumnNames(const vector<pair<string, string>> &values)
 }
 
 int TwoDA::indexByCellValues(const vector<pair<string, string>> &values) const {
+    if (values.empty()) {
+        return _rowCount == 0 ? -1 : 0;
+    }
     vector<string> columns(getColumnNames(values));
     vector<int> columnIndices(getColumnIndices(columns));
 
-    for (size_t i = 0; i < _rows.size(); ++i) {
+    // Candidate rows are those matching the first value, in ascending order
+    shared_ptr<const ValueIndex> index(getValueIndex(columnIndices[0]));
+    auto maybeRows = index->find(values[0].second);
+    if (maybeRows == index->end()) {
+        return -1;
+    }
+    for (int row : maybeRows->second) {
         bool match = true;
-        for (size_t j = 0; j < values.size(); ++j) {
+        for (size_t j = 1; j < values.size(); ++j) {
             int columnIdx = columnIndices[j];
-            if (_rows[i].values[columnIdx] != values[j].second) {
+            if (getCellValue(row, columnIdx) != values[j].second) {
                 match = false;
                 break;
             }
         }
         if (match)
-            return static_cast<int>(i);
+            return row;
     }
 
     return -1;
@@ -91,61 +240,151 @@ vector<int> TwoDA::getColumnIndices(const vector<string> &columns) const {
         }
         indices.push_back(index);
     }
-    return move(indices);
+    return indices;
 }
 
-string TwoDA::getString(int row, const string &column, string defValue) const {
-    if (row < 0 || row >= _rows.size()) {
+string TwoDA::getCellValue(int row, int columnIdx) const {
+    const TypedColumn &column = _typedColumns[columnIdx];
+    if (column.type != ColumnType::Int)
+        return column.strings[row];
+
+    if (column.nulls[row])
+        return kCellValueDeleted;
+
+    if (column.empties[row])
+        return "";
+
+    return to_string(column.values[row].intValue);
+}
+
+size_t TwoDA::getByteSize() const {
+    size_t size = sizeof(TwoDA);
+    for (auto &column : _columns) {
+        size += sizeof(string) + column.capacity();
+    }
+    for (auto &column : _typedColumns) {
+        size += sizeof(TypedColumn);
+        size += column.values.capacity() * sizeof(TypedValue);
+        size += (column.nulls.capacity() + column.empties.capacity()) / 8;
+        for (auto &value : column.strings) {
+            size += sizeof(string) + value.capacity();
+        }
+    }
+    return size;
+}
+
+bool TwoDA::checkCell(int row, ColumnRef column) const {
+    if (row < 0 || row >= _rowCount) {
         warn("2DA: row index out of range: " + to_string(row));
-        return move(defValue);
+        return false;
+    }
+    if (!column) {
+        warn("2DA: column not found");
+        return false;
+    }
+    if (column.index < 0 || column.index >= getColumnCount()) {
+        warn("2DA: column index out of range: " + to_string(column.index));
+        return false;
+    }
+    if (_typedColumns[column.index].nulls[row]) {
+        warn(boost::format("2DA: cell value was deleted: %d %s") % row % _columns[column.index]);
+        return false;
     }
+    return true;
+}
 
-    int columnIdx = getColumnIndex(column);
-    if (columnIdx == -1) {
+string TwoDA::getString(int row, const string &column, string defValue) const {
+    ColumnRef ref(getColumn(column));
+    if (!ref) {
         warn("2DA: column not found: " + column);
-        return move(defValue);
+        return defValue;
     }
+    return getString(row, ref, move(defValue));
+}
 
-    const string &value = _rows[row].values[columnIdx];
+int TwoDA::getInt(int row, const string &column, int defValue) const {
+    ColumnRef ref(getColumn(column));
+    if (!ref) {
+        warn("2DA: column not found: " + column);
+        return defValue;
+    }
+    return getInt(row, ref, defValue);
+}
 
-    if (value == kCellValueDeleted) {
-        warn(boost::format("2DA: cell value was deleted: %d %s") % row % column);
-        return move(defValue);
+uint32_t TwoDA::getUint(int row, const string &column, uint32_t defValue) const {
+    ColumnRef ref(getColumn(column));
+    if (!ref) {
+        warn("2DA: column not found: " + column);
+        return defValue;
+    }
+    return getUint(row, ref, defValue);
+}
+
+float TwoDA::getFloat(int row, const string &column, float defValue) const {
+    ColumnRef ref(getColumn(column));
+    if (!ref) {
+        warn("2DA: column not found: " + column);
+        return defValue;
     }
+    return getFloat(row, ref, defValue);
+}
 
-    return value;
+bool TwoDA::getBool(int row, const string &column, bool defValue) const {
+    return getInt(row, column, defValue ? 1 : 0) != 0;
 }
 
-int TwoDA::getInt(int row, const string &column, int defValue) const {
-    const string &value = getString(row, column);
-    if (value.empty())
+string TwoDA::getString(int row, ColumnRef column, string defValue) const {
+    if (!checkCell(row, column))
         return defValue;
 
-    return stoi(value);
+    return getCellValue(row, column.index);
 }
 
-uint32_t TwoDA::getUint(int row, const string &column, uint32_t defValue) const {
-    const string &value = getString(row, column);
-    if (value.empty())
+int TwoDA::getInt(int row, ColumnRef column, int defValue) const {
+    if (!checkCell(row, column))
         return defValue;
 
-    return stoi(value, nullptr, 16);
+    const TypedColumn &typedColumn = _typedColumns[column.index];
+    if (typedColumn.empties[row])
+        return defValue;
+
+    if (typedColumn.type == ColumnType::Int)
+        return typedColumn.values[row].intValue;
+
+    return stoi(typedColumn.strings[row]); // throws on malformed values
 }
 
-float TwoDA::getFloat(int row, const string &column, float defValue) const {
-    const string &value = getString(row, column);
-    if (value.empty())
+uint32_t TwoDA::getUint(int row, ColumnRef column, uint32_t defValue) const {
+    if (!checkCell(row, column) || _typedColumns[column.index].empties[row])
         return defValue;
 
-    return stof(value);
+    shared_ptr<const HexColumn> hexColumn(getHexColumn(column.index));
+    if (hexColumn->valid[row])
+        return hexColumn->values[row];
+
+    return stoi(getCellValue(row, column.index), nullptr, 16); // throws on malformed values
 }
 
-bool TwoDA::getBool(int row, const string &column, bool defValue) const {
-    const string &value = getString(row, column);
-    if (value.empty())
+float TwoDA::getFloat(int row, ColumnRef column, float defValue) const {
+    if (!checkCell(row, column))
         return defValue;
 
-    return stoi(value) != 0;
+    const TypedColumn &typedColumn = _typedColumns[column.index];
+    if (typedColumn.empties[row])
+        return defValue;
+
+    switch (typedColumn.type) {
+    case ColumnType::Int:
+        return static_cast<float>(typedColumn.values[row].intValue);
+    case ColumnType::Float:
+        return typedColumn.values[row].floatValue;
+    default:
+        return stof(typedColumn.strings[row]); // throws on malformed values
+    }
+}
+
+bool TwoDA::getBool(int row, ColumnRef column, bool defValue) const {
+    return getInt(row, column, defValue ? 1 : 0) != 0;
 }
 
 } // namespace resource
@@ -25,6 +25,12 @@ class TwoDaReader;
 
 /**
  * Two-dimensional array, similar to a database table.
+ *
+ * Cells are stored by column, parsed once when rows are added. Column type
+ * is the narrowest type that all cell values of a column parse as: Int
+ * columns only store integers, Float columns store floats alongside cell
+ * text, and String columns only store text. Columns can be resolved to a
+ * ColumnRef once and then used in accessors, skipping name lookups.
  */
 class TwoDA : boost::noncopyable {
 public:
@@ -32,6 +38,15 @@ public:
         std::vector<std::string> values;
     };
 
+    /**
+     * Handle to a 2DA column, valid for the lifetime of the 2DA it was obtained from.
+     */
+    struct ColumnRef {
+        int index {-1};
+
+        explicit operator bool() const { return index != -1; }
+    };
+
     void addColumn(std::string name);
     void add(Row row);
 
@@ -45,8 +60,13 @@ public:
      */
     int indexByCellValues(const std::vector<std::pair<std::string, std::string>> &values) const;
 
+    /**
+     * @return reference to the column with the specified name, or an invalid reference if not found
+     */
+    ColumnRef getColumn(const std::string &column) const;
+
     int getColumnCount() const { return static_cast<int>(_columns.size()); }
-    int getRowCount() const { return static_cast<int>(_rows.size()); }
+    int getRowCount() const { return _rowCount; }
 
     std::string getString(int row, const std::string &column, std::string defValue = "") const;
     int getInt(int row, const std::string &column, int defValue = 0) const;
@@ -54,16 +74,87 @@ public:
     float getFloat(int row, const std::string &column, float defValue = 0.0f) const;
     bool getBool(int row, const std::string &column, bool defValue = false) const;
 
+    std::string getString(int row, ColumnRef column, std::string defValue = "") const;
+    int getInt(int row, ColumnRef column, int defValue = 0) const;
+    uint32_t getUint(int row, ColumnRef column, uint32_t defValue = 0) const;
+    float getFloat(int row, ColumnRef column, float defValue = 0.0f) const;
+    bool getBool(int row, ColumnRef column, bool defValue = false) const;
+
+    /**
+     * @return cell value as read, including deleted values
+     */
+    std::string getCellValue(int row, int columnIdx) const;
+
+    /**
+     * @return approximate size of this 2DA in memory, in bytes
+     */
+    size_t getByteSize() const;
+
     const std::vector<std::string> &columns() const { return _columns; }
-    const std::vector<Row> &rows() const { return _rows; }
 
 private:
+    enum class ColumnType {
+        Int,
+        Float,
+        String
+    };
+
+    union TypedValue {
+        int intValue {0};
+        float floatValue;
+    };
+
+    struct TypedColumn {
+        ColumnType type {ColumnType::Int};
+        std::vector<TypedValue> values;   /**< empty for String columns */
+        std::vector<std::string> strings; /**< empty for Int columns, whose text is implied by values */
+        std::vector<bool> nulls;          /**< cell value is "****" */
+        std::vector<bool> empties;        /**< cell value is empty */
+    };
+
+    struct HexColumn {
+        std::vector<uint32_t> values;
+        std::vector<bool> valid; /**< cell value was parsed as a hexadecimal integer */
+    };
+
+    typedef std::unordered_map<std::string, std::vector<int>> ValueIndex;
+
     std::vector<std::string> _columns;
-    std::vector<Row> _rows;
+    std::vector<TypedColumn> _typedColumns;
+    std::unordered_map<std::string, int> _columnIdxByName;
+    int _rowCount {0};
+
+    // Secondary indexes and hexadecimal columns are built lazily, by column index
+    mutable std::unordered_map<int, std::shared_ptr<const ValueIndex>> _valueIndexes;
+    mutable std::unordered_map<int, std::shared_ptr<const HexColumn>> _hexColumns;
+    mutable std::mutex _lazyColumnsMutex;
 
     int getColumnIndex(const std::string &column) const;
     std::vector<int> getColumnIndices(const std::vector<std::string> &columns) const;
 
+    /**
+     * Appends a cell to the column, widening the column type if the cell
+     * value does not parse as it.
+     */
+    void appendCell(int columnIdx, std::string value);
+
+    void invalidateLazyColumns();
+
+    /**
+     * @return true if cell is within range and its value was not deleted, false otherwise
+     */
+    bool checkCell(int row, ColumnRef column) const;
+
+    /**
+     * @return index of rows by cell value of the column, which remains valid after rows are added
+     */
+    std::shared_ptr<const ValueIndex> getValueIndex(int columnIdx) const;
+
+    /**
+     * @return cell values of the column, parsed as hexadecimal integers
+     */
+    std::shared_ptr<const HexColumn> getHexColumn(int columnIdx) const;
+
     friend class TwoDaReader;
 };
 
@@ -17,8 +17,6 @@
 
 #include "2das.h"
 
-#include "../common/streamutil.h"
-
 #include "format/2dareader.h"
 #include "resources.h"
 
@@ -29,18 +27,30 @@ namespace reone {
 
 namespace resource {
 
+static constexpr size_t kCacheByteBudget = 32 * 1024 * 1024;
+
+static size_t getTwoDaSize(const TwoDA &twoDa) {
+    return twoDa.getByteSize();
+}
+
 TwoDas::TwoDas(Resources &resources) :
     MemoryCache(bind(&TwoDas::doGet, this, _1)),
     _resources(resources) {
+
+    CachePolicy<string, TwoDA> policy;
+    policy.byteBudget = kCacheByteBudget;
+    policy.sizeOf = &getTwoDaSize;
+    policy.retain = [this](const string &resRef) { return !_resources.isTransient(resRef, ResourceType::TwoDa); };
+    setPolicy(move(policy));
 }
 
 shared_ptr<TwoDA> TwoDas::doGet(const string &resRef) {
-    auto raw = _resources.get(resRef, ResourceType::TwoDa);
+    ByteView raw(_resources.getView(resRef, ResourceType::TwoDa));
     if (!raw) {
         return nullptr;
     }
     TwoDaReader twoDa;
-    twoDa.load(wrap(raw));
+    twoDa.load(move(raw));
     return twoDa.twoDa();
 }
 
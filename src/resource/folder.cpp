@@ -49,26 +49,30 @@ void Folder::loadDirectory(const fs::path &path) {
         string ext(childPath.extension().string().substr(1));
         boost::to_lower(ext);
 
-        Resource res;
-        res.path = childPath;
-        res.type = getResTypeByExt(ext);
-
-        _resources.insert(make_pair(resRef, res));
+        ResourceId id(move(resRef), getResTypeByExt(ext));
+        auto inserted = _resIdxByResId.insert(make_pair(move(id), static_cast<int>(_resources.size())));
+        if (inserted.second) {
+            _resources.push_back(childPath);
+        }
     }
 }
 
 shared_ptr<ByteArray> Folder::find(const ResourceId &id) {
-    fs::path path;
-    for (auto &res : _resources) {
-        if (res.first == id.resRef && res.second.type == id.type) {
-            path = res.second.path;
-            break;
-        }
-    }
-    if (path.empty()) {
+    auto maybeIdx = _resIdxByResId.find(id);
+    if (maybeIdx == _resIdxByResId.end()) {
         return shared_ptr<ByteArray>();
     }
-    fs::ifstream in(path, ios::binary);
+    return readEntry(maybeIdx->second);
+}
+
+void Folder::forEachEntry(const function<void(const ResourceId &, int)> &fn) const {
+    for (auto &pair : _resIdxByResId) {
+        fn(pair.first, pair.second);
+    }
+}
+
+shared_ptr<ByteArray> Folder::readEntry(int entryIdx) {
+    fs::ifstream in(_resources[entryIdx], ios::binary);
 
     in.seekg(0, ios::end);
     size_t size = in.tellg();
@@ -19,6 +19,7 @@
 
 #include "../common/types.h"
 
+#include "id.h"
 #include "resourceprovider.h"
 #include "types.h"
 
@@ -36,18 +37,17 @@ public:
 
     std::shared_ptr<ByteArray> find(const ResourceId &id) override;
 
+    void forEachEntry(const std::function<void(const ResourceId &, int)> &fn) const override;
+    std::shared_ptr<ByteArray> readEntry(int entryIdx) override;
+
     int getId() const override { return _id; }
 
 private:
-    struct Resource {
-        boost::filesystem::path path;
-        ResourceType type;
-    };
-
     int _id;
 
     boost::filesystem::path _path;
-    std::multimap<std::string, Resource> _resources;
+    std::vector<boost::filesystem::path> _resources;
+    std::unordered_map<ResourceId, int, ResourceIdHasher> _resIdxByResId;
 
     void loadDirectory(const boost::filesystem::path &path);
 };
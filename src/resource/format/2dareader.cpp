@@ -47,7 +47,7 @@ void TwoDaReader::doLoad() {
 void TwoDaReader::loadHeaders() {
     string token;
     while (readToken(token)) {
-        _twoDa->_columns.push_back(token);
+        _twoDa->addColumn(token);
     }
 }
 
@@ -55,10 +55,10 @@ bool TwoDaReader::readToken(string &token) {
     size_t pos = tell();
 
     char buf[256];
-    streamsize chRead = _in->rdbuf()->sgetn(buf, sizeof(buf));
+    size_t chRead = _reader->read(buf, sizeof(buf));
     const char *pch = buf;
 
-    for (; pch - buf < chRead; ++pch) {
+    for (; static_cast<size_t>(pch - buf) < chRead; ++pch) {
         if (*pch == '\0') {
             seek(pos + pch - buf + 1);
             return false;
@@ -82,7 +82,11 @@ void TwoDaReader::loadLabels() {
 }
 
 void TwoDaReader::loadRows() {
-    _twoDa->_rows.reserve(_rowCount);
+    for (auto &column : _twoDa->_typedColumns) {
+        column.values.reserve(_rowCount);
+        column.nulls.reserve(_rowCount);
+        column.empties.reserve(_rowCount);
+    }
 
     int columnCount = static_cast<int>(_twoDa->_columns.size());
     int cellCount = _rowCount * columnCount;
@@ -101,7 +105,7 @@ void TwoDaReader::loadRows() {
             size_t off = pos + offsets[cellIdx];
             row.values.push_back(readCStringAt(off));
         }
-        _twoDa->_rows.push_back(row);
+        _twoDa->add(move(row));
     }
 }
 
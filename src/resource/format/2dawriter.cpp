@@ -69,7 +69,7 @@ void TwoDaWriter::writeData() {
 
     for (int i = 0; i < _twoDa->getRowCount(); ++i) {
         for (size_t j = 0; j < columnCount; ++j) {
-            const string &value = _twoDa->rows()[i].values[j];
+            string value(_twoDa->getCellValue(i, static_cast<int>(j)));
             auto maybeData = find_if(data.begin(), data.end(), [&](auto &pair) { return pair.first == value; });
             if (maybeData != data.end()) {
                 _writer->putUint16(maybeData->second);
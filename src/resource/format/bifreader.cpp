@@ -36,29 +36,36 @@ void BifReader::doLoad() {
     _resourceCount = readUint32();
     ignore(4);
     _tableOffset = readUint32();
+
+    loadResourceEntries();
 }
 
-unique_ptr<ByteArray> BifReader::getResourceData(int idx) {
-    if (idx >= _resourceCount) {
-        throw out_of_range("BIF: resource index out of range: " + to_string(idx));
+void BifReader::loadResourceEntries() {
+    static constexpr int kValuesPerEntry = 4; // id, offset, file size, type
+
+    vector<uint32_t> values(readUint32Array(_tableOffset, kValuesPerEntry * _resourceCount));
+    _entries.resize(_resourceCount);
+    for (int i = 0; i < _resourceCount; ++i) {
+        _entries[i].offset = values[kValuesPerEntry * i + 1];
+        _entries[i].fileSize = values[kValuesPerEntry * i + 2];
     }
-    ResourceEntry entry(readResourceEntry(idx));
+}
 
+unique_ptr<ByteArray> BifReader::getResourceData(int idx) {
+    const ResourceEntry &entry = getResourceEntry(idx);
     return make_unique<ByteArray>(readBytes(entry.offset, entry.fileSize));
 }
 
-BifReader::ResourceEntry BifReader::readResourceEntry(int idx) {
-    seek(_tableOffset + 16 * idx);
-
-    ignore(4);
-    uint32_t offset = readUint32();
-    uint32_t fileSize = readUint32();
-
-    ResourceEntry entry;
-    entry.offset = offset;
-    entry.fileSize = fileSize;
+ByteView BifReader::getResourceView(int idx) {
+    const ResourceEntry &entry = getResourceEntry(idx);
+    return readView(entry.offset, entry.fileSize);
+}
 
-    return move(entry);
+const BifReader::ResourceEntry &BifReader::getResourceEntry(int idx) const {
+    if (idx < 0 || idx >= _resourceCount) {
+        throw out_of_range("BIF: resource index out of range: " + to_string(idx));
+    }
+    return _entries[idx];
 }
 
 } // namespace resource
@@ -23,11 +23,15 @@ namespace reone {
 
 namespace resource {
 
+/**
+ * Reads BIF files. Once loaded, resource data can be read concurrently.
+ */
 class BifReader : public BinaryReader {
 public:
     BifReader();
 
     std::unique_ptr<ByteArray> getResourceData(int idx);
+    ByteView getResourceView(int idx);
 
 private:
     struct ResourceEntry {
@@ -37,9 +41,12 @@ private:
 
     int _resourceCount {0};
     uint32_t _tableOffset {0};
+    std::vector<ResourceEntry> _entries;
 
     void doLoad() override;
-    ResourceEntry readResourceEntry(int idx);
+    void loadResourceEntries();
+
+    const ResourceEntry &getResourceEntry(int idx) const;
 };
 
 } // namespace resource
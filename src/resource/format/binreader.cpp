@@ -17,7 +17,9 @@
 
 #include "binreader.h"
 
+#include "../../common/mappedfile.h"
 #include "../../common/streamreader.h"
+#include "../../common/streamutil.h"
 
 using namespace std;
 
@@ -50,6 +52,10 @@ void BinaryReader::load() {
 }
 
 void BinaryReader::querySize() {
+    if (_reader->isView()) {
+        _size = _reader->view().size;
+        return;
+    }
     _in->seekg(0, ios::end);
     _size = _in->tellg();
     _in->seekg(0);
@@ -60,7 +66,7 @@ void BinaryReader::checkSignature() {
         throw runtime_error("Invalid binary file size");
     }
     char buf[16];
-    _in->read(buf, _signSize);
+    _reader->read(buf, _signSize);
     if (!equal(_sign.begin(), _sign.end(), buf)) {
         throw runtime_error(str(boost::format("Invalid binary file signature: %s") % string(buf, _signSize)));
     }
@@ -70,13 +76,21 @@ void BinaryReader::load(fs::path path) {
     if (!fs::exists(path)) {
         throw runtime_error("File not found: " + path.string());
     }
-    _in = make_shared<fs::ifstream>(path, ios::binary);
-    _reader = make_unique<StreamReader>(_in, _endianess);
+    auto file = make_shared<MappedFile>(path);
+    _in.reset();
+    _reader = make_unique<StreamReader>(file->view(), _endianess);
     _path = path;
 
     load();
 }
 
+void BinaryReader::load(ByteView view) {
+    _in.reset();
+    _reader = make_unique<StreamReader>(move(view), _endianess);
+
+    load();
+}
+
 size_t BinaryReader::tell() const {
     return _reader->tell();
 }
@@ -162,6 +176,16 @@ ByteArray BinaryReader::readBytes(int count) {
 }
 
 ByteArray BinaryReader::readBytes(size_t off, int count) {
+    if (_reader->isView()) {
+        // Positional read, leaves the reader untouched
+        const ByteView &view = _reader->view();
+        size_t available = off < view.size ? min(static_cast<size_t>(count), view.size - off) : 0;
+        ByteArray result(count, '\0');
+        if (available > 0) {
+            memcpy(&result[0], view.data + off, available);
+        }
+        return move(result);
+    }
     size_t pos = _reader->tell();
     _reader->seek(off);
 
@@ -171,6 +195,13 @@ ByteArray BinaryReader::readBytes(size_t off, int count) {
     return move(result);
 }
 
+ByteView BinaryReader::readView(size_t off, size_t count) {
+    if (_reader->isView()) {
+        return _reader->view().slice(off, count);
+    }
+    return makeView(make_shared<ByteArray>(readBytes(off, static_cast<int>(count))));
+}
+
 } // namespace resource
 
 } // namespace reone
@@ -33,6 +33,7 @@ class BinaryReader : boost::noncopyable {
 public:
     void load(std::shared_ptr<std::istream> in);
     void load(boost::filesystem::path path);
+    void load(ByteView view);
 
 protected:
     boost::endian::order _endianess {boost::endian::order::little};
@@ -62,8 +63,32 @@ protected:
     std::string readString(int len);
     std::string readString(size_t off, int len);
     ByteArray readBytes(int count);
+
+    /**
+     * Reads bytes at the specified offset, restoring the read position. Safe
+     * for concurrent use if this file is memory-mapped.
+     */
     ByteArray readBytes(size_t off, int count);
 
+    /**
+     * @return view into the specified range of this file, without copying if
+     *         this file is memory-mapped
+     * @note safe for concurrent use if this file is memory-mapped
+     */
+    ByteView readView(size_t off, size_t count);
+
+    inline void readUint16Array(uint16_t *dest, int count) {
+        _reader->getUint16Array(dest, count);
+    }
+
+    inline void readUint32Array(uint32_t *dest, int count) {
+        _reader->getUint32Array(dest, count);
+    }
+
+    inline void readFloatArray(float *dest, int count) {
+        _reader->getFloatArray(dest, count);
+    }
+
     inline std::vector<uint16_t> readUint16Array(int count) {
         return _reader->getUint16Array(count);
     }
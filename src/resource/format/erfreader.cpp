@@ -45,8 +45,11 @@ void ErfReader::doLoad() {
     _keysOffset = readUint32();
     _resourcesOffset = readUint32();
 
-    loadKeys();
-    loadResources();
+    if (!loadFromIndexCache()) {
+        loadKeys();
+        loadResources();
+        saveToIndexCache();
+    }
 }
 
 void ErfReader::checkSignature() {
@@ -107,13 +110,93 @@ ErfReader::ResourceEntry ErfReader::readResourceEntry() {
     return move(res);
 }
 
-shared_ptr<ByteArray> ErfReader::find(const ResourceId &id) {
+bool ErfReader::loadFromIndexCache() {
+    if (!_indexCache || _path.empty()) {
+        return false;
+    }
+    _cachedIndex = _indexCache->load(_path, [this](auto &entry) {
+        return static_cast<uint64_t>(entry.values[0]) + entry.values[1] <= _size;
+    });
+    if (!_cachedIndex) {
+        return false;
+    }
+    _entryCount = _cachedIndex->entryCount();
+    _keys.reserve(_entryCount);
+    _resources.reserve(_entryCount);
+
+    for (int i = 0; i < _entryCount; ++i) {
+        const CachedIndex::Entry &entry = _cachedIndex->entry(i);
+
+        KeyEntry key;
+        key.resId = entry.resId();
+        _keys.push_back(move(key));
+
+        ResourceEntry res;
+        res.offset = entry.values[0];
+        res.size = entry.values[1];
+        _resources.push_back(move(res));
+    }
+
+    return true;
+}
+
+void ErfReader::saveToIndexCache() {
+    if (!_indexCache || _path.empty()) {
+        return;
+    }
+    vector<CachedIndex::Entry> entries;
+    entries.reserve(_resIdxByResId.size());
+    for (auto &pair : _resIdxByResId) {
+        const ResourceEntry &res = _resources[pair.second];
+        entries.push_back(IndexCache::makeEntry(pair.first, res.offset, res.size));
+    }
+    _indexCache->save(_path, move(entries));
+}
+
+int ErfReader::findEntryIdx(const ResourceId &id) const {
+    if (_cachedIndex) {
+        return _cachedIndex->find(id);
+    }
     auto maybeIdx = _resIdxByResId.find(id);
-    if (maybeIdx == _resIdxByResId.end()) {
+    return maybeIdx != _resIdxByResId.end() ? maybeIdx->second : -1;
+}
+
+shared_ptr<ByteArray> ErfReader::find(const ResourceId &id) {
+    int entryIdx = findEntryIdx(id);
+    if (entryIdx == -1) {
         return nullptr;
     }
-    const ResourceEntry &res = _resources[maybeIdx->second];
-    return make_shared<ByteArray>(getResourceData(res));
+    return readEntry(entryIdx);
+}
+
+ByteView ErfReader::findView(const ResourceId &id) {
+    int entryIdx = findEntryIdx(id);
+    if (entryIdx == -1) {
+        return ByteView();
+    }
+    return readEntryView(entryIdx);
+}
+
+void ErfReader::forEachEntry(const function<void(const ResourceId &, int)> &fn) const {
+    if (_cachedIndex) {
+        // Cached entries are unique by construction
+        for (int i = 0; i < _entryCount; ++i) {
+            fn(_keys[i].resId, i);
+        }
+        return;
+    }
+    for (auto &pair : _resIdxByResId) {
+        fn(pair.first, pair.second);
+    }
+}
+
+shared_ptr<ByteArray> ErfReader::readEntry(int entryIdx) {
+    return make_shared<ByteArray>(getResourceData(_resources[entryIdx]));
+}
+
+ByteView ErfReader::readEntryView(int entryIdx) {
+    const ResourceEntry &res = _resources[entryIdx];
+    return readView(res.offset, res.size);
 }
 
 ByteArray ErfReader::getResourceData(const ResourceEntry &res) {
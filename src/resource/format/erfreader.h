@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "../indexcache.h"
 #include "../resourceprovider.h"
 #include "../types.h"
 
@@ -40,6 +41,11 @@ public:
     ErfReader(int id = kDefaultProviderId);
 
     std::shared_ptr<ByteArray> find(const ResourceId &id) override;
+    ByteView findView(const ResourceId &id) override;
+
+    void forEachEntry(const std::function<void(const ResourceId &, int)> &fn) const override;
+    std::shared_ptr<ByteArray> readEntry(int entryIdx) override;
+    ByteView readEntryView(int entryIdx) override;
 
     int entryCount() const { return _entryCount; }
     const std::vector<KeyEntry> &keys() const { return _keys; }
@@ -47,8 +53,15 @@ public:
     int getId() const override { return _id; }
     ByteArray getResourceData(int idx);
 
+    /**
+     * Enables loading the key table from the index cache. Must be called before load.
+     */
+    void setIndexCache(IndexCache *cache) { _indexCache = cache; }
+
 private:
     int _id;
+    IndexCache *_indexCache {nullptr};
+    std::shared_ptr<CachedIndex> _cachedIndex;
 
     int _entryCount {0};
     uint32_t _keysOffset {0};
@@ -62,6 +75,10 @@ private:
     void checkSignature();
     void loadKeys();
     void loadResources();
+    bool loadFromIndexCache();
+    void saveToIndexCache();
+
+    int findEntryIdx(const ResourceId &id) const;
 
     KeyEntry readKeyEntry();
     ResourceEntry readResourceEntry();
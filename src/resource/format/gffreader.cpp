@@ -33,6 +33,18 @@ GffReader::GffReader() :
     BinaryReader(kSignatureSize) {
 }
 
+static constexpr int kStructSize = 12;
+static constexpr int kFieldSize = 12;
+static constexpr int kLabelSize = 16;
+
+template <class T, class U>
+static T bitCast(U val) {
+    static_assert(sizeof(T) == sizeof(U), "Size mismatch");
+    T result;
+    memcpy(&result, &val, sizeof(T));
+    return result;
+}
+
 void GffReader::doLoad() {
     _structOffset = readUint32();
     _structCount = readUint32();
@@ -46,40 +58,80 @@ void GffReader::doLoad() {
     _fieldIncidesCount = readUint32();
     _listIndicesOffset = readUint32();
     _listIndicesCount = readUint32();
-    _root = move(readStruct(0));
-}
 
-unique_ptr<GffStruct> GffReader::readStruct(int idx) {
-    seek(_structOffset + 12ll * idx);
+    if (_structCount == 0) {
+        throw runtime_error("GFF: no structs");
+    }
 
-    uint32_t type = readUint32();
-    uint32_t dataOffset = readUint32();
-    uint32_t fieldCount = readUint32();
+    // Mapped files are decoded in place, streams are read into memory once
+    _data = readView(0, _size);
 
-    auto gffs = make_unique<GffStruct>(type);
+    readLabels();
+    readStructs();
 
-    if (fieldCount == 1) {
-        gffs->_fields.push_back(readField(dataOffset));
-    } else {
-        vector<uint32_t> indices(readFieldIndices(dataOffset, fieldCount));
-        for (auto &idx : indices) {
-            gffs->_fields.push_back(readField(idx));
-        }
-    }
+    _root = getStruct(0);
+}
 
-    return move(gffs);
+void GffReader::readLabels() {
+    const char *labels = getData(_labelOffset, static_cast<size_t>(kLabelSize) * _labelCount);
+    _labels.reserve(_labelCount);
+    _labelHashes.reserve(_labelCount);
+    for (int i = 0; i < _labelCount; ++i) {
+        const char *label = labels + static_cast<size_t>(kLabelSize) * i;
+        _labels.push_back(string(label, strnlen(label, kLabelSize)));
+        _labelHashes.push_back(getGffLabelHash(_labels.back().c_str(), _labels.back().length()));
+    }
 }
 
-GffField GffReader::readField(int idx) {
-    seek(_fieldOffset + 12ll * idx);
+void GffReader::readStructs() {
+    getData(_structOffset, static_cast<size_t>(kStructSize) * _structCount);
+    getData(_fieldOffset, static_cast<size_t>(kFieldSize) * _fieldCount);
+
+    _structs = shared_ptr<GffStruct[]>(new GffStruct[_structCount]);
+
+    for (int i = 0; i < _structCount; ++i) {
+        size_t off = _structOffset + static_cast<size_t>(kStructSize) * i;
+        uint32_t type = getValue<uint32_t>(off);
+        uint32_t dataOffset = getValue<uint32_t>(off + 4);
+        uint32_t fieldCount = getValue<uint32_t>(off + 8);
+
+        GffStruct &gffs = _structs[i];
+        gffs._type = type;
+        gffs._arena = _structs;
+        gffs._fields.resize(fieldCount);
+        gffs._index.resize(fieldCount);
+
+        // Label hashes are computed once per file, rather than once per field
+        if (fieldCount == 1) {
+            gffs._index[0].hash = readField(dataOffset, gffs._fields[0]);
+        } else if (fieldCount > 1) {
+            size_t indicesOffset = static_cast<size_t>(_fieldIndicesOffset) + dataOffset;
+            getData(indicesOffset, 4ll * fieldCount);
+            for (uint32_t j = 0; j < fieldCount; ++j) {
+                gffs._index[j].hash = readField(getValue<uint32_t>(indicesOffset + 4ll * j), gffs._fields[j]);
+                gffs._index[j].fieldIdx = j;
+            }
+        }
+        gffs.sortIndex();
+    }
+}
 
-    uint32_t type = readUint32();
-    uint32_t labelIndex = readUint32();
-    uint32_t dataOrDataOffset = readUint32();
+uint32_t GffReader::readField(uint32_t idx, GffField &field) {
+    if (idx >= static_cast<uint32_t>(_fieldCount)) {
+        throw out_of_range("GFF: field index out of range: " + to_string(idx));
+    }
+    size_t off = _fieldOffset + static_cast<size_t>(kFieldSize) * idx;
+    uint32_t type = getValue<uint32_t>(off);
+    uint32_t labelIndex = getValue<uint32_t>(off + 4);
+    uint32_t dataOrDataOffset = getValue<uint32_t>(off + 8);
 
-    GffField field;
+    if (labelIndex >= _labels.size()) {
+        throw out_of_range("GFF: label index out of range: " + to_string(labelIndex));
+    }
     field.type = static_cast<GffFieldType>(type);
-    field.label = readLabel(labelIndex);
+    field.label = _labels[labelIndex];
+
+    size_t dataOffset = static_cast<size_t>(_fieldDataOffset) + dataOrDataOffset;
 
     switch (field.type) {
     case GffFieldType::Byte:
@@ -90,172 +142,113 @@ GffField GffReader::readField(int idx) {
     case GffFieldType::Char:
     case GffFieldType::Short:
     case GffFieldType::Int:
-        field.intValue = *reinterpret_cast<int *>(&dataOrDataOffset);
+        field.intValue = bitCast<int32_t>(dataOrDataOffset);
         break;
     case GffFieldType::Dword64:
-        field.uint64Value = readQWordFieldData(dataOrDataOffset);
+        field.uint64Value = getValue<uint64_t>(dataOffset);
         break;
-    case GffFieldType::Int64: {
-        uint64_t tmp = readQWordFieldData(dataOrDataOffset);
-        field.int64Value = *reinterpret_cast<int64_t *>(&tmp);
+    case GffFieldType::Int64:
+        field.int64Value = bitCast<int64_t>(getValue<uint64_t>(dataOffset));
         break;
-    }
     case GffFieldType::Float:
-        field.floatValue = *reinterpret_cast<float *>(&dataOrDataOffset);
+        field.floatValue = bitCast<float>(dataOrDataOffset);
         break;
-    case GffFieldType::Double: {
-        uint64_t tmp = readQWordFieldData(dataOrDataOffset);
-        field.doubleValue = *reinterpret_cast<double *>(&tmp);
+    case GffFieldType::Double:
+        field.doubleValue = bitCast<double>(getValue<uint64_t>(dataOffset));
         break;
-    }
-    case GffFieldType::CExoString:
-        field.strValue = readStringFieldData(dataOrDataOffset);
+    case GffFieldType::CExoString: {
+        uint32_t size = getValue<uint32_t>(dataOffset);
+        field.strValue = getCString(dataOffset + 4, size);
         break;
-    case GffFieldType::ResRef:
-        field.strValue = readResRefFieldData(dataOrDataOffset);
+    }
+    case GffFieldType::ResRef: {
+        uint8_t size = getValue<uint8_t>(dataOffset);
+        field.strValue = getCString(dataOffset + 1, size);
         break;
+    }
     case GffFieldType::CExoLocString: {
-        LocString locString(readCExoLocStringFieldData(dataOrDataOffset));
-        field.intValue = locString.strRef;
-        field.strValue = locString.subString;
+        int32_t strRef = getValue<int32_t>(dataOffset + 4);
+        uint32_t count = getValue<uint32_t>(dataOffset + 8);
+        field.intValue = strRef;
+        if (count > 0) {
+            uint32_t ssSize = getValue<uint32_t>(dataOffset + 16);
+            field.strValue = getCString(dataOffset + 20, ssSize);
+            if (count > 1) {
+                warn("GFF: more than one substring in CExoLocString, ignoring");
+            }
+        }
         break;
     }
-    case GffFieldType::Void:
-        field.data = readByteArrayFieldData(dataOrDataOffset);
+    case GffFieldType::Void: {
+        uint32_t size = getValue<uint32_t>(dataOffset);
+        const char *data = getData(dataOffset + 4, size);
+        field.data.assign(data, data + size);
         break;
+    }
     case GffFieldType::Struct:
-        field.children.push_back(readStruct(dataOrDataOffset));
+        field.children.push_back(getChildStruct(dataOrDataOffset));
         break;
     case GffFieldType::List: {
-        vector<uint32_t> list(readList(dataOrDataOffset));
-        for (auto &item : list) {
-            field.children.push_back(readStruct(item));
+        size_t listOffset = static_cast<size_t>(_listIndicesOffset) + dataOrDataOffset;
+        uint32_t count = getValue<uint32_t>(listOffset);
+        getData(listOffset + 4, 4ll * count);
+        field.children.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            field.children.push_back(getChildStruct(getValue<uint32_t>(listOffset + 4 + 4ll * i)));
         }
         break;
     }
     case GffFieldType::Orientation: {
-        ByteArray data(readByteArrayFieldData(dataOrDataOffset, 4 * sizeof(float)));
-        auto floatData = reinterpret_cast<float *>(&data[0]);
-        field.quatValue = glm::quat(floatData[0], floatData[1], floatData[2], floatData[3]);
+        float w = bitCast<float>(getValue<uint32_t>(dataOffset));
+        float x = bitCast<float>(getValue<uint32_t>(dataOffset + 4));
+        float y = bitCast<float>(getValue<uint32_t>(dataOffset + 8));
+        float z = bitCast<float>(getValue<uint32_t>(dataOffset + 12));
+        field.quatValue = glm::quat(w, x, y, z);
         break;
     }
     case GffFieldType::Vector: {
-        ByteArray data(readByteArrayFieldData(dataOrDataOffset, 3 * sizeof(float)));
-        field.vecValue = glm::make_vec3(reinterpret_cast<float *>(&data[0]));
+        float x = bitCast<float>(getValue<uint32_t>(dataOffset));
+        float y = bitCast<float>(getValue<uint32_t>(dataOffset + 4));
+        float z = bitCast<float>(getValue<uint32_t>(dataOffset + 8));
+        field.vecValue = glm::vec3(x, y, z);
         break;
     }
     case GffFieldType::StrRef:
-        field.intValue = readStrRefFieldData(dataOrDataOffset);
+        field.intValue = getValue<int32_t>(dataOffset + 4);
         break;
     default:
         throw runtime_error("Unsupported field type: " + to_string(type));
     }
 
-    return move(field);
-}
-
-string GffReader::readLabel(int idx) {
-    uint32_t off = _labelOffset + 16 * idx;
-    return readCString(off, 16);
-}
-
-vector<uint32_t> GffReader::readFieldIndices(uint32_t off, int count) {
-    return readUint32Array(_fieldIndicesOffset + off, count);
-}
-
-uint64_t GffReader::readQWordFieldData(uint32_t off) {
-    size_t pos = tell();
-    seek(_fieldDataOffset + off);
-    uint64_t val = readUint64();
-    seek(pos);
-
-    return val;
+    return _labelHashes[labelIndex];
 }
 
-string GffReader::readStringFieldData(uint32_t off) {
-    size_t pos = tell();
-    seek(_fieldDataOffset + off);
-
-    uint32_t size = readUint32();
-    string s(readCString(size));
-    seek(pos);
-
-    return move(s);
-}
-
-string GffReader::readResRefFieldData(uint32_t off) {
-    size_t pos = tell();
-    seek(_fieldDataOffset + off);
-
-    uint8_t size = readByte();
-    string s(readCString(size));
-    seek(pos);
-
-    return move(s);
-}
-
-GffReader::LocString GffReader::readCExoLocStringFieldData(uint32_t off) {
-    size_t pos = tell();
-    seek(_fieldDataOffset + off);
-
-    uint32_t size = readUint32();
-    int32_t ref = readInt32();
-    uint32_t count = readUint32();
-
-    LocString loc;
-    loc.strRef = ref;
-
-    if (count > 0) {
-        int32_t type = readInt32();
-        uint32_t ssSize = readUint32();
-        loc.subString = readCString(ssSize);
-
-        if (count > 1) {
-            warn("GFF: more than one substring in CExoLocString, ignoring");
-        }
+shared_ptr<GffStruct> GffReader::getStruct(uint32_t idx) const {
+    if (idx >= static_cast<uint32_t>(_structCount)) {
+        throw out_of_range("GFF: struct index out of range: " + to_string(idx));
     }
-
-    seek(pos);
-
-    return move(loc);
-}
-
-int32_t GffReader::readStrRefFieldData(uint32_t off) {
-    size_t pos = tell();
-    seek(_fieldDataOffset + off);
-
-    uint32_t size = readUint32();
-    int32_t ref = readInt32();
-
-    seek(pos);
-
-    return ref;
+    // Shares ownership of the arena, without allocating a control block
+    return shared_ptr<GffStruct>(_structs, &_structs[idx]);
 }
 
-ByteArray GffReader::readByteArrayFieldData(uint32_t off) {
-    size_t pos = tell();
-    seek(_fieldDataOffset + off);
-
-    uint32_t size = readUint32();
-    ByteArray arr(readBytes(size));
-    seek(pos);
-
-    return move(arr);
+shared_ptr<GffStruct> GffReader::getChildStruct(uint32_t idx) const {
+    if (idx >= static_cast<uint32_t>(_structCount)) {
+        throw out_of_range("GFF: struct index out of range: " + to_string(idx));
+    }
+    // Children live in the arena they point to, so they must not own it
+    return shared_ptr<GffStruct>(shared_ptr<GffStruct>(), &_structs[idx]);
 }
 
-ByteArray GffReader::readByteArrayFieldData(uint32_t off, int size) {
-    return readBytes(_fieldDataOffset + off, size);
+const char *GffReader::getData(size_t off, size_t size) const {
+    if (off + size > _data.size) {
+        throw out_of_range("GFF: data out of range: " + to_string(off));
+    }
+    return _data.data + off;
 }
 
-vector<uint32_t> GffReader::readList(uint32_t off) {
-    size_t pos = tell();
-    seek(static_cast<size_t>(_listIndicesOffset) + off);
-
-    uint32_t count = readUint32();
-    vector<uint32_t> arr(readUint32Array(count));
-    seek(pos);
-
-    return move(arr);
+string GffReader::getCString(size_t off, size_t len) const {
+    const char *data = getData(off, len);
+    return string(data, strnlen(data, len));
 }
 
 } // namespace resource
@@ -25,6 +25,11 @@ namespace reone {
 
 namespace resource {
 
+/**
+ * Decodes GFF files in a single pass over an in-memory byte span. All structs
+ * of a file are allocated in one contiguous arena, which is kept alive by the
+ * root struct and any descendants returned by GffStruct getters.
+ */
 class GffReader : public BinaryReader {
 public:
     GffReader();
@@ -32,11 +37,6 @@ public:
     std::shared_ptr<GffStruct> root() const { return _root; }
 
 private:
-    struct LocString {
-        int32_t strRef {-1};
-        std::string subString;
-    };
-
     uint32_t _structOffset {0};
     int _structCount {0};
     uint32_t _fieldOffset {0};
@@ -49,22 +49,40 @@ private:
     int _fieldIncidesCount {0};
     uint32_t _listIndicesOffset {0};
     int _listIndicesCount {0};
+
+    ByteView _data;
+    std::vector<std::string> _labels;
+    std::vector<uint32_t> _labelHashes;
+    std::shared_ptr<GffStruct[]> _structs;
     std::shared_ptr<GffStruct> _root;
 
     void doLoad() override;
 
-    std::unique_ptr<GffStruct> readStruct(int idx);
-    GffField readField(int idx);
-    std::string readLabel(int idx);
-    std::vector<uint32_t> readFieldIndices(uint32_t off, int count);
-    uint64_t readQWordFieldData(uint32_t off);
-    std::string readStringFieldData(uint32_t off);
-    std::string readResRefFieldData(uint32_t off);
-    LocString readCExoLocStringFieldData(uint32_t off);
-    int32_t readStrRefFieldData(uint32_t off);
-    ByteArray readByteArrayFieldData(uint32_t off);
-    ByteArray readByteArrayFieldData(uint32_t off, int size);
-    std::vector<uint32_t> readList(uint32_t off);
+    void readLabels();
+    void readStructs();
+    /**
+     * @return hash of the field label
+     */
+    uint32_t readField(uint32_t idx, GffField &field);
+
+    std::shared_ptr<GffStruct> getStruct(uint32_t idx) const;
+    std::shared_ptr<GffStruct> getChildStruct(uint32_t idx) const;
+
+    /**
+     * @return pointer to size bytes at the specified offset into the file
+     * @throws std::out_of_range if the range is not within the file
+     */
+    const char *getData(size_t off, size_t size) const;
+
+    template <class T>
+    T getValue(size_t off) const {
+        T val;
+        memcpy(&val, getData(off, sizeof(T)), sizeof(T));
+        boost::endian::little_to_native_inplace(val);
+        return val;
+    }
+
+    std::string getCString(size_t off, size_t len) const;
 };
 
 } // namespace resource
@@ -33,6 +33,14 @@ KeyReader::KeyReader() :
 }
 
 bool KeyReader::find(const ResourceId &id, KeyEntry &outKey) const {
+    if (_cachedIndex) {
+        int keyIdx = _cachedIndex->find(id);
+        if (keyIdx == -1) {
+            return false;
+        }
+        outKey = _keys[keyIdx];
+        return true;
+    }
     auto maybeKey = _keyIdxByResId.find(id);
     if (maybeKey == _keyIdxByResId.end()) {
         return false;
@@ -41,6 +49,19 @@ bool KeyReader::find(const ResourceId &id, KeyEntry &outKey) const {
     return true;
 }
 
+void KeyReader::forEachKey(const function<void(const ResourceId &, int)> &fn) const {
+    if (_cachedIndex) {
+        // Cached keys are unique by construction
+        for (int i = 0; i < _keyCount; ++i) {
+            fn(_keys[i].resId, i);
+        }
+        return;
+    }
+    for (auto &pair : _keyIdxByResId) {
+        fn(pair.first, pair.second);
+    }
+}
+
 const string &KeyReader::getFilename(int idx) const {
     if (idx >= _files.size()) {
         throw out_of_range("KEY: file index out of range: " + to_string(idx));
@@ -55,7 +76,11 @@ void KeyReader::doLoad() {
     _keysOffset = readUint32();
 
     loadFiles();
-    loadKeys();
+
+    if (!loadKeysFromIndexCache()) {
+        loadKeys();
+        saveKeysToIndexCache();
+    }
 }
 
 void KeyReader::loadFiles() {
@@ -91,6 +116,45 @@ void KeyReader::loadKeys() {
     }
 }
 
+bool KeyReader::loadKeysFromIndexCache() {
+    if (!_indexCache || _path.empty()) {
+        return false;
+    }
+    _cachedIndex = _indexCache->load(_path, [this](auto &entry) {
+        return entry.values[0] < static_cast<uint32_t>(_bifCount) && entry.values[1] <= 0xfffff;
+    });
+    if (!_cachedIndex) {
+        return false;
+    }
+    _keyCount = _cachedIndex->entryCount();
+    _keys.reserve(_keyCount);
+
+    for (int i = 0; i < _keyCount; ++i) {
+        const CachedIndex::Entry &cached = _cachedIndex->entry(i);
+
+        KeyEntry entry;
+        entry.resId = cached.resId();
+        entry.bifIdx = static_cast<int>(cached.values[0]);
+        entry.resIdx = static_cast<int>(cached.values[1]);
+        _keys.push_back(move(entry));
+    }
+
+    return true;
+}
+
+void KeyReader::saveKeysToIndexCache() {
+    if (!_indexCache || _path.empty()) {
+        return;
+    }
+    vector<CachedIndex::Entry> entries;
+    entries.reserve(_keyIdxByResId.size());
+    for (auto &pair : _keyIdxByResId) {
+        const KeyEntry &key = _keys[pair.second];
+        entries.push_back(IndexCache::makeEntry(pair.first, key.bifIdx, key.resIdx));
+    }
+    _indexCache->save(_path, move(entries));
+}
+
 KeyReader::KeyEntry KeyReader::readKeyEntry() {
     string resRef(boost::to_lower_copy(readCString(16)));
     uint16_t resType = readUint16();
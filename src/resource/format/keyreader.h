@@ -18,6 +18,7 @@
 #pragma once
 
 #include "../id.h"
+#include "../indexcache.h"
 #include "../types.h"
 
 #include "binreader.h"
@@ -44,10 +45,23 @@ public:
     bool find(const ResourceId &id, KeyEntry &outKey) const;
     const std::string &getFilename(int idx) const;
 
+    /**
+     * Invokes the function once for every distinct key, passing its index.
+     */
+    void forEachKey(const std::function<void(const ResourceId &, int)> &fn) const;
+
     const std::vector<FileEntry> &files() const { return _files; }
     const std::vector<KeyEntry> &keys() const { return _keys; }
 
+    /**
+     * Enables loading the key table from the index cache. Must be called before load.
+     */
+    void setIndexCache(IndexCache *cache) { _indexCache = cache; }
+
 private:
+    IndexCache *_indexCache {nullptr};
+    std::shared_ptr<CachedIndex> _cachedIndex;
+
     int _bifCount {0};
     int _keyCount {0};
     uint32_t _filesOffset {0};
@@ -60,6 +74,8 @@ private:
 
     void loadFiles();
     void loadKeys();
+    bool loadKeysFromIndexCache();
+    void saveKeysToIndexCache();
 
     FileEntry readFileEntry();
     KeyEntry readKeyEntry();
@@ -39,7 +39,10 @@ void RimReader::doLoad() {
     _resourceCount = readUint32();
     _resourcesOffset = readUint32();
 
-    loadResources();
+    if (!loadFromIndexCache()) {
+        loadResources();
+        saveToIndexCache();
+    }
 }
 
 void RimReader::loadResources() {
@@ -68,13 +71,89 @@ RimReader::ResourceEntry RimReader::readResource() {
     return move(res);
 }
 
-shared_ptr<ByteArray> RimReader::find(const ResourceId &id) {
+bool RimReader::loadFromIndexCache() {
+    if (!_indexCache || _path.empty()) {
+        return false;
+    }
+    _cachedIndex = _indexCache->load(_path, [this](auto &entry) {
+        return static_cast<uint64_t>(entry.values[0]) + entry.values[1] <= _size;
+    });
+    if (!_cachedIndex) {
+        return false;
+    }
+    _resourceCount = _cachedIndex->entryCount();
+    _resources.reserve(_resourceCount);
+
+    for (int i = 0; i < _resourceCount; ++i) {
+        const CachedIndex::Entry &entry = _cachedIndex->entry(i);
+
+        ResourceEntry res;
+        res.resId = entry.resId();
+        res.offset = entry.values[0];
+        res.size = entry.values[1];
+        _resources.push_back(move(res));
+    }
+
+    return true;
+}
+
+void RimReader::saveToIndexCache() {
+    if (!_indexCache || _path.empty()) {
+        return;
+    }
+    vector<CachedIndex::Entry> entries;
+    entries.reserve(_resIdxByResId.size());
+    for (auto &pair : _resIdxByResId) {
+        const ResourceEntry &res = _resources[pair.second];
+        entries.push_back(IndexCache::makeEntry(pair.first, res.offset, res.size));
+    }
+    _indexCache->save(_path, move(entries));
+}
+
+int RimReader::findEntryIdx(const ResourceId &id) const {
+    if (_cachedIndex) {
+        return _cachedIndex->find(id);
+    }
     auto maybeIdx = _resIdxByResId.find(id);
-    if (maybeIdx == _resIdxByResId.end()) {
+    return maybeIdx != _resIdxByResId.end() ? maybeIdx->second : -1;
+}
+
+shared_ptr<ByteArray> RimReader::find(const ResourceId &id) {
+    int entryIdx = findEntryIdx(id);
+    if (entryIdx == -1) {
         return nullptr;
     }
-    const ResourceEntry &res = _resources[maybeIdx->second];
-    return make_shared<ByteArray>(getResourceData(res));
+    return readEntry(entryIdx);
+}
+
+ByteView RimReader::findView(const ResourceId &id) {
+    int entryIdx = findEntryIdx(id);
+    if (entryIdx == -1) {
+        return ByteView();
+    }
+    return readEntryView(entryIdx);
+}
+
+void RimReader::forEachEntry(const function<void(const ResourceId &, int)> &fn) const {
+    if (_cachedIndex) {
+        // Cached entries are unique by construction
+        for (int i = 0; i < _resourceCount; ++i) {
+            fn(_resources[i].resId, i);
+        }
+        return;
+    }
+    for (auto &pair : _resIdxByResId) {
+        fn(pair.first, pair.second);
+    }
+}
+
+shared_ptr<ByteArray> RimReader::readEntry(int entryIdx) {
+    return make_shared<ByteArray>(getResourceData(_resources[entryIdx]));
+}
+
+ByteView RimReader::readEntryView(int entryIdx) {
+    const ResourceEntry &res = _resources[entryIdx];
+    return readView(res.offset, res.size);
 }
 
 ByteArray RimReader::getResourceData(const ResourceEntry &res) {
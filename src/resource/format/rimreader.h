@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "../indexcache.h"
 #include "../resourceprovider.h"
 #include "../types.h"
 
@@ -37,14 +38,26 @@ public:
     RimReader(int id = kDefaultProviderId);
 
     std::shared_ptr<ByteArray> find(const ResourceId &id) override;
+    ByteView findView(const ResourceId &id) override;
+
+    void forEachEntry(const std::function<void(const ResourceId &, int)> &fn) const override;
+    std::shared_ptr<ByteArray> readEntry(int entryIdx) override;
+    ByteView readEntryView(int entryIdx) override;
 
     const std::vector<ResourceEntry> &resources() const { return _resources; }
 
     int getId() const override { return _id; }
     ByteArray getResourceData(int idx);
 
+    /**
+     * Enables loading the resource table from the index cache. Must be called before load.
+     */
+    void setIndexCache(IndexCache *cache) { _indexCache = cache; }
+
 private:
     int _id;
+    IndexCache *_indexCache {nullptr};
+    std::shared_ptr<CachedIndex> _cachedIndex;
 
     int _resourceCount {0};
     uint32_t _resourcesOffset {0};
@@ -53,6 +66,10 @@ private:
 
     void doLoad() override;
     void loadResources();
+    bool loadFromIndexCache();
+    void saveToIndexCache();
+
+    int findEntryIdx(const ResourceId &id) const;
 
     ResourceEntry readResource();
     ByteArray getResourceData(const ResourceEntry &res);
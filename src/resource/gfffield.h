@@ -19,6 +19,8 @@
 
 #include "../common/types.h"
 
+#include "gfflabels.h"
+
 namespace reone {
 
 namespace resource {
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+namespace reone {
+
+namespace resource {
+
+/**
+ * @return FNV-1a hash of a GFF field label
+ */
+constexpr uint32_t getGffLabelHash(const char *label, size_t len) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= static_cast<uint8_t>(label[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+constexpr size_t getGffLabelLength(const char *label) {
+    size_t len = 0;
+    while (label[len] != '\0') {
+        ++len;
+    }
+    return len;
+}
+
+/**
+ * Pre-hashed GFF field label. Declare as constexpr to hash at compile time:
+ *
+ * static constexpr GffKey kTag("Tag");
+ */
+struct GffKey {
+    const char *name {nullptr};
+    size_t length {0};
+    uint32_t hash {0};
+
+    constexpr explicit GffKey(const char *name) :
+        GffKey(name, getGffLabelLength(name)) {
+    }
+
+    constexpr GffKey(const char *name, size_t length) :
+        name(name),
+        length(length),
+        hash(getGffLabelHash(name, length)) {
+    }
+};
+
+} // namespace resource
+
+} // namespace reone
@@ -17,8 +17,6 @@
 
 #include "gffs.h"
 
-#include "../common/streamutil.h"
-
 #include "format/gffreader.h"
 #include "resources.h"
 
@@ -28,21 +26,40 @@ namespace reone {
 
 namespace resource {
 
-shared_ptr<GffStruct> Gffs::get(const string &resRef, ResourceType type) {
-    ResourceId id(resRef, type);
-    auto maybeGff = _cache.find(id);
-    if (maybeGff != _cache.end()) {
-        return maybeGff->second;
-    }
-    shared_ptr<GffStruct> gff;
-    auto maybeRaw = _resources.get(resRef, type);
-    if (maybeRaw) {
-        GffReader reader;
-        reader.load(wrap(*maybeRaw));
-        gff = reader.root();
+static constexpr size_t kCacheByteBudget = 64 * 1024 * 1024;
+
+static size_t getGffSize(const GffStruct &gff) {
+    size_t size = sizeof(GffStruct);
+    for (auto &field : gff.fields()) {
+        size += sizeof(GffField) + field.label.capacity() + field.strValue.capacity() + field.data.capacity();
+        for (auto &child : field.children) {
+            size += getGffSize(*child);
+        }
     }
-    auto inserted = _cache.insert(make_pair(id, gff));
-    return inserted.first->second;
+    return size;
+}
+
+Gffs::Gffs(Resources &resources) :
+    _resources(resources) {
+
+    CachePolicy<ResourceId, GffStruct> policy;
+    policy.byteBudget = kCacheByteBudget;
+    policy.sizeOf = &getGffSize;
+    policy.retain = [this](const ResourceId &id) { return !_resources.isTransient(id.resRef, id.type); };
+    _cache.setPolicy(move(policy));
+}
+
+shared_ptr<GffStruct> Gffs::get(const string &resRef, ResourceType type) {
+    return _cache.get(ResourceId(resRef, type), [&]() {
+        shared_ptr<GffStruct> gff;
+        ByteView raw(_resources.getView(resRef, type));
+        if (raw) {
+            GffReader reader;
+            reader.load(move(raw));
+            gff = reader.root();
+        }
+        return move(gff);
+    });
 }
 
 } // namespace resource
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include "../common/memorycache.h"
+
 #include "gffstruct.h"
 #include "id.h"
 #include "types.h"
@@ -29,12 +31,13 @@ class Resources;
 
 class Gffs {
 public:
-    Gffs(Resources &resources) :
-        _resources(resources) {
-    }
+    Gffs(Resources &resources);
 
+    /**
+     * Removes cached GFF files, except those that cannot be overridden by module archives.
+     */
     void invalidate() {
-        _cache.clear();
+        _cache.invalidate();
     }
 
     std::shared_ptr<GffStruct> get(const std::string &resRef, ResourceType type);
@@ -42,7 +45,7 @@ public:
 private:
     Resources &_resources;
 
-    std::unordered_map<ResourceId, std::shared_ptr<GffStruct>, ResourceIdHasher> _cache;
+    MemoryCache<ResourceId, GffStruct, ResourceIdHasher> _cache;
 };
 
 } // namespace resource
@@ -25,37 +25,69 @@ namespace reone {
 
 namespace resource {
 
+static GffKey getKey(const string &name) {
+    return GffKey(name.c_str(), name.length());
+}
+
+GffStruct::GffStruct(uint32_t type, vector<GffField> fields) :
+    _type(type),
+    _fields(move(fields)) {
+
+    indexFields();
+}
+
 void GffStruct::add(GffField &&field) {
-    _fields.push_back(field);
+    LabelIndexEntry entry;
+    entry.hash = getGffLabelHash(field.label.c_str(), field.label.length());
+    entry.fieldIdx = static_cast<uint32_t>(_fields.size());
+    _index.insert(upper_bound(_index.begin(), _index.end(), entry), entry);
+
+    _fields.push_back(move(field));
 }
 
-bool GffStruct::getBool(const string &name, bool defValue) const {
-    const GffField *field = get(name);
-    if (!field)
-        return defValue;
+void GffStruct::indexFields() {
+    _index.resize(_fields.size());
+    for (size_t i = 0; i < _fields.size(); ++i) {
+        const string &label = _fields[i].label;
+        _index[i].hash = getGffLabelHash(label.c_str(), label.length());
+        _index[i].fieldIdx = static_cast<uint32_t>(i);
+    }
+    sortIndex();
+}
 
-    return field->intValue != 0;
+void GffStruct::sortIndex() {
+    sort(_index.begin(), _index.end());
 }
 
-const GffField *GffStruct::get(const string &name) const {
-    auto maybeField = find_if(
-        _fields.begin(),
-        _fields.end(),
-        [&](auto &f) { return f.label == name; });
+const GffField *GffStruct::get(const GffKey &key) const {
+    auto it = lower_bound(_index.begin(), _index.end(), key.hash, [](const LabelIndexEntry &entry, uint32_t hash) { return entry.hash < hash; });
+    for (; it != _index.end() && it->hash == key.hash; ++it) {
+        const GffField &field = _fields[it->fieldIdx];
+        if (field.label.length() == key.length && field.label.compare(0, key.length, key.name, key.length) == 0) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
+
+bool GffStruct::getBool(const GffKey &key, bool defValue) const {
+    const GffField *field = get(key);
+    if (!field)
+        return defValue;
 
-    return maybeField != _fields.end() ? &*maybeField : nullptr;
+    return field->intValue != 0;
 }
 
-int GffStruct::getInt(const string &name, int defValue) const {
-    const GffField *field = get(name);
+int GffStruct::getInt(const GffKey &key, int defValue) const {
+    const GffField *field = get(key);
     if (!field)
         return defValue;
 
     return field->intValue;
 }
 
-uint32_t GffStruct::getUint(const string &name, uint32_t defValue) const {
-    const GffField *field = get(name);
+uint32_t GffStruct::getUint(const GffKey &key, uint32_t defValue) const {
+    const GffField *field = get(key);
     if (!field)
         return defValue;
 
@@ -73,60 +105,114 @@ static glm::vec3 colorFromUint32(uint32_t value) {
     return move(result);
 }
 
-glm::vec3 GffStruct::getColor(const string &name, glm::vec3 defValue) const {
-    const GffField *field = get(name);
+glm::vec3 GffStruct::getColor(const GffKey &key, glm::vec3 defValue) const {
+    const GffField *field = get(key);
     if (!field)
         return move(defValue);
 
     return colorFromUint32(field->uintValue);
 }
 
-float GffStruct::getFloat(const string &name, float defValue) const {
-    const GffField *field = get(name);
+float GffStruct::getFloat(const GffKey &key, float defValue) const {
+    const GffField *field = get(key);
     if (!field)
         return defValue;
 
     return field->floatValue;
 }
 
-string GffStruct::getString(const string &name, string defValue) const {
-    const GffField *field = get(name);
+string GffStruct::getString(const GffKey &key, string defValue) const {
+    const GffField *field = get(key);
     if (!field)
         return defValue;
 
     return field->strValue;
 }
 
-glm::vec3 GffStruct::getVector(const string &name, glm::vec3 defValue) const {
-    const GffField *field = get(name);
+glm::vec3 GffStruct::getVector(const GffKey &key, glm::vec3 defValue) const {
+    const GffField *field = get(key);
     if (!field)
         return move(defValue);
 
     return field->vecValue;
 }
 
-glm::quat GffStruct::getOrientation(const string &name, glm::quat defValue) const {
-    const GffField *field = get(name);
+glm::quat GffStruct::getOrientation(const GffKey &key, glm::quat defValue) const {
+    const GffField *field = get(key);
     if (!field)
         return defValue;
 
     return field->quatValue;
 }
 
-shared_ptr<GffStruct> GffStruct::getStruct(const string &name) const {
-    const GffField *field = get(name);
+shared_ptr<GffStruct> GffStruct::getStruct(const GffKey &key) const {
+    const GffField *field = get(key);
     if (!field)
         return nullptr;
 
-    return field->children[0];
+    return shareChild(field->children[0]);
 }
 
-vector<shared_ptr<GffStruct>> GffStruct::getList(const string &name) const {
-    const GffField *field = get(name);
+vector<shared_ptr<GffStruct>> GffStruct::getList(const GffKey &key) const {
+    const GffField *field = get(key);
     if (!field)
         return vector<shared_ptr<GffStruct>>();
 
-    return field->children;
+    auto arena = _arena.lock();
+    if (!arena) {
+        return field->children;
+    }
+    vector<shared_ptr<GffStruct>> children;
+    children.reserve(field->children.size());
+    for (auto &child : field->children) {
+        children.push_back(shared_ptr<GffStruct>(arena, child.get()));
+    }
+    return children;
+}
+
+shared_ptr<GffStruct> GffStruct::shareChild(const shared_ptr<GffStruct> &child) const {
+    auto arena = _arena.lock();
+    return arena ? shared_ptr<GffStruct>(move(arena), child.get()) : child;
+}
+
+bool GffStruct::getBool(const string &name, bool defValue) const {
+    return getBool(getKey(name), defValue);
+}
+
+int GffStruct::getInt(const string &name, int defValue) const {
+    return getInt(getKey(name), defValue);
+}
+
+uint32_t GffStruct::getUint(const string &name, uint32_t defValue) const {
+    return getUint(getKey(name), defValue);
+}
+
+glm::vec3 GffStruct::getColor(const string &name, glm::vec3 defValue) const {
+    return getColor(getKey(name), move(defValue));
+}
+
+float GffStruct::getFloat(const string &name, float defValue) const {
+    return getFloat(getKey(name), defValue);
+}
+
+string GffStruct::getString(const string &name, string defValue) const {
+    return getString(getKey(name), move(defValue));
+}
+
+glm::vec3 GffStruct::getVector(const string &name, glm::vec3 defValue) const {
+    return getVector(getKey(name), move(defValue));
+}
+
+glm::quat GffStruct::getOrientation(const string &name, glm::quat defValue) const {
+    return getOrientation(getKey(name), move(defValue));
+}
+
+shared_ptr<GffStruct> GffStruct::getStruct(const string &name) const {
+    return getStruct(getKey(name));
+}
+
+vector<shared_ptr<GffStruct>> GffStruct::getList(const string &name) const {
+    return getList(getKey(name));
 }
 
 } // namespace resource
@@ -20,23 +20,42 @@
 #include "../common/types.h"
 
 #include "gfffield.h"
+#include "gfflabels.h"
 
 namespace reone {
 
 namespace resource {
 
+/**
+ * Fields of a GFF struct are indexed by label hash. Getters accept either
+ * label strings, or pre-hashed keys:
+ *
+ * static constexpr GffKey kTag("Tag");
+ * std::string tag(gffs.getString(kTag));
+ */
 class GffStruct : boost::noncopyable {
 public:
+    GffStruct() = default;
+
     GffStruct(uint32_t type) :
         _type(type) {
     }
 
-    GffStruct(uint32_t type, std::vector<GffField> fields) :
-        _type(type), _fields(std::move(fields)) {
-    }
+    GffStruct(uint32_t type, std::vector<GffField> fields);
 
     void add(GffField &&field);
 
+    bool getBool(const GffKey &key, bool defValue = false) const;
+    int getInt(const GffKey &key, int defValue = 0) const;
+    uint32_t getUint(const GffKey &key, uint32_t defValue = 0) const;
+    glm::vec3 getColor(const GffKey &key, glm::vec3 defValue = glm::vec3(0.0f)) const;
+    float getFloat(const GffKey &key, float defValue = 0.0f) const;
+    std::string getString(const GffKey &key, std::string defValue = "") const;
+    glm::vec3 getVector(const GffKey &key, glm::vec3 defValue = glm::vec3(0.0f)) const;
+    glm::quat getOrientation(const GffKey &key, glm::quat defValue = glm::quat(1.0f, 0.0f, 0.0f, 0.0f)) const;
+    std::shared_ptr<GffStruct> getStruct(const GffKey &key) const;
+    std::vector<std::shared_ptr<GffStruct>> getList(const GffKey &key) const;
+
     bool getBool(const std::string &name, bool defValue = false) const;
     int getInt(const std::string &name, int defValue = 0) const;
     uint32_t getUint(const std::string &name, uint32_t defValue = 0) const;
@@ -51,16 +70,43 @@ public:
     uint32_t type() const { return _type; }
     const std::vector<GffField> &fields() const { return _fields; }
 
+    template <class T>
+    T getEnum(const GffKey &key, T defValue) const {
+        return static_cast<T>(getInt(key, static_cast<int>(defValue)));
+    }
+
     template <class T>
     T getEnum(const std::string &name, T defValue) const {
         return static_cast<T>(getInt(name, static_cast<int>(defValue)));
     }
 
 private:
+    struct LabelIndexEntry {
+        uint32_t hash {0};
+        uint32_t fieldIdx {0};
+
+        bool operator<(const LabelIndexEntry &other) const {
+            return hash != other.hash ? hash < other.hash : fieldIdx < other.fieldIdx;
+        }
+    };
+
     uint32_t _type {0};
     std::vector<GffField> _fields;
+    std::vector<LabelIndexEntry> _index; /**< sorted by label hash, then by field index */
+
+    /**
+     * Arena of a GffReader, if this struct was allocated in one. Children of
+     * arena structs do not own them, ownership of the arena is shared when
+     * children are returned instead.
+     */
+    std::weak_ptr<void> _arena;
+
+    void indexFields();
+    void sortIndex();
+
+    std::shared_ptr<GffStruct> shareChild(const std::shared_ptr<GffStruct> &child) const;
 
-    const GffField *get(const std::string &name) const;
+    const GffField *get(const GffKey &key) const;
 
     friend class GffReader;
 };
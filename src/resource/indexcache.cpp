@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "indexcache.h"
+
+#include "../common/logutil.h"
+#include "../common/mappedfile.h"
+
+using namespace std;
+
+namespace fs = boost::filesystem;
+
+namespace reone {
+
+namespace resource {
+
+static constexpr uint32_t kSignature = 0x58444952; // RIDX
+static constexpr uint32_t kVersion = 1;
+static constexpr uint32_t kEmptyBucket = 0xffffffff;
+
+struct CacheHeader {
+    uint32_t signature {kSignature};
+    uint32_t version {kVersion};
+    uint64_t archiveSize {0};
+    int64_t archiveTime {0};
+    uint32_t entryCount {0};
+    uint32_t bucketCount {0};
+    uint32_t pathLength {0};
+    uint32_t reserved {0};
+};
+
+static inline size_t alignTo8(size_t size) {
+    return (size + 7) & ~static_cast<size_t>(7);
+}
+
+static uint32_t fnv1a(const char *data, size_t size, uint32_t hash = 2166136261u) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t hashResourceId(const char *resRef, size_t resRefLen, uint16_t type) {
+    uint32_t hash = fnv1a(resRef, resRefLen);
+    return fnv1a(reinterpret_cast<const char *>(&type), sizeof(type), hash);
+}
+
+static inline size_t getResRefLength(const CachedIndex::Entry &entry) {
+    return strnlen(entry.resRef, sizeof(entry.resRef));
+}
+
+ResourceId CachedIndex::Entry::resId() const {
+    return ResourceId(string(resRef, getResRefLength(*this)), static_cast<ResourceType>(type));
+}
+
+CachedIndex::CachedIndex(shared_ptr<MappedFile> file, const Entry *entries, int entryCount, const uint32_t *buckets, uint32_t bucketCount) :
+    _file(move(file)),
+    _entries(entries),
+    _entryCount(entryCount),
+    _buckets(buckets),
+    _bucketCount(bucketCount) {
+}
+
+int CachedIndex::find(const ResourceId &id) const {
+    if (_bucketCount == 0 || id.resRef.size() > sizeof(Entry::resRef)) {
+        return -1;
+    }
+    auto type = static_cast<uint16_t>(id.type);
+    uint32_t mask = _bucketCount - 1;
+    uint32_t bucket = hashResourceId(id.resRef.c_str(), id.resRef.size(), type) & mask;
+    for (uint32_t probe = 0; probe < _bucketCount; ++probe, bucket = (bucket + 1) & mask) {
+        uint32_t entryIdx = _buckets[bucket];
+        if (entryIdx == kEmptyBucket) {
+            return -1;
+        }
+        const Entry &entry = _entries[entryIdx];
+        if (entry.type == type &&
+            getResRefLength(entry) == id.resRef.size() &&
+            strncmp(entry.resRef, id.resRef.c_str(), id.resRef.size()) == 0) {
+            return static_cast<int>(entryIdx);
+        }
+    }
+    return -1;
+}
+
+CachedIndex::Entry IndexCache::makeEntry(const ResourceId &id, uint32_t value1, uint32_t value2) {
+    CachedIndex::Entry entry;
+    memset(&entry, 0, sizeof(entry));
+    strncpy(entry.resRef, id.resRef.c_str(), sizeof(entry.resRef));
+    entry.type = static_cast<uint16_t>(id.type);
+    entry.values[0] = value1;
+    entry.values[1] = value2;
+    return entry;
+}
+
+fs::path IndexCache::getCachePath(const string &archivePath) const {
+    uint32_t hash = fnv1a(archivePath.c_str(), archivePath.size());
+    return _directory / str(boost::format("%08x.idx") % hash);
+}
+
+static bool isValidBucketTable(const uint32_t *buckets, uint32_t bucketCount, uint32_t entryCount) {
+    // Lookups terminate on an empty bucket, so there must be at least one
+    bool hasEmpty = false;
+    for (uint32_t i = 0; i < bucketCount; ++i) {
+        if (buckets[i] == kEmptyBucket) {
+            hasEmpty = true;
+        } else if (buckets[i] >= entryCount) {
+            return false;
+        }
+    }
+    return hasEmpty;
+}
+
+shared_ptr<CachedIndex> IndexCache::load(const fs::path &archivePath, const function<bool(const CachedIndex::Entry &)> &validate) {
+    try {
+        string archivePathStr(fs::absolute(archivePath).string());
+        fs::path cachePath(getCachePath(archivePathStr));
+        if (!fs::exists(cachePath)) {
+            return nullptr;
+        }
+        auto file = make_shared<MappedFile>(cachePath);
+        ByteView view(file->view());
+        if (view.size < sizeof(CacheHeader)) {
+            return nullptr;
+        }
+        CacheHeader header;
+        memcpy(&header, view.data, sizeof(header));
+        if (header.signature != kSignature ||
+            header.version != kVersion ||
+            header.archiveSize != fs::file_size(archivePath) ||
+            header.archiveTime != static_cast<int64_t>(fs::last_write_time(archivePath)) ||
+            header.bucketCount == 0 ||
+            (header.bucketCount & (header.bucketCount - 1)) != 0 ||
+            header.bucketCount <= header.entryCount ||
+            header.entryCount > static_cast<uint32_t>(numeric_limits<int>::max())) {
+            return nullptr;
+        }
+        size_t entriesOffset = alignTo8(sizeof(CacheHeader) + header.pathLength);
+        size_t bucketsOffset = entriesOffset + header.entryCount * sizeof(CachedIndex::Entry);
+        size_t expectedSize = bucketsOffset + header.bucketCount * sizeof(uint32_t);
+        if (view.size != expectedSize ||
+            archivePathStr.size() != header.pathLength ||
+            strncmp(view.data + sizeof(CacheHeader), archivePathStr.c_str(), header.pathLength) != 0) {
+            return nullptr;
+        }
+        auto entries = reinterpret_cast<const CachedIndex::Entry *>(view.data + entriesOffset);
+        auto buckets = reinterpret_cast<const uint32_t *>(view.data + bucketsOffset);
+        if (!isValidBucketTable(buckets, header.bucketCount, header.entryCount)) {
+            warn("Corrupt index cache bucket table for " + archivePath.string(), LogChannels::resources);
+            return nullptr;
+        }
+        if (validate) {
+            for (uint32_t i = 0; i < header.entryCount; ++i) {
+                if (!validate(entries[i])) {
+                    warn("Corrupt index cache entry for " + archivePath.string(), LogChannels::resources);
+                    return nullptr;
+                }
+            }
+        }
+        debug("Index cache hit for " + archivePath.string(), LogChannels::resources);
+
+        return make_shared<CachedIndex>(move(file), entries, static_cast<int>(header.entryCount), buckets, header.bucketCount);
+
+    } catch (const exception &e) {
+        warn(boost::format("Error loading index cache for '%s': %s") % archivePath.string() % e.what(), LogChannels::resources);
+        return nullptr;
+    }
+}
+
+void IndexCache::save(const fs::path &archivePath, vector<CachedIndex::Entry> entries) {
+    sort(entries.begin(), entries.end(), [](auto &left, auto &right) {
+        int resRefCmp = strncmp(left.resRef, right.resRef, sizeof(left.resRef));
+        return resRefCmp < 0 || (resRefCmp == 0 && left.type < right.type);
+    });
+
+    uint32_t bucketCount = 1;
+    while (bucketCount < 2 * entries.size()) {
+        bucketCount <<= 1;
+    }
+    vector<uint32_t> buckets(bucketCount, kEmptyBucket);
+    for (uint32_t i = 0; i < entries.size(); ++i) {
+        const CachedIndex::Entry &entry = entries[i];
+        uint32_t bucket = hashResourceId(entry.resRef, getResRefLength(entry), entry.type) & (bucketCount - 1);
+        while (buckets[bucket] != kEmptyBucket) {
+            bucket = (bucket + 1) & (bucketCount - 1);
+        }
+        buckets[bucket] = i;
+    }
+
+    try {
+        string archivePathStr(fs::absolute(archivePath).string());
+
+        CacheHeader header;
+        header.archiveSize = fs::file_size(archivePath);
+        header.archiveTime = static_cast<int64_t>(fs::last_write_time(archivePath));
+        header.entryCount = static_cast<uint32_t>(entries.size());
+        header.bucketCount = bucketCount;
+        header.pathLength = static_cast<uint32_t>(archivePathStr.size());
+
+        size_t entriesOffset = alignTo8(sizeof(CacheHeader) + header.pathLength);
+        ByteArray data(entriesOffset, '\0');
+        memcpy(&data[0], &header, sizeof(header));
+        memcpy(&data[sizeof(header)], archivePathStr.c_str(), header.pathLength);
+        data.insert(data.end(), reinterpret_cast<const char *>(entries.data()), reinterpret_cast<const char *>(entries.data() + entries.size()));
+        data.insert(data.end(), reinterpret_cast<const char *>(buckets.data()), reinterpret_cast<const char *>(buckets.data() + buckets.size()));
+
+        // Write to a temporary file first, so that a partially written cache is never loaded
+        fs::create_directories(_directory);
+        fs::path cachePath(getCachePath(archivePathStr));
+        fs::path tmpPath(cachePath);
+        tmpPath += ".tmp";
+        {
+            fs::ofstream out(tmpPath, ios::binary);
+            out.write(&data[0], data.size());
+            if (!out) {
+                throw runtime_error("Write failed: " + tmpPath.string());
+            }
+        }
+        fs::rename(tmpPath, cachePath);
+        debug("Index cache saved for " + archivePath.string(), LogChannels::resources);
+
+    } catch (const exception &e) {
+        warn(boost::format("Error saving index cache for '%s': %s") % archivePath.string() % e.what(), LogChannels::resources);
+    }
+}
+
+} // namespace resource
+
+} // namespace reone
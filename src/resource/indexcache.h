@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../common/types.h"
+
+#include "id.h"
+
+namespace reone {
+
+class MappedFile;
+
+namespace resource {
+
+/**
+ * Memory-mapped key table of a single archive, loaded from the index cache.
+ * Entries are sorted by ResRef and type, and are looked up using an
+ * open-addressing hash table stored alongside them.
+ */
+class CachedIndex : boost::noncopyable {
+public:
+    struct Entry {
+        char resRef[16];
+        uint16_t type;
+        uint16_t reserved;
+        uint32_t values[2]; /**< archive-specific location of the resource, e.g. offset and size */
+
+        ResourceId resId() const;
+    };
+
+    CachedIndex(std::shared_ptr<MappedFile> file, const Entry *entries, int entryCount, const uint32_t *buckets, uint32_t bucketCount);
+
+    /**
+     * @return index of the entry with the specified id, or -1 if not found
+     */
+    int find(const ResourceId &id) const;
+
+    int entryCount() const { return _entryCount; }
+    const Entry &entry(int idx) const { return _entries[idx]; }
+
+private:
+    std::shared_ptr<MappedFile> _file;
+    const Entry *_entries;
+    int _entryCount;
+    const uint32_t *_buckets;
+    uint32_t _bucketCount;
+};
+
+/**
+ * Persistent cache of archive key tables, that lets KEY, ERF and RIM readers
+ * skip parsing on subsequent launches. Every archive is cached in a separate
+ * file within the cache directory, which is considered stale when either
+ * size or modification time of the archive changes.
+ */
+class IndexCache : boost::noncopyable {
+public:
+    IndexCache(boost::filesystem::path directory) :
+        _directory(std::move(directory)) {
+    }
+
+    /**
+     * @param validate optional function used to check that a cached entry is consistent with the archive
+     * @return cached key table of the archive, or nullptr if not cached, stale or corrupt
+     */
+    std::shared_ptr<CachedIndex> load(
+        const boost::filesystem::path &archivePath,
+        const std::function<bool(const CachedIndex::Entry &)> &validate = nullptr);
+
+    /**
+     * Replaces the cached key table of the archive. Entries with duplicate ids
+     * are expected to be filtered out by the caller.
+     */
+    void save(const boost::filesystem::path &archivePath, std::vector<CachedIndex::Entry> entries);
+
+    static CachedIndex::Entry makeEntry(const ResourceId &id, uint32_t value1, uint32_t value2);
+
+private:
+    boost::filesystem::path _directory;
+
+    boost::filesystem::path getCachePath(const std::string &archivePath) const;
+};
+
+} // namespace resource
+
+} // namespace reone
@@ -29,8 +29,9 @@ namespace reone {
 
 namespace resource {
 
-void KeyBifResourceProvider::init(const fs::path &keyPath) {
+void KeyBifResourceProvider::init(const fs::path &keyPath, IndexCache *indexCache) {
     _gamePath = keyPath.parent_path();
+    _keyFile.setIndexCache(indexCache);
     _keyFile.load(keyPath);
 }
 
@@ -39,30 +40,51 @@ shared_ptr<ByteArray> KeyBifResourceProvider::find(const ResourceId &id) {
     if (!_keyFile.find(id, key)) {
         return nullptr;
     }
-    shared_ptr<ByteArray> result;
+    return getBif(key.bifIdx).getResourceData(key.resIdx);
+}
 
-    auto maybeBif = _bifCache.find(key.bifIdx);
-    if (maybeBif != _bifCache.end()) {
-        result = maybeBif->second->getResourceData(key.resIdx);
+ByteView KeyBifResourceProvider::findView(const ResourceId &id) {
+    KeyReader::KeyEntry key;
+    if (!_keyFile.find(id, key)) {
+        return ByteView();
+    }
+    return getBif(key.bifIdx).getResourceView(key.resIdx);
+}
 
-    } else {
-        string filename(_keyFile.getFilename(key.bifIdx).c_str());
-        boost::replace_all(filename, "\\", "/");
+void KeyBifResourceProvider::forEachEntry(const function<void(const ResourceId &, int)> &fn) const {
+    _keyFile.forEachKey(fn);
+}
 
-        fs::path bifPath(getPathIgnoreCase(_gamePath, filename));
-        if (bifPath.empty()) {
-            throw runtime_error(str(boost::format("BIF file not found: %s %s") % _gamePath % filename));
-        }
+shared_ptr<ByteArray> KeyBifResourceProvider::readEntry(int entryIdx) {
+    const KeyReader::KeyEntry &key = _keyFile.keys()[entryIdx];
+    return getBif(key.bifIdx).getResourceData(key.resIdx);
+}
+
+ByteView KeyBifResourceProvider::readEntryView(int entryIdx) {
+    const KeyReader::KeyEntry &key = _keyFile.keys()[entryIdx];
+    return getBif(key.bifIdx).getResourceView(key.resIdx);
+}
 
-        auto bif = make_unique<BifReader>();
-        bif->load(bifPath);
+BifReader &KeyBifResourceProvider::getBif(int bifIdx) {
+    // BIF readers are never removed from cache, so references remain valid after unlocking
+    lock_guard<mutex> lock(_bifCacheMutex);
 
-        result = bif->getResourceData(key.resIdx);
+    auto maybeBif = _bifCache.find(bifIdx);
+    if (maybeBif != _bifCache.end()) {
+        return *maybeBif->second;
+    }
+    string filename(_keyFile.getFilename(bifIdx).c_str());
+    boost::replace_all(filename, "\\", "/");
 
-        _bifCache.insert(make_pair(key.bifIdx, move(bif)));
+    fs::path bifPath(getPathIgnoreCase(_gamePath, filename));
+    if (bifPath.empty()) {
+        throw runtime_error(str(boost::format("BIF file not found: %s %s") % _gamePath % filename));
     }
 
-    return move(result);
+    auto bif = make_unique<BifReader>();
+    bif->load(bifPath);
+
+    return *_bifCache.insert(make_pair(bifIdx, move(bif))).first->second;
 }
 
 } // namespace resource
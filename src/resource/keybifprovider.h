@@ -32,9 +32,17 @@ public:
         _id(id) {
     }
 
-    void init(const boost::filesystem::path &keyPath);
+    /**
+     * @param indexCache optional cache of the KEY file index
+     */
+    void init(const boost::filesystem::path &keyPath, IndexCache *indexCache = nullptr);
 
     std::shared_ptr<ByteArray> find(const ResourceId &id) override;
+    ByteView findView(const ResourceId &id) override;
+
+    void forEachEntry(const std::function<void(const ResourceId &, int)> &fn) const override;
+    std::shared_ptr<ByteArray> readEntry(int entryIdx) override;
+    ByteView readEntryView(int entryIdx) override;
 
     int getId() const override { return _id; }
 
@@ -44,6 +52,9 @@ private:
     boost::filesystem::path _gamePath;
     KeyReader _keyFile;
     std::unordered_map<int, std::unique_ptr<BifReader>> _bifCache;
+    std::mutex _bifCacheMutex;
+
+    BifReader &getBif(int bifIdx);
 };
 
 } // namespace resource
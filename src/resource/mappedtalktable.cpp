@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "mappedtalktable.h"
+
+#include "../common/mappedfile.h"
+
+using namespace std;
+
+namespace fs = boost::filesystem;
+
+namespace reone {
+
+namespace resource {
+
+static constexpr char kSignature[] = "TLK V3.0";
+static constexpr int kSignatureSize = 8;
+static constexpr int kHeaderSize = 20;
+static constexpr int kEntrySize = 40;
+
+struct StringFlags {
+    static constexpr int textPresent = 1;
+    static constexpr int soundPresent = 2;
+    static constexpr int soundLengthPresent = 4;
+};
+
+static uint32_t getUint32(const char *data) {
+    uint32_t val;
+    memcpy(&val, data, sizeof(val));
+    boost::endian::little_to_native_inplace(val);
+    return val;
+}
+
+void MappedTalkTable::load(const fs::path &path) {
+    _file = make_shared<MappedFile>(path);
+    _data = _file->view();
+
+    if (_data.size < kHeaderSize || strncmp(_data.data, kSignature, kSignatureSize) != 0) {
+        throw runtime_error("Invalid TLK file: " + path.string());
+    }
+    uint32_t stringCount = getUint32(_data.data + 12);
+    _stringsOffset = getUint32(_data.data + 16);
+
+    if (kHeaderSize + static_cast<uint64_t>(kEntrySize) * stringCount > _data.size || _stringsOffset > _data.size) {
+        throw runtime_error("TLK file is truncated: " + path.string());
+    }
+    _stringCount = static_cast<int>(stringCount);
+}
+
+const char *MappedTalkTable::getEntry(int index) const {
+    if (index < 0 || index >= _stringCount) {
+        throw out_of_range("index is out of range");
+    }
+    return _data.data + kHeaderSize + static_cast<size_t>(kEntrySize) * index;
+}
+
+ByteView MappedTalkTable::getText(int index) const {
+    const char *entry = getEntry(index);
+
+    uint32_t flags = getUint32(entry);
+    if (!(flags & StringFlags::textPresent)) {
+        return ByteView(entry, 0, _data.owner);
+    }
+    uint32_t stringOffset = getUint32(entry + 28);
+    uint32_t stringSize = getUint32(entry + 32);
+
+    return _data.slice(static_cast<size_t>(_stringsOffset) + stringOffset, stringSize);
+}
+
+string MappedTalkTable::getSoundResRef(int index) const {
+    const char *entry = getEntry(index);
+
+    uint32_t flags = getUint32(entry);
+    if (!(flags & StringFlags::soundPresent)) {
+        return "";
+    }
+    const char *soundResRef = entry + 4;
+    string result(soundResRef, strnlen(soundResRef, 16));
+    boost::to_lower(result);
+
+    return move(result);
+}
+
+} // namespace resource
+
+} // namespace reone
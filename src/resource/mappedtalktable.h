@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../common/types.h"
+
+namespace reone {
+
+class MappedFile;
+
+namespace resource {
+
+/**
+ * Talk table backed by a memory-mapped TLK file. Only the fixed-size entry
+ * table is read on load, string data is accessed on demand.
+ */
+class MappedTalkTable : boost::noncopyable {
+public:
+    void load(const boost::filesystem::path &path);
+
+    int getStringCount() const { return _stringCount; }
+
+    /**
+     * @return view into the text of the string at the specified index
+     * @throws std::out_of_range if index is out of range
+     */
+    ByteView getText(int index) const;
+
+    /**
+     * @return lowercase ResRef of the sound of the string at the specified index
+     * @throws std::out_of_range if index is out of range
+     */
+    std::string getSoundResRef(int index) const;
+
+private:
+    std::shared_ptr<MappedFile> _file;
+    ByteView _data;
+    int _stringCount {0};
+    uint32_t _stringsOffset {0};
+
+    const char *getEntry(int index) const;
+};
+
+} // namespace resource
+
+} // namespace reone
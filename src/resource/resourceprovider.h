@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "../common/streamutil.h"
 #include "../common/types.h"
 
 #include "id.h"
@@ -36,6 +37,38 @@ public:
 
     virtual std::shared_ptr<ByteArray> find(const ResourceId &id) = 0;
 
+    /**
+     * Providers backed by memory-mapped archives override this to return views
+     * into the mapping, avoiding a copy of resource data.
+     *
+     * @return read-only view into resource data, or an empty view if not found
+     */
+    virtual ByteView findView(const ResourceId &id) {
+        return makeView(find(id));
+    }
+
+    /**
+     * Invokes the function once for every distinct resource of this provider,
+     * passing its id and an entry index, that can be passed to readEntry.
+     */
+    virtual void forEachEntry(const std::function<void(const ResourceId &, int)> &fn) const = 0;
+
+    /**
+     * Implementations must be safe to call concurrently, as must readEntryView.
+     *
+     * @param entryIdx entry index, as reported by forEachEntry
+     * @return resource data of the entry
+     */
+    virtual std::shared_ptr<ByteArray> readEntry(int entryIdx) = 0;
+
+    /**
+     * @param entryIdx entry index, as reported by forEachEntry
+     * @return read-only view into resource data of the entry
+     */
+    virtual ByteView readEntryView(int entryIdx) {
+        return makeView(readEntry(entryIdx));
+    }
+
     virtual int getId() const = 0;
 };
 
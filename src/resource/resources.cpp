@@ -40,7 +40,7 @@ void Resources::indexKeyFile(const fs::path &path) {
         return;
     }
     auto keyBif = make_unique<KeyBifResourceProvider>(static_cast<int>(_providers.size()));
-    keyBif->init(path);
+    keyBif->init(path, _indexCache.get());
     indexProvider(move(keyBif), path);
 }
 
@@ -49,6 +49,7 @@ void Resources::indexErfFile(const fs::path &path, bool transient) {
         return;
     }
     auto erf = make_unique<ErfReader>(_providers.size());
+    erf->setIndexCache(_indexCache.get());
     erf->load(path);
     indexProvider(move(erf), path, transient);
 }
@@ -58,6 +59,7 @@ void Resources::indexRimFile(const fs::path &path, bool transient) {
         return;
     }
     auto rim = make_unique<RimReader>(_providers.size());
+    rim->setIndexCache(_indexCache.get());
     rim->load(path);
     indexProvider(move(rim), path, transient);
 }
@@ -75,12 +77,20 @@ void Resources::indexExeFile(const fs::path &path) {
     if (!fs::exists(path)) {
         return;
     }
+    unique_lock<shared_mutex> lock(_mutex);
     _exeFile.load(path);
     debug("Index executable " + path.string(), LogChannels::resources);
 }
 
+void Resources::setIndexCacheDirectory(fs::path directory) {
+    _indexCache = make_unique<IndexCache>(move(directory));
+}
+
 void Resources::indexProvider(unique_ptr<IResourceProvider> &&provider, const fs::path &path, bool transient) {
+    unique_lock<shared_mutex> lock(_mutex);
+
     debug(boost::format("Index provider %d at '%s'") % provider->getId() % path.string(), LogChannels::resources);
+    indexEntries(*provider, transient);
     if (transient) {
         _transientProviders.push_back(move(provider));
     } else {
@@ -88,46 +98,163 @@ void Resources::indexProvider(unique_ptr<IResourceProvider> &&provider, const fs
     }
 }
 
+void Resources::indexEntries(IResourceProvider &provider, bool transient) {
+    provider.forEachEntry([&](const ResourceId &id, int entryIdx) {
+        IndexEntry entry;
+        entry.provider = &provider;
+        entry.entryIdx = entryIdx;
+        entry.transient = transient;
+
+        auto maybeEntry = _index.find(id);
+        if (maybeEntry == _index.end()) {
+            _index.insert(make_pair(id, move(entry)));
+            if (transient) {
+                _transientIds.push_back(id);
+            }
+            return;
+        }
+        // Later providers take precedence, but transient providers never override non-transient ones
+        if (transient && !maybeEntry->second.transient) {
+            return;
+        }
+        maybeEntry->second = move(entry);
+    });
+}
+
 void Resources::clearTransientProviders() {
+    unique_lock<shared_mutex> lock(_mutex);
+
+    for (auto &id : _transientIds) {
+        auto maybeEntry = _index.find(id);
+        if (maybeEntry != _index.end() && maybeEntry->second.transient) {
+            _index.erase(maybeEntry);
+        }
+    }
+    _transientIds.clear();
+
     for (auto &provider : _transientProviders) {
         debug("Remove provider " + to_string(provider->getId()), LogChannels::resources);
     }
     _transientProviders.clear();
 }
 
+const Resources::IndexEntry *Resources::findIndexEntry(const ResourceId &id) const {
+    auto maybeEntry = _index.find(id);
+    return maybeEntry != _index.end() ? &maybeEntry->second : nullptr;
+}
+
+int Resources::read(const ResourceId &id, shared_ptr<ByteArray> &data) {
+    shared_lock<shared_mutex> lock(_mutex);
+
+    const IndexEntry *entry = findIndexEntry(id);
+    if (!entry) {
+        return -1;
+    }
+    data = entry->provider->readEntry(entry->entryIdx);
+
+    return entry->provider->getId();
+}
+
+int Resources::readView(const ResourceId &id, ByteView &view) {
+    shared_lock<shared_mutex> lock(_mutex);
+
+    const IndexEntry *entry = findIndexEntry(id);
+    if (!entry) {
+        return -1;
+    }
+    view = entry->provider->readEntryView(entry->entryIdx);
+
+    return entry->provider->getId();
+}
+
+static void logRead(const ResourceId &id, int providerId, bool logNotFound) {
+    if (providerId == -1) {
+        if (logNotFound) {
+            warn("Resource '" + id.string() + "' not found", LogChannels::resources);
+        }
+        return;
+    }
+    debug(boost::format("Resource '%s' found in provider %d") % id.string() % providerId, LogChannels::resources2);
+}
+
 shared_ptr<ByteArray> Resources::get(const string &resRef, ResourceType type, bool logNotFound) {
     if (resRef.empty()) {
         return nullptr;
     }
     ResourceId id(resRef, type);
-    shared_ptr<ByteArray> data(getFromProviders(id, _providers));
-    if (!data) {
-        data = getFromProviders(id, _transientProviders);
-    }
-    if (!data && logNotFound) {
-        warn("Resource '" + id.string() + "' not found", LogChannels::resources);
+    shared_ptr<ByteArray> data;
+    int providerId = read(id, data);
+    logRead(id, providerId, logNotFound);
+
+    return data;
+}
+
+ByteView Resources::getView(const string &resRef, ResourceType type, bool logNotFound) {
+    if (resRef.empty()) {
+        return ByteView();
     }
-    return move(data);
+    ResourceId id(resRef, type);
+    ByteView view;
+    int providerId = readView(id, view);
+    logRead(id, providerId, logNotFound);
+
+    return view;
 }
 
-shared_ptr<ByteArray> Resources::getFromExe(uint32_t name, PEResourceType type) {
-    auto data = _exeFile.find(name, type);
-    if (!data) {
-        warn(boost::format("Resource %u of type %d not found in EXE") % name % static_cast<int>(type), LogChannels::resources);
-        return nullptr;
+static constexpr size_t kPageSize = 4096;
+
+/**
+ * Touches every page of a view, so that memory-mapped data is read from disk.
+ */
+static void touchPages(const ByteView &view) {
+    [[maybe_unused]] volatile char sink = 0;
+    for (size_t off = 0; off < view.size; off += kPageSize) {
+        sink = view.data[off];
+    }
+    if (view.size > 0) {
+        sink = view.data[view.size - 1];
     }
-    return move(data);
 }
 
-shared_ptr<ByteArray> Resources::getFromProviders(const ResourceId &id, const vector<unique_ptr<IResourceProvider>> &providers) {
-    for (auto provider = providers.rbegin(); provider != providers.rend(); ++provider) {
-        shared_ptr<ByteArray> data((*provider)->find(id));
-        if (data) {
-            debug(boost::format("Resource '%s' found in provider %d") % id.string() % (*provider)->getId(), LogChannels::resources2);
-            return data;
+vector<future<ByteView>> Resources::prefetch(const vector<ResourceId> &ids) {
+    {
+        unique_lock<shared_mutex> lock(_mutex);
+        if (!_prefetchPool) {
+            _prefetchPool = make_unique<ThreadPool>();
         }
     }
-    return nullptr;
+    vector<future<ByteView>> result;
+    result.reserve(ids.size());
+
+    for (auto &id : ids) {
+        result.push_back(_prefetchPool->enqueue([this, id]() {
+            ByteView view;
+            readView(id, view);
+            touchPages(view);
+
+            return view;
+        }));
+    }
+
+    return result;
+}
+
+bool Resources::isTransient(const string &resRef, ResourceType type) const {
+    shared_lock<shared_mutex> lock(_mutex);
+    auto maybeEntry = _index.find(ResourceId(resRef, type));
+    return maybeEntry != _index.end() && maybeEntry->second.transient;
+}
+
+shared_ptr<ByteArray> Resources::getFromExe(uint32_t name, PEResourceType type) {
+    shared_ptr<ByteArray> data;
+    {
+        shared_lock<shared_mutex> lock(_mutex); // executable is memory-mapped, so reads are positional
+        data = _exeFile.find(name, type);
+    }
+    if (!data) {
+        warn(boost::format("Resource %u of type %d not found in EXE") % name % static_cast<int>(type), LogChannels::resources);
+    }
+    return data;
 }
 
 } // namespace resource
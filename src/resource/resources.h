@@ -17,10 +17,12 @@
 
 #pragma once
 
+#include "../common/threadpool.h"
 #include "../common/types.h"
 
 #include "format/pereader.h"
 #include "id.h"
+#include "indexcache.h"
 #include "resourceprovider.h"
 #include "types.h"
 
@@ -28,6 +30,12 @@ namespace reone {
 
 namespace resource {
 
+/**
+ * Merged index of resource providers. Indexing and clearing providers is
+ * exclusive, while lookups and reads share a lock. Because get, getView and
+ * getFromExe log, they must be called from the main thread. Worker threads
+ * only read resources through prefetch.
+ */
 class Resources : boost::noncopyable {
 public:
     void indexKeyFile(const boost::filesystem::path &path);
@@ -36,20 +44,78 @@ public:
     void indexDirectory(const boost::filesystem::path &path);
     void indexExeFile(const boost::filesystem::path &path);
 
+    /**
+     * Enables caching of KEY, ERF and RIM indices in the specified directory.
+     */
+    void setIndexCacheDirectory(boost::filesystem::path directory);
+
     void invalidate();
     void clearTransientProviders();
 
     std::shared_ptr<ByteArray> get(const std::string &resRef, ResourceType type, bool logNotFound = true);
+
+    /**
+     * Same as get, but avoids copying resource data when it comes from a
+     * memory-mapped archive.
+     *
+     * @return read-only view into resource data, or an empty view if not found
+     */
+    ByteView getView(const std::string &resRef, ResourceType type, bool logNotFound = true);
+
+    /**
+     * Reads the specified resources in a pool of worker threads, so that
+     * subsequent get and getView calls do not block on I/O. Resources that
+     * are not found resolve to empty views.
+     *
+     * @return futures of views into resource data, in order of ids
+     */
+    std::vector<std::future<ByteView>> prefetch(const std::vector<ResourceId> &ids);
+
     std::shared_ptr<ByteArray> getFromExe(uint32_t name, PEResourceType type);
 
+    /**
+     * @return true if the resource is found in a transient provider, i.e. may change when switching between modules
+     */
+    bool isTransient(const std::string &resRef, ResourceType type) const;
+
 private:
+    /**
+     * Location of a resource within the provider that takes precedence.
+     */
+    struct IndexEntry {
+        IResourceProvider *provider {nullptr};
+        int entryIdx {0};
+        bool transient {false};
+    };
+
     PEReader _exeFile;
+    std::unique_ptr<IndexCache> _indexCache;
     std::vector<std::unique_ptr<IResourceProvider>> _providers;
     std::vector<std::unique_ptr<IResourceProvider>> _transientProviders; /**< transient providers are replaced when switching between modules */
 
+    std::unordered_map<ResourceId, IndexEntry, ResourceIdHasher> _index; /**< merged index of all providers */
+    std::vector<ResourceId> _transientIds; /**< resources indexed from transient providers */
+
+    mutable std::shared_mutex _mutex; /**< guards providers and the index */
+    std::unique_ptr<ThreadPool> _prefetchPool; /**< declared last, so that workers are joined first */
+
     void indexProvider(std::unique_ptr<IResourceProvider> &&provider, const boost::filesystem::path &path, bool transient = false);
+    void indexEntries(IResourceProvider &provider, bool transient);
+
+    const IndexEntry *findIndexEntry(const ResourceId &id) const;
+
+    /**
+     * Reads resource data under a shared lock, without logging, so that
+     * worker threads can call it.
+     *
+     * @return id of the provider that the resource was read from, or -1 if not found
+     */
+    int read(const ResourceId &id, std::shared_ptr<ByteArray> &data);
 
-    std::shared_ptr<ByteArray> getFromProviders(const ResourceId &id, const std::vector<std::unique_ptr<IResourceProvider>> &providers);
+    /**
+     * Same as read, but returns a view into resource data.
+     */
+    int readView(const ResourceId &id, ByteView &view);
 };
 
 } // namespace resource
@@ -19,9 +19,9 @@
 
 #include "../common/exception/validation.h"
 #include "../common/pathutil.h"
-#include "../resource/talktable.h"
 
 using namespace std;
+using namespace std::placeholders;
 
 namespace fs = boost::filesystem;
 
@@ -29,57 +29,69 @@ namespace reone {
 
 namespace resource {
 
+static constexpr size_t kTextCacheByteBudget = 1024 * 1024;
+
+static CachePolicy<int, string> getTextCachePolicy() {
+    CachePolicy<int, string> policy;
+    policy.byteBudget = kTextCacheByteBudget;
+    policy.sizeOf = [](const string &text) { return sizeof(string) + text.capacity(); };
+    return move(policy);
+}
+
+Strings::Strings() :
+    _texts(bind(&Strings::doGetText, this, _1), getTextCachePolicy()) {
+}
+
 void Strings::init(const fs::path &gameDir) {
     fs::path tlkPath(getPathIgnoreCase(gameDir, "dialog.tlk"));
     if (tlkPath.empty()) {
         throw ValidationException("dialog.tlk file not found");
     }
     _tlk.load(tlkPath);
+    _texts.clear();
 }
 
 string Strings::get(int strRef) {
-    shared_ptr<TalkTable> table(_tlk.table());
-    if (strRef < 0 || strRef >= table->getStringCount())
+    if (strRef < 0 || strRef >= _tlk.getStringCount())
         return "";
 
-    string text(table->getString(strRef).text);
-    process(text);
+    return *_texts.get(strRef);
+}
 
-    return move(text);
+shared_ptr<string> Strings::doGetText(int strRef) {
+    ByteView text(_tlk.getText(strRef));
+    _textBuffer.clear();
+    process(text.data, text.size, _textBuffer);
+    return make_shared<string>(_textBuffer);
 }
 
 string Strings::getSound(int strRef) {
-    shared_ptr<TalkTable> table(_tlk.table());
-    if (strRef < 0 || strRef >= table->getStringCount())
+    if (strRef < 0 || strRef >= _tlk.getStringCount())
         return "";
 
-    return table->getString(strRef).soundResRef;
+    return _tlk.getSoundResRef(strRef);
 }
 
-void Strings::process(string &str) {
-    stripDeveloperNotes(str);
+void Strings::process(const char *text, size_t len, string &out) {
+    stripDeveloperNotes(text, len, out);
 }
 
-void Strings::stripDeveloperNotes(string &str) {
-    do {
-        size_t openBracketIdx = str.find_first_of('{', 0);
-        if (openBracketIdx == -1)
+void Strings::stripDeveloperNotes(const char *text, size_t len, string &out) {
+    const char *end = text + len;
+    const char *pch = text;
+    while (pch < end) {
+        auto openBracket = static_cast<const char *>(memchr(pch, '{', end - pch));
+        if (!openBracket)
             break;
 
-        size_t closeBracketIdx = str.find_first_of('}', static_cast<int64_t>(openBracketIdx) + 1);
-        if (closeBracketIdx == -1)
+        auto closeBracket = static_cast<const char *>(memchr(openBracket + 1, '}', end - openBracket - 1));
+        if (!closeBracket)
             break;
 
-        int textLen = static_cast<int>(str.size());
-        size_t noteLen = closeBracketIdx - openBracketIdx + 1;
-
-        for (size_t i = openBracketIdx; i + noteLen < textLen; ++i) {
-            str[i] = str[i + noteLen];
-        }
-
-        str.resize(textLen - noteLen);
-
-    } while (true);
+        out.append(pch, openBracket);
+        pch = closeBracket + 1;
+    }
+    out.append(pch, end);
 }
 
 } // namespace resource
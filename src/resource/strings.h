@@ -17,8 +17,9 @@
 
 #pragma once
 
-#include "format/tlkreader.h"
+#include "../common/memorycache.h"
 
+#include "mappedtalktable.h"
 #include "types.h"
 
 namespace reone {
@@ -27,7 +28,7 @@ namespace resource {
 
 class Strings {
 public:
-    Strings() = default;
+    Strings();
 
     void init(const boost::filesystem::path &gameDir);
 
@@ -46,10 +47,18 @@ public:
     std::string getSound(int strRef);
 
 private:
-    TlkReader _tlk;
+    MappedTalkTable _tlk;
+    MemoryCache<int, std::string> _texts; /**< processed texts, by StrRef */
+    std::string _textBuffer;
 
-    void process(std::string &str);
-    void stripDeveloperNotes(std::string &str);
+    std::shared_ptr<std::string> doGetText(int strRef);
+
+    void process(const char *text, size_t len, std::string &out);
+
+    /**
+     * Appends text to out, excluding developer notes in curly braces.
+     */
+    void stripDeveloperNotes(const char *text, size_t len, std::string &out);
 };
 
 } // namespace resource
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "broadphase.h"
+
+#include "node/walkmesh.h"
+
+using namespace std;
+
+using namespace reone::graphics;
+
+namespace reone {
+
+namespace scene {
+
+static constexpr float kCellSize = 8.0f;
+
+static uint64_t getCellKey(int x, int y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+static AABB getWorldBounds(const WalkmeshSceneNode &node) {
+    return node.walkmesh().aabb() * node.absoluteTransform();
+}
+
+static bool intersectSegment(const AABB &bounds, const glm::vec3 &start, const glm::vec3 &end) {
+    if (bounds.isEmpty()) {
+        return false;
+    }
+    if (bounds.contains(start)) {
+        return true;
+    }
+    glm::vec3 startToEnd(end - start);
+    float length = glm::length(startToEnd);
+    if (length == 0.0f) {
+        return false;
+    }
+    float distance = 0.0f;
+    return bounds.raycast(start, startToEnd / length, length, distance);
+}
+
+void WalkmeshBroadphase::add(WalkmeshSceneNode &node) {
+    if (_entries.count(&node) > 0) {
+        return;
+    }
+    Entry entry;
+    entry.bounds = getWorldBounds(node);
+    entry.cells = getCellRange(entry.bounds.min(), entry.bounds.max());
+    if (!entry.bounds.isEmpty()) {
+        insertIntoCells(node, entry.cells);
+    }
+    _entries.insert(make_pair(&node, move(entry)));
+}
+
+void WalkmeshBroadphase::remove(WalkmeshSceneNode &node) {
+    auto maybeEntry = _entries.find(&node);
+    if (maybeEntry == _entries.end()) {
+        return;
+    }
+    if (!maybeEntry->second.bounds.isEmpty()) {
+        removeFromCells(node, maybeEntry->second.cells);
+    }
+    _entries.erase(maybeEntry);
+}
+
+void WalkmeshBroadphase::update(WalkmeshSceneNode &node) {
+    auto maybeEntry = _entries.find(&node);
+    if (maybeEntry == _entries.end()) {
+        return;
+    }
+    Entry &entry = maybeEntry->second;
+    if (!entry.bounds.isEmpty()) {
+        removeFromCells(node, entry.cells);
+    }
+    entry.bounds = getWorldBounds(node);
+    entry.cells = getCellRange(entry.bounds.min(), entry.bounds.max());
+    if (!entry.bounds.isEmpty()) {
+        insertIntoCells(node, entry.cells);
+    }
+}
+
+void WalkmeshBroadphase::clear() {
+    _entries.clear();
+    _cells.clear();
+}
+
+void WalkmeshBroadphase::querySegment(const glm::vec3 &start, const glm::vec3 &end, vector<WalkmeshSceneNode *> &outNodes) const {
+    CellRange cells(getCellRange(glm::min(start, end), glm::max(start, end)));
+    for (int y = cells.minY; y <= cells.maxY; ++y) {
+        for (int x = cells.minX; x <= cells.maxX; ++x) {
+            auto maybeCell = _cells.find(getCellKey(x, y));
+            if (maybeCell == _cells.end()) {
+                continue;
+            }
+            for (auto &node : maybeCell->second) {
+                if (find(outNodes.begin(), outNodes.end(), node) != outNodes.end()) {
+                    continue;
+                }
+                if (intersectSegment(_entries.find(node)->second.bounds, start, end)) {
+                    outNodes.push_back(node);
+                }
+            }
+        }
+    }
+}
+
+void WalkmeshBroadphase::insertIntoCells(WalkmeshSceneNode &node, const CellRange &cells) {
+    for (int y = cells.minY; y <= cells.maxY; ++y) {
+        for (int x = cells.minX; x <= cells.maxX; ++x) {
+            _cells[getCellKey(x, y)].push_back(&node);
+        }
+    }
+}
+
+void WalkmeshBroadphase::removeFromCells(WalkmeshSceneNode &node, const CellRange &cells) {
+    for (int y = cells.minY; y <= cells.maxY; ++y) {
+        for (int x = cells.minX; x <= cells.maxX; ++x) {
+            auto maybeCell = _cells.find(getCellKey(x, y));
+            if (maybeCell == _cells.end()) {
+                continue;
+            }
+            auto &nodes = maybeCell->second;
+            nodes.erase(std::remove(nodes.begin(), nodes.end(), &node), nodes.end());
+            if (nodes.empty()) {
+                _cells.erase(maybeCell);
+            }
+        }
+    }
+}
+
+WalkmeshBroadphase::CellRange WalkmeshBroadphase::getCellRange(const glm::vec3 &min, const glm::vec3 &max) const {
+    CellRange cells;
+    cells.minX = static_cast<int>(glm::floor(min.x / kCellSize));
+    cells.minY = static_cast<int>(glm::floor(min.y / kCellSize));
+    cells.maxX = static_cast<int>(glm::floor(max.x / kCellSize));
+    cells.maxY = static_cast<int>(glm::floor(max.y / kCellSize));
+    return move(cells);
+}
+
+} // namespace scene
+
+} // namespace reone
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../graphics/aabb.h"
+
+namespace reone {
+
+namespace scene {
+
+class WalkmeshSceneNode;
+
+/**
+ * Uniform grid over the XY plane that indexes walkmesh scene nodes by their
+ * world bounds. Collision queries use it to find nodes whose bounds are
+ * intersected by a segment, so that their cost does not depend on the total
+ * number of walkmeshes in the scene.
+ *
+ * Queries do not modify the grid and may run concurrently with each other.
+ */
+class WalkmeshBroadphase : boost::noncopyable {
+public:
+    void add(WalkmeshSceneNode &node);
+    void remove(WalkmeshSceneNode &node);
+
+    /**
+     * Recomputes world bounds of the node, unless it has not been added.
+     */
+    void update(WalkmeshSceneNode &node);
+
+    void clear();
+
+    /**
+     * Appends nodes whose world bounds are intersected by the segment to
+     * outNodes, omitting duplicates.
+     */
+    void querySegment(const glm::vec3 &start, const glm::vec3 &end, std::vector<WalkmeshSceneNode *> &outNodes) const;
+
+private:
+    struct CellRange {
+        int minX {0};
+        int minY {0};
+        int maxX {0};
+        int maxY {0};
+    };
+
+    struct Entry {
+        graphics::AABB bounds;
+        CellRange cells;
+    };
+
+    std::unordered_map<WalkmeshSceneNode *, Entry> _entries;
+    std::unordered_map<uint64_t, std::vector<WalkmeshSceneNode *>> _cells;
+
+    void insertIntoCells(WalkmeshSceneNode &node, const CellRange &cells);
+    void removeFromCells(WalkmeshSceneNode &node, const CellRange &cells);
+
+    CellRange getCellRange(const glm::vec3 &min, const glm::vec3 &max) const;
+};
+
+} // namespace scene
+
+} // namespace reone
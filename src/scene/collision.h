@@ -30,6 +30,28 @@ struct Collision {
     int material {-1};
 };
 
+/**
+ * Line of sight query, tested in batches by SceneGraph.
+ */
+struct LineOfSightQuery {
+    glm::vec3 origin {0.0f};
+    glm::vec3 dest {0.0f};
+
+    bool collided {false};
+    Collision collision;
+
+    /**
+     * @param target user of the destination
+     * @return true if target is visible from origin, i.e. nothing was hit,
+     *         target itself was hit, or the hit lies beyond the destination
+     */
+    bool isVisible(const IUser *target) const {
+        return !collided ||
+               collision.user == target ||
+               glm::distance2(origin, dest) < glm::distance2(origin, collision.intersection);
+    }
+};
+
 } // namespace scene
 
 } // namespace reone
@@ -17,6 +17,7 @@
 
 #include "graph.h"
 
+#include "../common/threadpool.h"
 #include "../graphics/context.h"
 #include "../graphics/mesh.h"
 #include "../graphics/meshes.h"
@@ -55,14 +56,16 @@ static constexpr float kLightRadiusBias = 64.0f;
 static constexpr float kLightRadiusBias2 = kLightRadiusBias * kLightRadiusBias;
 
 static constexpr float kMaxCollisionDistanceWalk = 8.0f;
-static constexpr float kMaxCollisionDistanceWalk2 = kMaxCollisionDistanceWalk * kMaxCollisionDistanceWalk;
 
 static constexpr float kMaxCollisionDistanceLineOfSight = 16.0f;
 static constexpr float kMaxCollisionDistanceLineOfSight2 = kMaxCollisionDistanceLineOfSight * kMaxCollisionDistanceLineOfSight;
 
+static constexpr int kMinLineOfSightQueriesPerTask = 16;
+
 void SceneGraph::clear() {
     _modelRoots.clear();
     _walkmeshRoots.clear();
+    _walkmeshBroadphase.clear();
     _soundRoots.clear();
     _grassRoots.clear();
     _activeLights.clear();
@@ -73,6 +76,7 @@ void SceneGraph::addRoot(shared_ptr<ModelSceneNode> node) {
 }
 
 void SceneGraph::addRoot(shared_ptr<WalkmeshSceneNode> node) {
+    _walkmeshBroadphase.add(*node);
     _walkmeshRoots.insert(move(node));
 }
 
@@ -101,6 +105,7 @@ void SceneGraph::removeRoot(const shared_ptr<ModelSceneNode> &node) {
 }
 
 void SceneGraph::removeRoot(const shared_ptr<WalkmeshSceneNode> &node) {
+    _walkmeshBroadphase.remove(*node);
     _walkmeshRoots.erase(node);
 }
 
@@ -116,6 +121,10 @@ void SceneGraph::removeRoot(const shared_ptr<SoundSceneNode> &node) {
     _soundRoots.erase(node);
 }
 
+void SceneGraph::updateRoot(WalkmeshSceneNode &node) {
+    _walkmeshBroadphase.update(node);
+}
+
 void SceneGraph::update(float dt) {
     if (_updateRoots) {
         for (auto &root : _modelRoots) {
@@ -521,57 +530,59 @@ bool SceneGraph::testElevation(const glm::vec2 &position, Collision &outCollisio
     static glm::vec3 down(0.0f, 0.0f, -1.0f);
 
     glm::vec3 origin(position, kElevationTestZ);
+    float maxDistance = 2.0f * kElevationTestZ;
+
+    vector<WalkmeshSceneNode *> roots;
+    _walkmeshBroadphase.querySegment(origin, origin + maxDistance * down, roots);
+
+    // Elevation is determined by the topmost face below the position
+    WalkmeshSceneNode *closestRoot = nullptr;
+    const Walkmesh::Face *closestFace = nullptr;
+    float minDistance = maxDistance;
 
-    for (auto &root : _walkmeshRoots) {
+    for (auto &root : roots) {
         if (!root->isEnabled()) {
             continue;
         }
-        if (!root->walkmesh().isAreaWalkmesh()) {
-            float distance2 = root->getSquareDistanceTo2D(position);
-            if (distance2 > kMaxCollisionDistanceWalk2) {
-                continue;
-            }
-        }
         auto objSpaceOrigin = glm::vec3(root->absoluteTransformInverse() * glm::vec4(origin, 1.0f));
         float distance = 0.0f;
-        auto face = root->walkmesh().raycast(_walkcheckSurfaces, objSpaceOrigin, down, 2.0f * kElevationTestZ, distance);
+        auto face = root->walkmesh().raycast(_walkcheckSurfaces, objSpaceOrigin, down, minDistance, distance);
         if (face) {
-            if (_walkableSurfaces.count(face->material) == 0) {
-                // non-walkable
-                return false;
-            }
-            outCollision.user = root->user();
-            outCollision.intersection = origin + distance * down;
-            outCollision.normal = root->absoluteTransform() * glm::vec4(face->normal, 0.0f);
-            outCollision.material = face->material;
-            return true;
+            closestRoot = root;
+            closestFace = face;
+            minDistance = distance;
         }
     }
+    if (!closestFace || _walkableSurfaces.count(closestFace->material) == 0) {
+        return false;
+    }
+
+    outCollision.user = closestRoot->user();
+    outCollision.intersection = origin + minDistance * down;
+    outCollision.normal = closestRoot->absoluteTransform() * glm::vec4(closestFace->normal, 0.0f);
+    outCollision.material = closestFace->material;
 
-    return false;
+    return true;
 }
 
 bool SceneGraph::testLineOfSight(const glm::vec3 &origin, const glm::vec3 &dest, Collision &outCollision) const {
     glm::vec3 originToDest(dest - origin);
     glm::vec3 dir(glm::normalize(originToDest));
     float maxDistance = glm::length(originToDest);
-    float minDistance = numeric_limits<float>::max();
+    float minDistance = maxDistance;
+
+    vector<WalkmeshSceneNode *> roots;
+    _walkmeshBroadphase.querySegment(origin, dest, roots);
 
-    for (auto &root : _walkmeshRoots) {
+    for (auto &root : roots) {
         if (!root->isEnabled()) {
             continue;
         }
-        if (!root->walkmesh().isAreaWalkmesh()) {
-            float distance2 = root->getSquareDistanceTo(origin);
-            if (distance2 > kMaxCollisionDistanceLineOfSight2) {
-                continue;
-            }
-        }
         glm::vec3 objSpaceOrigin(root->absoluteTransformInverse() * glm::vec4(origin, 1.0f));
         glm::vec3 objSpaceDir(root->absoluteTransformInverse() * glm::vec4(dir, 0.0f));
         float distance = 0.0f;
-        auto face = root->walkmesh().raycast(_lineOfSightSurfaces, objSpaceOrigin, objSpaceDir, maxDistance, distance);
-        if (!face || distance > minDistance) {
+        auto face = root->walkmesh().raycast(_lineOfSightSurfaces, objSpaceOrigin, objSpaceDir, minDistance, distance);
+        if (!face) {
             continue;
         }
         outCollision.user = root->user();
@@ -581,30 +592,70 @@ bool SceneGraph::testLineOfSight(const glm::vec3 &origin, const glm::vec3 &dest,
         minDistance = distance;
     }
 
-    return minDistance != numeric_limits<float>::max();
+    return minDistance < maxDistance;
+}
+
+void SceneGraph::testLineOfSight(vector<LineOfSightQuery> &queries, ThreadPool *pool) const {
+    auto testRange = [this, &queries](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            LineOfSightQuery &query = queries[i];
+            query.collided = testLineOfSight(query.origin, query.dest, query.collision);
+        }
+    };
+    int numTasks = 1;
+    if (pool) {
+        numTasks = min(pool->numThreads() + 1, static_cast<int>(queries.size()) / kMinLineOfSightQueriesPerTask);
+    }
+    if (numTasks <= 1) {
+        testRange(0, queries.size());
+        return;
+    }
+
+    // Calling thread takes the first chunk, workers take the rest
+    size_t chunkSize = (queries.size() + numTasks - 1) / numTasks;
+    vector<future<void>> results;
+    for (int i = 1; i < numTasks; ++i) {
+        size_t begin = i * chunkSize;
+        size_t end = min(queries.size(), begin + chunkSize);
+        results.push_back(pool->enqueue([&testRange, begin, end]() { testRange(begin, end); }));
+    }
+    exception_ptr error;
+    try {
+        testRange(0, chunkSize);
+    } catch (...) {
+        error = current_exception();
+    }
+
+    // Workers reference queries, so wait for all of them before rethrowing
+    for (auto &result : results) {
+        result.wait();
+    }
+    if (error) {
+        rethrow_exception(error);
+    }
+    for (auto &result : results) {
+        result.get();
+    }
 }
 
 bool SceneGraph::testWalk(const glm::vec3 &origin, const glm::vec3 &dest, const IUser *excludeUser, Collision &outCollision) const {
     glm::vec3 originToDest(dest - origin);
     glm::vec3 dir(glm::normalize(originToDest));
-    float maxDistance = glm::length(originToDest);
-    float minDistance = numeric_limits<float>::max();
+    float maxDistance = glm::min(glm::length(originToDest), kMaxCollisionDistanceWalk);
+    float minDistance = maxDistance;
+
+    vector<WalkmeshSceneNode *> roots;
+    _walkmeshBroadphase.querySegment(origin, origin + maxDistance * dir, roots);
 
-    for (auto &root : _walkmeshRoots) {
+    for (auto &root : roots) {
         if (!root->isEnabled() || root->user() == excludeUser) {
             continue;
         }
-        if (!root->walkmesh().isAreaWalkmesh()) {
-            float distance2 = root->getSquareDistanceTo(origin);
-            if (distance2 > kMaxCollisionDistanceWalk2) {
-                continue;
-            }
-        }
         glm::vec3 objSpaceOrigin(root->absoluteTransformInverse() * glm::vec4(origin, 1.0f));
         glm::vec3 objSpaceDir(root->absoluteTransformInverse() * glm::vec4(dir, 0.0f));
         float distance = 0.0f;
-        auto face = root->walkmesh().raycast(_walkcheckSurfaces, objSpaceOrigin, objSpaceDir, kMaxCollisionDistanceWalk, distance);
-        if (!face || distance > maxDistance || distance > minDistance) {
+        auto face = root->walkmesh().raycast(_walkcheckSurfaces, objSpaceOrigin, objSpaceDir, minDistance, distance);
+        if (!face) {
             continue;
         }
         outCollision.user = root->user();
@@ -614,7 +665,15 @@ bool SceneGraph::testWalk(const glm::vec3 &origin, const glm::vec3 &dest, const
         minDistance = distance;
     }
 
-    return minDistance != numeric_limits<float>::max();
+    return minDistance < maxDistance;
+}
+
+void SceneGraph::setWalkcheckSurfaces(const set<uint32_t> &surfaces) {
+    _walkcheckSurfaces = Walkmesh::getSurfaceMask(surfaces);
+}
+
+void SceneGraph::setLineOfSightSurfaces(const set<uint32_t> &surfaces) {
+    _lineOfSightSurfaces = Walkmesh::getSurfaceMask(surfaces);
 }
 
 shared_ptr<ModelSceneNode> SceneGraph::pickModelAt(int x, int y, IUser *except) const {
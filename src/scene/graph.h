@@ -21,6 +21,8 @@
 #include "../graphics/scene.h"
 #include "../graphics/uniforms.h"
 
+#include "broadphase.h"
+
 #include "node/camera.h"
 #include "node/dummy.h"
 #include "node/emitter.h"
@@ -31,6 +33,8 @@
 
 namespace reone {
 
+class ThreadPool;
+
 namespace graphics {
 
 class GraphicsContext;
@@ -52,6 +56,7 @@ namespace scene {
 
 class Collision;
 class IAnimationEventListener;
+struct LineOfSightQuery;
 class ModelSceneNode;
 class SoundSceneNode;
 class TriggerSceneNode;
@@ -114,6 +119,12 @@ public:
     void removeRoot(const std::shared_ptr<GrassSceneNode> &node);
     void removeRoot(const std::shared_ptr<SoundSceneNode> &node);
 
+    /**
+     * Updates world bounds of the walkmesh root in the collision broadphase.
+     * Must be called whenever the absolute transform of the root changes.
+     */
+    void updateRoot(WalkmeshSceneNode &node);
+
     // END Roots
 
     // Lighting
@@ -156,13 +167,20 @@ public:
 
     bool testElevation(const glm::vec2 &position, Collision &outCollision) const;
     bool testLineOfSight(const glm::vec3 &origin, const glm::vec3 &dest, Collision &outCollision) const;
+
+    /**
+     * Tests line of sight for a batch of queries, storing results in them.
+     * When a thread pool is specified, queries are distributed across its
+     * workers and the calling thread.
+     */
+    void testLineOfSight(std::vector<LineOfSightQuery> &queries, ThreadPool *pool = nullptr) const;
     bool testWalk(const glm::vec3 &origin, const glm::vec3 &dest, const IUser *excludeUser, Collision &outCollision) const;
 
     std::shared_ptr<ModelSceneNode> pickModelAt(int x, int y, IUser *except = nullptr) const;
 
     void setWalkableSurfaces(std::set<uint32_t> surfaces) { _walkableSurfaces = std::move(surfaces); }
-    void setWalkcheckSurfaces(std::set<uint32_t> surfaces) { _walkcheckSurfaces = std::move(surfaces); }
-    void setLineOfSightSurfaces(std::set<uint32_t> surfaces) { _lineOfSightSurfaces = std::move(surfaces); }
+    void setWalkcheckSurfaces(const std::set<uint32_t> &surfaces);
+    void setLineOfSightSurfaces(const std::set<uint32_t> &surfaces);
 
     // END Collision detection and object picking
 
@@ -220,6 +238,8 @@ private:
     std::set<std::shared_ptr<GrassSceneNode>> _grassRoots;
     std::set<std::shared_ptr<SoundSceneNode>> _soundRoots;
 
+    WalkmeshBroadphase _walkmeshBroadphase;
+
     // END Roots
 
     // Leafs
@@ -264,8 +284,8 @@ private:
     // Surfaces
 
     std::set<uint32_t> _walkableSurfaces;
-    std::set<uint32_t> _walkcheckSurfaces;
-    std::set<uint32_t> _lineOfSightSurfaces;
+    uint32_t _walkcheckSurfaces {0}; /**< bitmask of materials */
+    uint32_t _lineOfSightSurfaces {0}; /**< bitmask of materials */
 
     // END Surfaces
 
@@ -63,6 +63,12 @@ void WalkmeshSceneNode::init() {
 
     _mesh = make_unique<Mesh>(move(vertices), move(faces), move(spec));
     _mesh->init();
+
+    _aabb = _walkmesh->aabb();
+}
+
+void WalkmeshSceneNode::onAbsoluteTransformChanged() {
+    _sceneGraph.updateRoot(*this);
 }
 
 void WalkmeshSceneNode::draw() {
@@ -65,6 +65,8 @@ private:
     graphics::GraphicsContext &_graphicsContext;
     graphics::Shaders &_shaders;
     graphics::Uniforms &_uniforms;
+
+    void onAbsoluteTransformChanged() override;
 };
 
 } // namespace scene
@@ -19,175 +19,490 @@
 
 #include "../common/logutil.h"
 
+#include "enginetype.h"
 #include "executioncontext.h"
 #include "instrutil.h"
+#include "profiler.h"
 #include "program.h"
 #include "routine.h"
 #include "routines.h"
 #include "variable.h"
 
 using namespace std;
-using namespace std::placeholders;
 
 namespace reone {
 
 namespace script {
 
 static constexpr int kStartInstructionOffset = 13;
+static constexpr int kStackReserve = 256;
+static constexpr int kArgsReserve = 16;
+static constexpr int kMaxPooledStrings = 1024;
+static constexpr int kMinHandlesBeforeCompaction = 1024;
+static constexpr size_t kMinStringBytesBeforeCompaction = 64 * 1024;
+
+ScriptExecution::ScriptExecution() :
+    _compactionThreshold(kMinHandlesBeforeCompaction),
+    _stringBytesCompactionThreshold(kMinStringBytesBeforeCompaction) {
+
+    _stack.reserve(kStackReserve);
+    _args.reserve(kArgsReserve);
+}
 
 ScriptExecution::ScriptExecution(shared_ptr<ScriptProgram> program, unique_ptr<ExecutionContext> context) :
-    _context(move(context)),
-    _program(move(program)) {
-
-    static unordered_map<InstructionType, function<void(ScriptExecution *, const Instruction &)>> g_handlers {
-        {InstructionType::CPDOWNSP, &ScriptExecution::executeCPDOWNSP},
-        {InstructionType::RSADDI, &ScriptExecution::executeRSADDI},
-        {InstructionType::RSADDF, &ScriptExecution::executeRSADDF},
-        {InstructionType::RSADDS, &ScriptExecution::executeRSADDS},
-        {InstructionType::RSADDO, &ScriptExecution::executeRSADDO},
-        {InstructionType::RSADDEFF, &ScriptExecution::executeRSADDEFF},
-        {InstructionType::RSADDEVT, &ScriptExecution::executeRSADDEVT},
-        {InstructionType::RSADDLOC, &ScriptExecution::executeRSADDLOC},
-        {InstructionType::RSADDTAL, &ScriptExecution::executeRSADDTAL},
-        {InstructionType::CPTOPSP, &ScriptExecution::executeCPTOPSP},
-        {InstructionType::CONSTI, &ScriptExecution::executeCONSTI},
-        {InstructionType::CONSTF, &ScriptExecution::executeCONSTF},
-        {InstructionType::CONSTS, &ScriptExecution::executeCONSTS},
-        {InstructionType::CONSTO, &ScriptExecution::executeCONSTO},
-        {InstructionType::ACTION, &ScriptExecution::executeACTION},
-        {InstructionType::LOGANDII, &ScriptExecution::executeLOGANDII},
-        {InstructionType::LOGORII, &ScriptExecution::executeLOGORII},
-        {InstructionType::INCORII, &ScriptExecution::executeINCORII},
-        {InstructionType::EXCORII, &ScriptExecution::executeEXCORII},
-        {InstructionType::BOOLANDII, &ScriptExecution::executeBOOLANDII},
-        {InstructionType::EQUALII, &ScriptExecution::executeEQUALII},
-        {InstructionType::EQUALFF, &ScriptExecution::executeEQUALFF},
-        {InstructionType::EQUALSS, &ScriptExecution::executeEQUALSS},
-        {InstructionType::EQUALOO, &ScriptExecution::executeEQUALOO},
-        {InstructionType::EQUALTT, &ScriptExecution::executeEQUALTT},
-        {InstructionType::EQUALEFFEFF, &ScriptExecution::executeEQUALEFFEFF},
-        {InstructionType::EQUALEVTEVT, &ScriptExecution::executeEQUALEVTEVT},
-        {InstructionType::EQUALLOCLOC, &ScriptExecution::executeEQUALLOCLOC},
-        {InstructionType::EQUALTALTAL, &ScriptExecution::executeEQUALTALTAL},
-        {InstructionType::NEQUALII, &ScriptExecution::executeNEQUALII},
-        {InstructionType::NEQUALFF, &ScriptExecution::executeNEQUALFF},
-        {InstructionType::NEQUALSS, &ScriptExecution::executeNEQUALSS},
-        {InstructionType::NEQUALOO, &ScriptExecution::executeNEQUALOO},
-        {InstructionType::NEQUALTT, &ScriptExecution::executeNEQUALTT},
-        {InstructionType::NEQUALEFFEFF, &ScriptExecution::executeNEQUALEFFEFF},
-        {InstructionType::NEQUALEVTEVT, &ScriptExecution::executeNEQUALEVTEVT},
-        {InstructionType::NEQUALLOCLOC, &ScriptExecution::executeNEQUALLOCLOC},
-        {InstructionType::NEQUALTALTAL, &ScriptExecution::executeNEQUALTALTAL},
-        {InstructionType::GEQII, &ScriptExecution::executeGEQII},
-        {InstructionType::GEQFF, &ScriptExecution::executeGEQFF},
-        {InstructionType::GTII, &ScriptExecution::executeGTII},
-        {InstructionType::GTFF, &ScriptExecution::executeGTFF},
-        {InstructionType::LTII, &ScriptExecution::executeLTII},
-        {InstructionType::LTFF, &ScriptExecution::executeLTFF},
-        {InstructionType::LEQII, &ScriptExecution::executeLEQII},
-        {InstructionType::LEQFF, &ScriptExecution::executeLEQFF},
-        {InstructionType::SHLEFTII, &ScriptExecution::executeSHLEFTII},
-        {InstructionType::SHRIGHTII, &ScriptExecution::executeSHRIGHTII},
-        {InstructionType::USHRIGHTII, &ScriptExecution::executeUSHRIGHTII},
-        {InstructionType::ADDII, &ScriptExecution::executeADDII},
-        {InstructionType::ADDIF, &ScriptExecution::executeADDIF},
-        {InstructionType::ADDFI, &ScriptExecution::executeADDFI},
-        {InstructionType::ADDFF, &ScriptExecution::executeADDFF},
-        {InstructionType::ADDSS, &ScriptExecution::executeADDSS},
-        {InstructionType::ADDVV, &ScriptExecution::executeADDVV},
-        {InstructionType::SUBII, &ScriptExecution::executeSUBII},
-        {InstructionType::SUBIF, &ScriptExecution::executeSUBIF},
-        {InstructionType::SUBFI, &ScriptExecution::executeSUBFI},
-        {InstructionType::SUBFF, &ScriptExecution::executeSUBFF},
-        {InstructionType::SUBVV, &ScriptExecution::executeSUBVV},
-        {InstructionType::MULII, &ScriptExecution::executeMULII},
-        {InstructionType::MULIF, &ScriptExecution::executeMULIF},
-        {InstructionType::MULFI, &ScriptExecution::executeMULFI},
-        {InstructionType::MULFF, &ScriptExecution::executeMULFF},
-        {InstructionType::MULVF, &ScriptExecution::executeMULVF},
-        {InstructionType::MULFV, &ScriptExecution::executeMULFV},
-        {InstructionType::DIVII, &ScriptExecution::executeDIVII},
-        {InstructionType::DIVIF, &ScriptExecution::executeDIVIF},
-        {InstructionType::DIVFI, &ScriptExecution::executeDIVFI},
-        {InstructionType::DIVFF, &ScriptExecution::executeDIVFF},
-        {InstructionType::DIVVF, &ScriptExecution::executeDIVVF},
-        {InstructionType::DIVFV, &ScriptExecution::executeDIVFV},
-        {InstructionType::MODII, &ScriptExecution::executeMODII},
-        {InstructionType::NEGI, &ScriptExecution::executeNEGI},
-        {InstructionType::NEGF, &ScriptExecution::executeNEGF},
-        {InstructionType::MOVSP, &ScriptExecution::executeMOVSP},
-        {InstructionType::JMP, &ScriptExecution::executeJMP},
-        {InstructionType::JSR, &ScriptExecution::executeJSR},
-        {InstructionType::JZ, &ScriptExecution::executeJZ},
-        {InstructionType::RETN, &ScriptExecution::executeRETN},
-        {InstructionType::DESTRUCT, &ScriptExecution::executeDESTRUCT},
-        {InstructionType::NOTI, &ScriptExecution::executeNOTI},
-        {InstructionType::DECISP, &ScriptExecution::executeDECISP},
-        {InstructionType::INCISP, &ScriptExecution::executeINCISP},
-        {InstructionType::JNZ, &ScriptExecution::executeJNZ},
-        {InstructionType::CPDOWNBP, &ScriptExecution::executeCPDOWNBP},
-        {InstructionType::CPTOPBP, &ScriptExecution::executeCPTOPBP},
-        {InstructionType::DECIBP, &ScriptExecution::executeDECIBP},
-        {InstructionType::INCIBP, &ScriptExecution::executeINCIBP},
-        {InstructionType::SAVEBP, &ScriptExecution::executeSAVEBP},
-        {InstructionType::RESTOREBP, &ScriptExecution::executeRESTOREBP},
-        {InstructionType::STORE_STATE, &ScriptExecution::executeSTORE_STATE}};
-    for (auto &pair : g_handlers) {
-        registerHandler(pair.first, pair.second);
-    }
-    _handlers.insert(make_pair(InstructionType::NOP, [](auto &) {}));
-    _handlers.insert(make_pair(InstructionType::NOP2, [](auto &) {}));
+    ScriptExecution() {
+
+    reset(move(program), *context);
 }
 
-int ScriptExecution::run() {
-    uint32_t insOff = kStartInstructionOffset;
+void ScriptExecution::reset(shared_ptr<ScriptProgram> program, const ExecutionContext &context) {
+    _program = move(program);
+    _context = context;
 
-    if (_context->savedState) {
-        vector<Variable> globals(_context->savedState->globals);
-        copy(globals.begin(), globals.end(), back_inserter(_stack));
-        _globalCount = static_cast<int>(_stack.size());
+    // Containers are cleared, rather than reallocated, to retain their capacity
+    _stack.clear();
+    if (_program) {
+        _stack.reserve(_program->stackSize());
+    }
+    _returnIndices.clear();
+    _nextInstruction = 0;
+    _globalCount = 0;
+    _started = false;
+    _finished = false;
+    _result = -1;
+    _savedState.program.reset();
+    _savedState.globals.clear();
+    _savedState.locals.clear();
+    _savedState.insOffset = 0;
+    _engineTypes.clear();
+    _actions.clear();
+    _args.clear();
+
+    // Interned strings are kept between runs, unless there are too many of them
+    if (_strings.size() > kMaxPooledStrings) {
+        _strings.clear();
+    }
+    _compactionThreshold = kMinHandlesBeforeCompaction;
+    _stringBytesCompactionThreshold = kMinStringBytesBeforeCompaction;
+}
 
-        vector<Variable> locals(_context->savedState->locals);
-        copy(locals.begin(), locals.end(), back_inserter(_stack));
+int ScriptExecution::run() {
+    run(0);
+    return _result;
+}
 
-        insOff = _context->savedState->insOffset;
+ExecutionStatus ScriptExecution::run(int maxInstructions) {
+    if (_finished) {
+        return ExecutionStatus::Finished;
     }
+    // Yielded slices of a script are counted as a single call
+    ScriptProfileScope profileScope(ScriptProfileFrameType::Script, _program->name(), !_started);
 
-    debug(boost::format("Run '%s': offset=%04x, caller=%u, triggerrer=%u") %
-              _program->name() %
-              insOff %
-              _context->callerId %
-              _context->triggererId,
-          LogChannels::script);
+    if (!_started) {
+        uint32_t insOff = kStartInstructionOffset;
 
-    while (insOff < _program->length()) {
-        const Instruction &ins = _program->getInstruction(insOff);
-        auto handler = _handlers.find(ins.type);
+        if (_context.savedState) {
+            for (auto &global : _context.savedState->globals) {
+                _stack.push_back(toStackValue(global));
+            }
+            _globalCount = static_cast<int>(_stack.size());
+
+            for (auto &local : _context.savedState->locals) {
+                _stack.push_back(toStackValue(local));
+            }
+
+            insOff = _context.savedState->insOffset;
+        }
+
+        if (isLogChannelEnabled(LogChannels::script)) {
+            debug(boost::format("Run '%s': offset=%04x, caller=%u, triggerrer=%u") %
+                      _program->name() %
+                      insOff %
+                      _context.callerId %
+                      _context.triggererId,
+                  LogChannels::script);
+        }
+
+        _nextInstruction = insOff < _program->length() ? _program->getInstructionIndex(insOff) : -1;
+        _started = true;
+    }
 
-        if (handler == _handlers.end()) {
-            error(boost::format("Instruction not implemented: %04x") % static_cast<int>(ins.type), LogChannels::script);
-            return -1;
+    const vector<Instruction> &instructions = _program->instructions();
+    int numInstructions = static_cast<int>(instructions.size());
+    bool logInstructions = isLogChannelEnabled(LogChannels::script3);
+    uint64_t *instructionCounters = isScriptProfilingEnabled() ? getScriptInstructionCounters() : nullptr;
+    int numExecuted = 0;
+
+    int insIdx = _nextInstruction;
+    while (insIdx >= 0 && insIdx < numInstructions) {
+        if (numExecuted == maxInstructions && maxInstructions > 0) {
+            return ExecutionStatus::Yielded;
         }
-        _nextInstruction = ins.nextOffset;
+        const Instruction &ins = instructions[insIdx];
+        _nextInstruction = insIdx + 1;
 
-        if (isLogChannelEnabled(LogChannels::script3)) {
-            debug(boost::format("Instruction: %s") % describeInstruction(ins, *_context->routines), LogChannels::script3);
+        if (instructionCounters) {
+            ++instructionCounters[static_cast<int>(ins.type)];
+        }
+        if (logInstructions) {
+            debug(boost::format("Instruction: %s") % describeInstruction(ins, *_context.routines), LogChannels::script3);
         }
         try {
-            handler->second(ins);
+            if (!dispatch(ins)) {
+                error(boost::format("Instruction not implemented: %04x") % static_cast<int>(ins.type), LogChannels::script);
+                return finish(-1);
+            }
         } catch (const exception &ex) {
             debug(boost::format("Halt '%s'") % _program->name(), LogChannels::script);
-            return -1;
+            return finish(-1);
         }
 
-        insOff = _nextInstruction;
+        ++numExecuted;
+        insIdx = _nextInstruction;
+
+        // Between instructions, all live handles are on the stack
+        if (_strings.size() + _engineTypes.size() + _actions.size() > _compactionThreshold ||
+            _strings.bytes() > _stringBytesCompactionThreshold) {
+            compactHandles();
+        }
     }
 
     if (!_stack.empty() && _stack.back().type == VariableType::Int) {
-        return _stack.back().intValue;
+        return finish(_stack.back().intValue);
+    }
+
+    return finish(-1);
+}
+
+void ScriptExecution::compactHandles() {
+    vector<uint32_t *> strings;
+    vector<uint32_t *> engineTypes;
+    vector<uint32_t *> actions;
+    for (auto &value : _stack) {
+        switch (value.type) {
+        case VariableType::String:
+            strings.push_back(&value.handle);
+            break;
+        case VariableType::Effect:
+        case VariableType::Event:
+        case VariableType::Location:
+        case VariableType::Talent:
+            engineTypes.push_back(&value.handle);
+            break;
+        case VariableType::Action:
+            actions.push_back(&value.handle);
+            break;
+        default:
+            break;
+        }
     }
+    _strings.compact(strings);
+    _engineTypes.compact(engineTypes);
+    _actions.compact(actions);
 
-    return -1;
+    // Compact again only when the number of handles or string bytes doubles
+    int numHandles = _strings.size() + _engineTypes.size() + _actions.size();
+    _compactionThreshold = max(kMinHandlesBeforeCompaction, 2 * numHandles);
+    _stringBytesCompactionThreshold = max(kMinStringBytesBeforeCompaction, 2 * _strings.bytes());
+}
+
+ExecutionStatus ScriptExecution::finish(int result) {
+    _finished = true;
+    _result = result;
+    return ExecutionStatus::Finished;
+}
+
+bool ScriptExecution::dispatch(const Instruction &ins) {
+    switch (ins.type) {
+    case InstructionType::CPDOWNSP:
+        executeCPDOWNSP(ins);
+        break;
+    case InstructionType::RSADDI:
+        executeRSADDI(ins);
+        break;
+    case InstructionType::RSADDF:
+        executeRSADDF(ins);
+        break;
+    case InstructionType::RSADDS:
+        executeRSADDS(ins);
+        break;
+    case InstructionType::RSADDO:
+        executeRSADDO(ins);
+        break;
+    case InstructionType::RSADDEFF:
+        executeRSADDEFF(ins);
+        break;
+    case InstructionType::RSADDEVT:
+        executeRSADDEVT(ins);
+        break;
+    case InstructionType::RSADDLOC:
+        executeRSADDLOC(ins);
+        break;
+    case InstructionType::RSADDTAL:
+        executeRSADDTAL(ins);
+        break;
+    case InstructionType::CPTOPSP:
+        executeCPTOPSP(ins);
+        break;
+    case InstructionType::CONSTI:
+        executeCONSTI(ins);
+        break;
+    case InstructionType::CONSTF:
+        executeCONSTF(ins);
+        break;
+    case InstructionType::CONSTS:
+        executeCONSTS(ins);
+        break;
+    case InstructionType::CONSTO:
+        executeCONSTO(ins);
+        break;
+    case InstructionType::ACTION:
+        executeACTION(ins);
+        break;
+    case InstructionType::LOGANDII:
+        executeLOGANDII(ins);
+        break;
+    case InstructionType::LOGORII:
+        executeLOGORII(ins);
+        break;
+    case InstructionType::INCORII:
+        executeINCORII(ins);
+        break;
+    case InstructionType::EXCORII:
+        executeEXCORII(ins);
+        break;
+    case InstructionType::BOOLANDII:
+        executeBOOLANDII(ins);
+        break;
+    case InstructionType::EQUALII:
+        executeEQUALII(ins);
+        break;
+    case InstructionType::EQUALFF:
+        executeEQUALFF(ins);
+        break;
+    case InstructionType::EQUALSS:
+        executeEQUALSS(ins);
+        break;
+    case InstructionType::EQUALOO:
+        executeEQUALOO(ins);
+        break;
+    case InstructionType::EQUALTT:
+        executeEQUALTT(ins);
+        break;
+    case InstructionType::EQUALEFFEFF:
+        executeEQUALEFFEFF(ins);
+        break;
+    case InstructionType::EQUALEVTEVT:
+        executeEQUALEVTEVT(ins);
+        break;
+    case InstructionType::EQUALLOCLOC:
+        executeEQUALLOCLOC(ins);
+        break;
+    case InstructionType::EQUALTALTAL:
+        executeEQUALTALTAL(ins);
+        break;
+    case InstructionType::NEQUALII:
+        executeNEQUALII(ins);
+        break;
+    case InstructionType::NEQUALFF:
+        executeNEQUALFF(ins);
+        break;
+    case InstructionType::NEQUALSS:
+        executeNEQUALSS(ins);
+        break;
+    case InstructionType::NEQUALOO:
+        executeNEQUALOO(ins);
+        break;
+    case InstructionType::NEQUALTT:
+        executeNEQUALTT(ins);
+        break;
+    case InstructionType::NEQUALEFFEFF:
+        executeNEQUALEFFEFF(ins);
+        break;
+    case InstructionType::NEQUALEVTEVT:
+        executeNEQUALEVTEVT(ins);
+        break;
+    case InstructionType::NEQUALLOCLOC:
+        executeNEQUALLOCLOC(ins);
+        break;
+    case InstructionType::NEQUALTALTAL:
+        executeNEQUALTALTAL(ins);
+        break;
+    case InstructionType::GEQII:
+        executeGEQII(ins);
+        break;
+    case InstructionType::GEQFF:
+        executeGEQFF(ins);
+        break;
+    case InstructionType::GTII:
+        executeGTII(ins);
+        break;
+    case InstructionType::GTFF:
+        executeGTFF(ins);
+        break;
+    case InstructionType::LTII:
+        executeLTII(ins);
+        break;
+    case InstructionType::LTFF:
+        executeLTFF(ins);
+        break;
+    case InstructionType::LEQII:
+        executeLEQII(ins);
+        break;
+    case InstructionType::LEQFF:
+        executeLEQFF(ins);
+        break;
+    case InstructionType::SHLEFTII:
+        executeSHLEFTII(ins);
+        break;
+    case InstructionType::SHRIGHTII:
+        executeSHRIGHTII(ins);
+        break;
+    case InstructionType::USHRIGHTII:
+        executeUSHRIGHTII(ins);
+        break;
+    case InstructionType::ADDII:
+        executeADDII(ins);
+        break;
+    case InstructionType::ADDIF:
+        executeADDIF(ins);
+        break;
+    case InstructionType::ADDFI:
+        executeADDFI(ins);
+        break;
+    case InstructionType::ADDFF:
+        executeADDFF(ins);
+        break;
+    case InstructionType::ADDSS:
+        executeADDSS(ins);
+        break;
+    case InstructionType::ADDVV:
+        executeADDVV(ins);
+        break;
+    case InstructionType::SUBII:
+        executeSUBII(ins);
+        break;
+    case InstructionType::SUBIF:
+        executeSUBIF(ins);
+        break;
+    case InstructionType::SUBFI:
+        executeSUBFI(ins);
+        break;
+    case InstructionType::SUBFF:
+        executeSUBFF(ins);
+        break;
+    case InstructionType::SUBVV:
+        executeSUBVV(ins);
+        break;
+    case InstructionType::MULII:
+        executeMULII(ins);
+        break;
+    case InstructionType::MULIF:
+        executeMULIF(ins);
+        break;
+    case InstructionType::MULFI:
+        executeMULFI(ins);
+        break;
+    case InstructionType::MULFF:
+        executeMULFF(ins);
+        break;
+    case InstructionType::MULVF:
+        executeMULVF(ins);
+        break;
+    case InstructionType::MULFV:
+        executeMULFV(ins);
+        break;
+    case InstructionType::DIVII:
+        executeDIVII(ins);
+        break;
+    case InstructionType::DIVIF:
+        executeDIVIF(ins);
+        break;
+    case InstructionType::DIVFI:
+        executeDIVFI(ins);
+        break;
+    case InstructionType::DIVFF:
+        executeDIVFF(ins);
+        break;
+    case InstructionType::DIVVF:
+        executeDIVVF(ins);
+        break;
+    case InstructionType::DIVFV:
+        executeDIVFV(ins);
+        break;
+    case InstructionType::MODII:
+        executeMODII(ins);
+        break;
+    case InstructionType::NEGI:
+        executeNEGI(ins);
+        break;
+    case InstructionType::NEGF:
+        executeNEGF(ins);
+        break;
+    case InstructionType::MOVSP:
+        executeMOVSP(ins);
+        break;
+    case InstructionType::JMP:
+        executeJMP(ins);
+        break;
+    case InstructionType::JSR:
+        executeJSR(ins);
+        break;
+    case InstructionType::JZ:
+        executeJZ(ins);
+        break;
+    case InstructionType::RETN:
+        executeRETN(ins);
+        break;
+    case InstructionType::DESTRUCT:
+        executeDESTRUCT(ins);
+        break;
+    case InstructionType::NOTI:
+        executeNOTI(ins);
+        break;
+    case InstructionType::DECISP:
+        executeDECISP(ins);
+        break;
+    case InstructionType::INCISP:
+        executeINCISP(ins);
+        break;
+    case InstructionType::JNZ:
+        executeJNZ(ins);
+        break;
+    case InstructionType::CPDOWNBP:
+        executeCPDOWNBP(ins);
+        break;
+    case InstructionType::CPTOPBP:
+        executeCPTOPBP(ins);
+        break;
+    case InstructionType::DECIBP:
+        executeDECIBP(ins);
+        break;
+    case InstructionType::INCIBP:
+        executeINCIBP(ins);
+        break;
+    case InstructionType::SAVEBP:
+        executeSAVEBP(ins);
+        break;
+    case InstructionType::RESTOREBP:
+        executeRESTOREBP(ins);
+        break;
+    case InstructionType::STORE_STATE:
+        executeSTORE_STATE(ins);
+        break;
+    case InstructionType::CPDOWNSP_MOVSP:
+        executeCPDOWNSP_MOVSP(ins);
+        break;
+    case InstructionType::CPDOWNBP_MOVSP:
+        executeCPDOWNBP_MOVSP(ins);
+        break;
+    case InstructionType::NOP:
+    case InstructionType::NOP2:
+        break;
+    default:
+        return false;
+    }
+    return true;
 }
 
 void ScriptExecution::executeCPDOWNSP(const Instruction &ins) {
@@ -201,35 +516,35 @@ void ScriptExecution::executeCPDOWNSP(const Instruction &ins) {
 }
 
 void ScriptExecution::executeRSADDI(const Instruction &ins) {
-    _stack.push_back(Variable::ofInt(0));
+    _stack.push_back(StackValue::ofInt(0));
 }
 
 void ScriptExecution::executeRSADDF(const Instruction &ins) {
-    _stack.push_back(Variable::ofFloat(0.0f));
+    _stack.push_back(StackValue::ofFloat(0.0f));
 }
 
 void ScriptExecution::executeRSADDS(const Instruction &ins) {
-    _stack.push_back(Variable::ofString(""));
+    _stack.push_back(StackValue::ofHandle(VariableType::String, 0));
 }
 
 void ScriptExecution::executeRSADDO(const Instruction &ins) {
-    _stack.push_back(Variable::ofObject(kObjectInvalid));
+    _stack.push_back(StackValue::ofObject(kObjectInvalid));
 }
 
 void ScriptExecution::executeRSADDEFF(const Instruction &ins) {
-    _stack.push_back(Variable::ofEffect(nullptr));
+    _stack.push_back(StackValue::ofHandle(VariableType::Effect, 0));
 }
 
 void ScriptExecution::executeRSADDEVT(const Instruction &ins) {
-    _stack.push_back(Variable::ofEvent(nullptr));
+    _stack.push_back(StackValue::ofHandle(VariableType::Event, 0));
 }
 
 void ScriptExecution::executeRSADDLOC(const Instruction &ins) {
-    _stack.push_back(Variable::ofLocation(nullptr));
+    _stack.push_back(StackValue::ofHandle(VariableType::Location, 0));
 }
 
 void ScriptExecution::executeRSADDTAL(const Instruction &ins) {
-    _stack.push_back(Variable::ofTalent(nullptr));
+    _stack.push_back(StackValue::ofHandle(VariableType::Talent, 0));
 }
 
 void ScriptExecution::executeCPTOPSP(const Instruction &ins) {
@@ -242,57 +557,60 @@ void ScriptExecution::executeCPTOPSP(const Instruction &ins) {
 }
 
 void ScriptExecution::executeCONSTI(const Instruction &ins) {
-    _stack.push_back(Variable::ofInt(ins.intValue));
+    _stack.push_back(StackValue::ofInt(ins.intValue));
 }
 
 void ScriptExecution::executeCONSTF(const Instruction &ins) {
-    _stack.push_back(Variable::ofFloat(ins.floatValue));
+    _stack.push_back(StackValue::ofFloat(ins.floatValue));
 }
 
 void ScriptExecution::executeCONSTS(const Instruction &ins) {
-    _stack.push_back(Variable::ofString(ins.strValue));
+    _stack.push_back(ofString(ins.strValue));
 }
 
 void ScriptExecution::executeCONSTO(const Instruction &ins) {
-    uint32_t objectId = ins.objectId == kObjectSelf ? _context->callerId : ins.objectId;
-    _stack.push_back(Variable::ofObject(objectId));
+    uint32_t objectId = ins.objectId == kObjectSelf ? _context.callerId : ins.objectId;
+    _stack.push_back(StackValue::ofObject(objectId));
 }
 
 void ScriptExecution::executeACTION(const Instruction &ins) {
-    const Routine &routine = _context->routines->get(ins.routine);
+    const Routine &routine = _context.routines->get(ins.routine);
     if (ins.argCount > routine.getArgumentCount()) {
         throw runtime_error("Too many routine arguments");
     }
+    if (routine.isTyped() && ins.argCount == routine.getArgumentCount() && !isLogChannelEnabled(LogChannels::script2)) {
+        routine.invoke(_routineStack, _context);
+        return;
+    }
 
-    vector<Variable> args;
+    _args.clear();
     for (int i = 0; i < ins.argCount; ++i) {
         VariableType type = routine.getArgumentType(i);
         switch (type) {
         case VariableType::Vector:
-            args.push_back(Variable::ofVector(getVectorFromStack()));
+            _args.push_back(Variable::ofVector(getVectorFromStack()));
             break;
 
         case VariableType::Action: {
-            auto ctx = make_shared<ExecutionContext>(*_context);
+            auto ctx = make_shared<ExecutionContext>(_context);
             ctx->savedState = make_shared<ExecutionState>(_savedState);
-            args.push_back(Variable::ofAction(move(ctx)));
+            _args.push_back(Variable::ofAction(move(ctx)));
             break;
         }
         default:
-            Variable var(_stack.back());
-            if (var.type != type) {
+            if (_stack.back().type != type) {
                 throw runtime_error("Invalid argument variable type");
             }
-            args.push_back(move(var));
+            _args.push_back(toVariable(_stack.back()));
             _stack.pop_back();
             break;
         }
     }
 
-    Variable retValue = routine.invoke(args, *_context);
+    Variable retValue = routine.invoke(_args, _context);
     if (isLogChannelEnabled(LogChannels::script2)) {
         vector<string> argStrings;
-        for (auto &arg : args) {
+        for (auto &arg : _args) {
             argStrings.push_back(arg.toString());
         }
         string argsString(boost::join(argStrings, ", "));
@@ -302,225 +620,223 @@ void ScriptExecution::executeACTION(const Instruction &ins) {
     case VariableType::Void:
         break;
     case VariableType::Vector:
-        _stack.push_back(Variable::ofFloat(retValue.vecValue.z));
-        _stack.push_back(Variable::ofFloat(retValue.vecValue.y));
-        _stack.push_back(Variable::ofFloat(retValue.vecValue.x));
+        pushVectorToStack(retValue.vecValue);
         break;
     default:
-        _stack.push_back(retValue);
+        _stack.push_back(toStackValue(retValue));
         break;
     }
 }
 
 void ScriptExecution::executeLOGANDII(const Instruction &ins) {
     withIntsFromStack([this](int left, int right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left && right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left && right)));
     });
 }
 
 void ScriptExecution::executeLOGORII(const Instruction &ins) {
     withIntsFromStack([this](int left, int right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left || right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left || right)));
     });
 }
 
 void ScriptExecution::executeINCORII(const Instruction &ins) {
     withIntsFromStack([this](int left, int right) {
-        _stack.push_back(Variable::ofInt(left | right));
+        _stack.push_back(StackValue::ofInt(left | right));
     });
 }
 
 void ScriptExecution::executeEXCORII(const Instruction &ins) {
     withIntsFromStack([this](int left, int right) {
-        _stack.push_back(Variable::ofInt(left ^ right));
+        _stack.push_back(StackValue::ofInt(left ^ right));
     });
 }
 
 void ScriptExecution::executeBOOLANDII(const Instruction &ins) {
     withIntsFromStack([this](int left, int right) {
-        _stack.push_back(Variable::ofInt(left & right));
+        _stack.push_back(StackValue::ofInt(left & right));
     });
 }
 
 void ScriptExecution::executeEQUALII(const Instruction &ins) {
     withIntsFromStack([this](int left, int right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left == right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left == right)));
     });
 }
 
 void ScriptExecution::executeEQUALFF(const Instruction &ins) {
     withFloatsFromStack([this](float left, float right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left == right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left == right)));
     });
 }
 
 void ScriptExecution::executeEQUALSS(const Instruction &ins) {
     withStringsFromStack([this](auto &left, auto &right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left == right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left == right)));
     });
 }
 
 void ScriptExecution::executeEQUALOO(const Instruction &ins) {
     withObjectsFromStack([this](uint32_t left, uint32_t right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left == right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left == right)));
     });
 }
 
 void ScriptExecution::executeEQUALTT(const Instruction &ins) {
-    int numVariables = ins.size / 4;
-    vector<Variable> vars1;
-    for (int i = 0; i < numVariables; ++i) {
-        vars1.push_back(move(_stack.back()));
-        _stack.pop_back();
-    }
-    vector<Variable> vars2;
-    for (int i = 0; i < numVariables; ++i) {
-        vars2.push_back(move(_stack.back()));
-        _stack.pop_back();
+    int count = ins.size / 4;
+    int rightIdx = static_cast<int>(_stack.size()) - count;
+    int leftIdx = rightIdx - count;
+
+    bool equal = true;
+    for (int i = 0; i < count; ++i) {
+        if (!isEqual(_stack[leftIdx + i], _stack[rightIdx + i])) {
+            equal = false;
+            break;
+        }
     }
-    bool equal = std::equal(vars1.begin(), vars1.end(), vars2.begin());
-    _stack.push_back(Variable::ofInt(static_cast<int>(equal)));
+    _stack.resize(leftIdx);
+    _stack.push_back(StackValue::ofInt(static_cast<int>(equal)));
 }
 
 void ScriptExecution::executeEQUALEFFEFF(const Instruction &ins) {
     withEffectsFromStack([this](auto &left, auto &right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left == right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left == right)));
     });
 }
 
 void ScriptExecution::executeEQUALEVTEVT(const Instruction &ins) {
     withEventsFromStack([this](auto &left, auto &right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left == right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left == right)));
     });
 }
 
 void ScriptExecution::executeEQUALLOCLOC(const Instruction &ins) {
     withLocationsFromStack([this](auto &left, auto &right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left == right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left == right)));
     });
 }
 
 void ScriptExecution::executeEQUALTALTAL(const Instruction &ins) {
     withTalentsFromStack([this](auto &left, auto &right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left == right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left == right)));
     });
 }
 
 void ScriptExecution::executeNEQUALII(const Instruction &ins) {
     withIntsFromStack([this](int left, int right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left != right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left != right)));
     });
 }
 
 void ScriptExecution::executeNEQUALFF(const Instruction &ins) {
     withFloatsFromStack([this](float left, float right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left != right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left != right)));
     });
 }
 
 void ScriptExecution::executeNEQUALSS(const Instruction &ins) {
     withStringsFromStack([this](auto &left, auto &right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left != right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left != right)));
     });
 }
 
 void ScriptExecution::executeNEQUALOO(const Instruction &ins) {
     withObjectsFromStack([this](uint32_t left, uint32_t right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left != right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left != right)));
     });
 }
 
 void ScriptExecution::executeNEQUALTT(const Instruction &ins) {
-    int numVariables = ins.size / 4;
-    vector<Variable> vars1;
-    for (int i = 0; i < numVariables; ++i) {
-        vars1.push_back(move(_stack.back()));
-        _stack.pop_back();
-    }
-    vector<Variable> vars2;
-    for (int i = 0; i < numVariables; ++i) {
-        vars2.push_back(move(_stack.back()));
-        _stack.pop_back();
+    int count = ins.size / 4;
+    int rightIdx = static_cast<int>(_stack.size()) - count;
+    int leftIdx = rightIdx - count;
+
+    bool equal = true;
+    for (int i = 0; i < count; ++i) {
+        if (!isEqual(_stack[leftIdx + i], _stack[rightIdx + i])) {
+            equal = false;
+            break;
+        }
     }
-    bool notEqual = !std::equal(vars1.begin(), vars1.end(), vars2.begin());
-    _stack.push_back(Variable::ofInt(static_cast<int>(notEqual)));
+    _stack.resize(leftIdx);
+    _stack.push_back(StackValue::ofInt(static_cast<int>(!equal)));
 }
 
 void ScriptExecution::executeNEQUALEFFEFF(const Instruction &ins) {
     withEffectsFromStack([this](auto &left, auto &right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left != right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left != right)));
     });
 }
 
 void ScriptExecution::executeNEQUALEVTEVT(const Instruction &ins) {
     withEventsFromStack([this](auto &left, auto &right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left != right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left != right)));
     });
 }
 
 void ScriptExecution::executeNEQUALLOCLOC(const Instruction &ins) {
     withLocationsFromStack([this](auto &left, auto &right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left != right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left != right)));
     });
 }
 
 void ScriptExecution::executeNEQUALTALTAL(const Instruction &ins) {
     withTalentsFromStack([this](auto &left, auto &right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left != right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left != right)));
     });
 }
 
 void ScriptExecution::executeGEQII(const Instruction &ins) {
     withIntsFromStack([this](int left, int right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left >= right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left >= right)));
     });
 }
 
 void ScriptExecution::executeGEQFF(const Instruction &ins) {
     withFloatsFromStack([this](float left, float right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left >= right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left >= right)));
     });
 }
 
 void ScriptExecution::executeGTII(const Instruction &ins) {
     withIntsFromStack([this](int left, int right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left > right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left > right)));
     });
 }
 
 void ScriptExecution::executeGTFF(const Instruction &ins) {
     withFloatsFromStack([this](float left, float right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left > right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left > right)));
     });
 }
 
 void ScriptExecution::executeLTII(const Instruction &ins) {
     withIntsFromStack([this](int left, int right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left < right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left < right)));
     });
 }
 
 void ScriptExecution::executeLTFF(const Instruction &ins) {
     withFloatsFromStack([this](float left, float right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left < right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left < right)));
     });
 }
 
 void ScriptExecution::executeLEQII(const Instruction &ins) {
     withIntsFromStack([this](int left, int right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left <= right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left <= right)));
     });
 }
 
 void ScriptExecution::executeLEQFF(const Instruction &ins) {
     withFloatsFromStack([this](float left, float right) {
-        _stack.push_back(Variable::ofInt(static_cast<int>(left <= right)));
+        _stack.push_back(StackValue::ofInt(static_cast<int>(left <= right)));
     });
 }
 
 void ScriptExecution::executeSHLEFTII(const Instruction &ins) {
     withIntsFromStack([this](int left, int right) {
-        _stack.push_back(Variable::ofInt(left << right));
+        _stack.push_back(StackValue::ofInt(left << right));
     });
 }
 
@@ -532,157 +848,157 @@ void ScriptExecution::executeSHRIGHTII(const Instruction &ins) {
         } else {
             result >>= right;
         }
-        _stack.push_back(Variable::ofInt(result));
+        _stack.push_back(StackValue::ofInt(result));
     });
 }
 
 void ScriptExecution::executeUSHRIGHTII(const Instruction &ins) {
     withIntsFromStack([this](int left, int right) {
-        _stack.push_back(Variable::ofInt(left >> right));
+        _stack.push_back(StackValue::ofInt(left >> right));
     });
 }
 
 void ScriptExecution::executeADDII(const Instruction &ins) {
     withIntsFromStack([this](int left, int right) {
-        _stack.push_back(Variable::ofInt(left + right));
+        _stack.push_back(StackValue::ofInt(left + right));
     });
 }
 
 void ScriptExecution::executeADDIF(const Instruction &ins) {
     withIntFloatFromStack([this](int left, float right) {
-        _stack.push_back(Variable::ofFloat(left + right));
+        _stack.push_back(StackValue::ofFloat(left + right));
     });
 }
 
 void ScriptExecution::executeADDFI(const Instruction &ins) {
     withFloatIntFromStack([this](float left, int right) {
-        _stack.push_back(Variable::ofFloat(left + right));
+        _stack.push_back(StackValue::ofFloat(left + right));
     });
 }
 
 void ScriptExecution::executeADDFF(const Instruction &ins) {
     withFloatsFromStack([this](float left, float right) {
-        _stack.push_back(Variable::ofFloat(left + right));
+        _stack.push_back(StackValue::ofFloat(left + right));
     });
 }
 
 void ScriptExecution::executeADDSS(const Instruction &ins) {
     withStringsFromStack([this](auto &left, auto &right) {
-        _stack.push_back(Variable::ofString(left + right));
+        _stack.push_back(ofString(left + right));
     });
 }
 
 void ScriptExecution::executeADDVV(const Instruction &ins) {
     withVectorsFromStack([this](auto &left, auto &right) {
-        _stack.push_back(Variable::ofVector(left + right));
+        pushVectorToStack(left + right);
     });
 }
 
 void ScriptExecution::executeSUBII(const Instruction &ins) {
     withIntsFromStack([this](int left, int right) {
-        _stack.push_back(Variable::ofInt(left - right));
+        _stack.push_back(StackValue::ofInt(left - right));
     });
 }
 
 void ScriptExecution::executeSUBIF(const Instruction &ins) {
     withIntFloatFromStack([this](int left, float right) {
-        _stack.push_back(Variable::ofFloat(left - right));
+        _stack.push_back(StackValue::ofFloat(left - right));
     });
 }
 
 void ScriptExecution::executeSUBFI(const Instruction &ins) {
     withFloatIntFromStack([this](float left, int right) {
-        _stack.push_back(Variable::ofFloat(left - right));
+        _stack.push_back(StackValue::ofFloat(left - right));
     });
 }
 
 void ScriptExecution::executeSUBFF(const Instruction &ins) {
     withFloatsFromStack([this](float left, float right) {
-        _stack.push_back(Variable::ofFloat(left - right));
+        _stack.push_back(StackValue::ofFloat(left - right));
     });
 }
 
 void ScriptExecution::executeSUBVV(const Instruction &ins) {
     withVectorsFromStack([this](auto &left, auto &right) {
-        _stack.push_back(Variable::ofVector(left - right));
+        pushVectorToStack(left - right);
     });
 }
 
 void ScriptExecution::executeMULII(const Instruction &ins) {
     withIntsFromStack([this](int left, int right) {
-        _stack.push_back(Variable::ofInt(left * right));
+        _stack.push_back(StackValue::ofInt(left * right));
     });
 }
 
 void ScriptExecution::executeMULIF(const Instruction &ins) {
     withIntFloatFromStack([this](int left, float right) {
-        _stack.push_back(Variable::ofFloat(left * right));
+        _stack.push_back(StackValue::ofFloat(left * right));
     });
 }
 
 void ScriptExecution::executeMULFI(const Instruction &ins) {
     withFloatIntFromStack([this](float left, int right) {
-        _stack.push_back(Variable::ofFloat(left * right));
+        _stack.push_back(StackValue::ofFloat(left * right));
     });
 }
 
 void ScriptExecution::executeMULFF(const Instruction &ins) {
     withFloatsFromStack([this](float left, float right) {
-        _stack.push_back(Variable::ofFloat(left * right));
+        _stack.push_back(StackValue::ofFloat(left * right));
     });
 }
 
 void ScriptExecution::executeMULVF(const Instruction &ins) {
     withVectorFloatFromStack([this](auto &left, float right) {
-        _stack.push_back(Variable::ofVector(left * right));
+        pushVectorToStack(left * right);
     });
 }
 
 void ScriptExecution::executeMULFV(const Instruction &ins) {
     withFloatVectorFromStack([this](float left, auto &right) {
-        _stack.push_back(Variable::ofVector(left * right));
+        pushVectorToStack(left * right);
     });
 }
 
 void ScriptExecution::executeDIVII(const Instruction &ins) {
     withIntsFromStack([this](int left, int right) {
-        _stack.push_back(Variable::ofInt(left / right));
+        _stack.push_back(StackValue::ofInt(left / right));
     });
 }
 
 void ScriptExecution::executeDIVIF(const Instruction &ins) {
     withIntFloatFromStack([this](int left, float right) {
-        _stack.push_back(Variable::ofFloat(left / right));
+        _stack.push_back(StackValue::ofFloat(left / right));
     });
 }
 
 void ScriptExecution::executeDIVFI(const Instruction &ins) {
     withFloatIntFromStack([this](float left, int right) {
-        _stack.push_back(Variable::ofFloat(left / right));
+        _stack.push_back(StackValue::ofFloat(left / right));
     });
 }
 
 void ScriptExecution::executeDIVFF(const Instruction &ins) {
     withFloatsFromStack([this](float left, float right) {
-        _stack.push_back(Variable::ofFloat(left / right));
+        _stack.push_back(StackValue::ofFloat(left / right));
     });
 }
 
 void ScriptExecution::executeDIVVF(const Instruction &ins) {
     withVectorFloatFromStack([this](auto &left, float right) {
-        _stack.push_back(Variable::ofVector(left / right));
+        pushVectorToStack(left / right);
     });
 }
 
 void ScriptExecution::executeDIVFV(const Instruction &ins) {
     withFloatVectorFromStack([this](float left, auto &right) {
-        _stack.push_back(Variable::ofVector(left / right));
+        pushVectorToStack(left / right);
     });
 }
 
 void ScriptExecution::executeMODII(const Instruction &ins) {
     withIntsFromStack([this](int left, int right) {
-        _stack.push_back(Variable::ofInt(left % right));
+        _stack.push_back(StackValue::ofInt(left % right));
     });
 }
 
@@ -702,27 +1018,27 @@ void ScriptExecution::executeMOVSP(const Instruction &ins) {
 }
 
 void ScriptExecution::executeJMP(const Instruction &ins) {
-    _nextInstruction = ins.offset + ins.jumpOffset;
+    _nextInstruction = ins.jumpIndex;
 }
 
 void ScriptExecution::executeJSR(const Instruction &ins) {
-    _returnOffsets.push_back(ins.nextOffset);
-    _nextInstruction = ins.offset + ins.jumpOffset;
+    _returnIndices.push_back(_nextInstruction);
+    _nextInstruction = ins.jumpIndex;
 }
 
 void ScriptExecution::executeJZ(const Instruction &ins) {
     bool zero = getIntFromStack() == 0;
     if (zero) {
-        _nextInstruction = ins.offset + ins.jumpOffset;
+        _nextInstruction = ins.jumpIndex;
     }
 }
 
 void ScriptExecution::executeRETN(const Instruction &ins) {
-    if (_returnOffsets.empty()) {
-        _nextInstruction = _program->length();
+    if (_returnIndices.empty()) {
+        _nextInstruction = -1;
     } else {
-        _nextInstruction = _returnOffsets.back();
-        _returnOffsets.pop_back();
+        _nextInstruction = _returnIndices.back();
+        _returnIndices.pop_back();
     }
 }
 
@@ -749,13 +1065,13 @@ void ScriptExecution::executeINCISP(const Instruction &ins) {
 
 void ScriptExecution::executeNOTI(const Instruction &ins) {
     int value = getIntFromStack();
-    _stack.push_back(Variable::ofInt(static_cast<int>(!value)));
+    _stack.push_back(StackValue::ofInt(static_cast<int>(!value)));
 }
 
 void ScriptExecution::executeJNZ(const Instruction &ins) {
     bool notZero = getIntFromStack() != 0;
     if (notZero) {
-        _nextInstruction = ins.offset + ins.jumpOffset;
+        _nextInstruction = ins.jumpIndex;
     }
 }
 
@@ -790,7 +1106,7 @@ void ScriptExecution::executeINCIBP(const Instruction &ins) {
 
 void ScriptExecution::executeSAVEBP(const Instruction &ins) {
     _globalCount = static_cast<int>(_stack.size());
-    _stack.push_back(Variable::ofInt(_globalCount));
+    _stack.push_back(StackValue::ofInt(_globalCount));
 }
 
 void ScriptExecution::executeRESTOREBP(const Instruction &ins) {
@@ -803,7 +1119,7 @@ void ScriptExecution::executeSTORE_STATE(const Instruction &ins) {
 
     _savedState.globals.clear();
     for (int i = 0; i < count; ++i) {
-        _savedState.globals.push_back(_stack[srcIdx++]);
+        _savedState.globals.push_back(toVariable(_stack[srcIdx++]));
     }
 
     count = ins.sizeLocals / 4;
@@ -811,29 +1127,47 @@ void ScriptExecution::executeSTORE_STATE(const Instruction &ins) {
 
     _savedState.locals.clear();
     for (int i = 0; i < count; ++i) {
-        _savedState.locals.push_back(_stack[srcIdx++]);
+        _savedState.locals.push_back(toVariable(_stack[srcIdx++]));
     }
 
     _savedState.program = _program;
     _savedState.insOffset = ins.offset + 0x10;
 }
 
+void ScriptExecution::executeCPDOWNSP_MOVSP(const Instruction &ins) {
+    executeCPDOWNSP(ins);
+
+    int count = -ins.moveOffset / 4;
+    for (int i = 0; i < count; ++i) {
+        _stack.pop_back();
+    }
+}
+
+void ScriptExecution::executeCPDOWNBP_MOVSP(const Instruction &ins) {
+    executeCPDOWNBP(ins);
+
+    int count = -ins.moveOffset / 4;
+    for (int i = 0; i < count; ++i) {
+        _stack.pop_back();
+    }
+}
+
 int ScriptExecution::getIntFromStack() {
-    Variable var(move(_stack.back()));
+    StackValue value(_stack.back());
     _stack.pop_back();
 
-    throwIfInvalidType(VariableType::Int, var.type);
+    throwIfInvalidType(VariableType::Int, value.type);
 
-    return var.intValue;
+    return value.intValue;
 }
 
 float ScriptExecution::getFloatFromStack() {
-    Variable var(move(_stack.back()));
+    StackValue value(_stack.back());
     _stack.pop_back();
 
-    throwIfInvalidType(VariableType::Float, var.type);
+    throwIfInvalidType(VariableType::Float, value.type);
 
-    return var.floatValue;
+    return value.floatValue;
 }
 
 glm::vec3 ScriptExecution::getVectorFromStack() {
@@ -844,11 +1178,17 @@ glm::vec3 ScriptExecution::getVectorFromStack() {
     return glm::vec3(x, y, z);
 }
 
-void ScriptExecution::withStackVariables(const function<void(const Variable &, const Variable &)> &fn) {
-    Variable second(move(_stack.back()));
+void ScriptExecution::pushVectorToStack(const glm::vec3 &value) {
+    _stack.push_back(StackValue::ofFloat(value.z));
+    _stack.push_back(StackValue::ofFloat(value.y));
+    _stack.push_back(StackValue::ofFloat(value.x));
+}
+
+void ScriptExecution::withStackVariables(const function<void(const StackValue &, const StackValue &)> &fn) {
+    StackValue second(_stack.back());
     _stack.pop_back();
 
-    Variable first(move(_stack.back()));
+    StackValue first(_stack.back());
     _stack.pop_back();
 
     fn(first, second);
@@ -890,7 +1230,7 @@ void ScriptExecution::withStringsFromStack(const function<void(const string &, c
     withStackVariables([this, &fn](auto &left, auto &right) {
         throwIfInvalidType(VariableType::String, left.type);
         throwIfInvalidType(VariableType::String, right.type);
-        fn(left.strValue, right.strValue);
+        fn(_strings.get(left.handle), _strings.get(right.handle));
     });
 }
 
@@ -906,7 +1246,7 @@ void ScriptExecution::withEffectsFromStack(const function<void(const shared_ptr<
     withStackVariables([this, &fn](auto &left, auto &right) {
         throwIfInvalidType(VariableType::Effect, left.type);
         throwIfInvalidType(VariableType::Effect, right.type);
-        fn(left.engineType, right.engineType);
+        fn(_engineTypes.get(left.handle), _engineTypes.get(right.handle));
     });
 }
 
@@ -914,7 +1254,7 @@ void ScriptExecution::withEventsFromStack(const function<void(const shared_ptr<E
     withStackVariables([this, &fn](auto &left, auto &right) {
         throwIfInvalidType(VariableType::Event, left.type);
         throwIfInvalidType(VariableType::Event, right.type);
-        fn(left.engineType, right.engineType);
+        fn(_engineTypes.get(left.handle), _engineTypes.get(right.handle));
     });
 }
 
@@ -922,7 +1262,7 @@ void ScriptExecution::withLocationsFromStack(const function<void(const shared_pt
     withStackVariables([this, &fn](auto &left, auto &right) {
         throwIfInvalidType(VariableType::Location, left.type);
         throwIfInvalidType(VariableType::Location, right.type);
-        fn(left.engineType, right.engineType);
+        fn(_engineTypes.get(left.handle), _engineTypes.get(right.handle));
     });
 }
 
@@ -930,32 +1270,26 @@ void ScriptExecution::withTalentsFromStack(const function<void(const shared_ptr<
     withStackVariables([this, &fn](auto &left, auto &right) {
         throwIfInvalidType(VariableType::Talent, left.type);
         throwIfInvalidType(VariableType::Talent, right.type);
-        fn(left.engineType, right.engineType);
+        fn(_engineTypes.get(left.handle), _engineTypes.get(right.handle));
     });
 }
 
 void ScriptExecution::withFloatVectorFromStack(const function<void(float, const glm::vec3 &)> &fn) {
-    withStackVariables([this, &fn](auto &left, auto &right) {
-        throwIfInvalidType(VariableType::Float, left.type);
-        throwIfInvalidType(VariableType::Vector, right.type);
-        fn(left.floatValue, right.vecValue);
-    });
+    glm::vec3 right(getVectorFromStack());
+    float left = getFloatFromStack();
+    fn(left, right);
 }
 
 void ScriptExecution::withVectorFloatFromStack(const function<void(const glm::vec3 &, float)> &fn) {
-    withStackVariables([this, &fn](auto &left, auto &right) {
-        throwIfInvalidType(VariableType::Vector, left.type);
-        throwIfInvalidType(VariableType::Float, right.type);
-        fn(left.vecValue, right.floatValue);
-    });
+    float right = getFloatFromStack();
+    glm::vec3 left(getVectorFromStack());
+    fn(left, right);
 }
 
 void ScriptExecution::withVectorsFromStack(const function<void(const glm::vec3 &, const glm::vec3 &)> &fn) {
-    withStackVariables([this, &fn](auto &left, auto &right) {
-        throwIfInvalidType(VariableType::Vector, left.type);
-        throwIfInvalidType(VariableType::Vector, right.type);
-        fn(left.vecValue, right.vecValue);
-    });
+    glm::vec3 right(getVectorFromStack());
+    glm::vec3 left(getVectorFromStack());
+    fn(left, right);
 }
 
 void ScriptExecution::throwIfInvalidType(VariableType expected, VariableType actual) {
@@ -970,8 +1304,81 @@ int ScriptExecution::getStackSize() const {
     return static_cast<int>(_stack.size());
 }
 
-const Variable &ScriptExecution::getStackVariable(int index) const {
-    return _stack[index];
+Variable ScriptExecution::getStackVariable(int index) const {
+    return toVariable(_stack[index]);
+}
+
+StackValue ScriptExecution::toStackValue(const Variable &var) {
+    switch (var.type) {
+    case VariableType::Int:
+        return StackValue::ofInt(var.intValue);
+    case VariableType::Float:
+        return StackValue::ofFloat(var.floatValue);
+    case VariableType::String:
+        return ofString(var.strValue);
+    case VariableType::Object:
+        return StackValue::ofObject(var.objectId);
+    case VariableType::Effect:
+    case VariableType::Event:
+    case VariableType::Location:
+    case VariableType::Talent:
+        return ofEngineType(var.type, var.engineType);
+    case VariableType::Action:
+        return StackValue::ofHandle(VariableType::Action, _actions.add(var.context));
+    default:
+        return StackValue::ofNull();
+    }
+}
+
+Variable ScriptExecution::toVariable(const StackValue &value) const {
+    switch (value.type) {
+    case VariableType::Int:
+        return Variable::ofInt(value.intValue);
+    case VariableType::Float:
+        return Variable::ofFloat(value.floatValue);
+    case VariableType::String:
+        return Variable::ofString(_strings.get(value.handle));
+    case VariableType::Object:
+        return Variable::ofObject(value.objectId);
+    case VariableType::Effect:
+        return Variable::ofEffect(_engineTypes.get(value.handle));
+    case VariableType::Event:
+        return Variable::ofEvent(_engineTypes.get(value.handle));
+    case VariableType::Location:
+        return Variable::ofLocation(_engineTypes.get(value.handle));
+    case VariableType::Talent:
+        return Variable::ofTalent(_engineTypes.get(value.handle));
+    case VariableType::Action:
+        return Variable::ofAction(_actions.get(value.handle));
+    default:
+        return Variable::ofNull();
+    }
+}
+
+StackValue ScriptExecution::ofString(const string &value) {
+    return StackValue::ofHandle(VariableType::String, _strings.intern(value));
+}
+
+StackValue ScriptExecution::ofEngineType(VariableType type, shared_ptr<EngineType> engineType) {
+    return StackValue::ofHandle(type, _engineTypes.add(move(engineType)));
+}
+
+bool ScriptExecution::isEqual(const StackValue &left, const StackValue &right) const {
+    if (left.type != right.type) {
+        return false;
+    }
+    switch (left.type) {
+    case VariableType::Effect:
+    case VariableType::Event:
+    case VariableType::Location:
+    case VariableType::Talent:
+        return _engineTypes.get(left.handle) == _engineTypes.get(right.handle);
+    case VariableType::Action:
+        return _actions.get(left.handle) == _actions.get(right.handle);
+    default:
+        // Interned strings are equal if and only if their handles are equal
+        return left.intValue == right.intValue;
+    }
 }
 
 } // namespace script
@@ -17,7 +17,12 @@
 
 #pragma once
 
+#include "executioncontext.h"
 #include "executionstate.h"
+#include "handletable.h"
+#include "routinestack.h"
+#include "stackvalue.h"
+#include "stringpool.h"
 #include "types.h"
 
 namespace reone {
@@ -26,40 +31,95 @@ namespace script {
 
 #define R_INSTR_HANDLER(a) void execute##a(const Instruction &);
 
-struct ExecutionContext;
 struct Instruction;
 struct Variable;
 
+class EngineType;
 class ScriptProgram;
 
 class ScriptExecution : boost::noncopyable {
 public:
+    ScriptExecution();
     ScriptExecution(std::shared_ptr<ScriptProgram> program, std::unique_ptr<ExecutionContext> context);
 
+    /**
+     * Prepares this execution to run the specified program, retaining
+     * allocated memory from previous runs. Pass a null program to only
+     * release references held by the previous run.
+     */
+    void reset(std::shared_ptr<ScriptProgram> program, const ExecutionContext &context);
+
+    /**
+     * Runs the program to completion.
+     *
+     * @return script result
+     */
     int run();
 
+    /**
+     * Runs at most maxInstructions instructions, resuming from where the
+     * previous call yielded. Preemption only ever happens between
+     * instructions, so routine calls are never interrupted.
+     *
+     * @param maxInstructions instruction budget, or zero for unlimited
+     * @return Yielded if the budget was exhausted, Finished otherwise
+     */
+    ExecutionStatus run(int maxInstructions);
+
+    /**
+     * @return script result, once the execution has finished
+     */
+    int result() const { return _result; }
+
     int getStackSize() const;
-    const Variable &getStackVariable(int index) const;
+    Variable getStackVariable(int index) const;
 
 private:
     std::shared_ptr<ScriptProgram> _program;
-    std::unique_ptr<ExecutionContext> _context;
-    std::unordered_map<InstructionType, std::function<void(const Instruction &)>> _handlers;
-    std::vector<Variable> _stack;
-    std::vector<uint32_t> _returnOffsets;
-    uint32_t _nextInstruction {0};
+    ExecutionContext _context;
+    std::vector<StackValue> _stack;
+    StringPool _strings;
+    RoutineStack _routineStack {_stack, _strings};
+    HandleTable<EngineType> _engineTypes;
+    HandleTable<ExecutionContext> _actions;
+    std::vector<Variable> _args; /**< routine arguments, reused between ACTION instructions */
+    std::vector<int> _returnIndices;
+    int _nextInstruction {0}; /**< index of the next instruction to execute */
     int _globalCount {0};
+    bool _started {false};
+    bool _finished {false};
+    int _result {-1};
+    int _compactionThreshold {0}; /**< total number of handles, at which unreferenced ones are released */
+    size_t _stringBytesCompactionThreshold {0}; /**< total length of pooled strings, at which unreferenced ones are released */
     ExecutionState _savedState;
 
-    void registerHandler(InstructionType type, std::function<void(ScriptExecution *, const Instruction &)> handler) {
-        _handlers.insert(std::make_pair(type, std::bind(handler, this, std::placeholders::_1)));
-    }
+    /**
+     * @return false if instruction type is not implemented, true otherwise
+     */
+    bool dispatch(const Instruction &ins);
+
+    ExecutionStatus finish(int result);
+
+    /**
+     * Releases strings, engine types and actions that are no longer
+     * referenced from the stack.
+     */
+    void compactHandles();
+
+    StackValue toStackValue(const Variable &var);
+    Variable toVariable(const StackValue &value) const;
+
+    StackValue ofString(const std::string &value);
+    StackValue ofEngineType(VariableType type, std::shared_ptr<EngineType> engineType);
+
+    bool isEqual(const StackValue &left, const StackValue &right) const;
 
     int getIntFromStack();
     float getFloatFromStack();
     glm::vec3 getVectorFromStack();
+    void pushVectorToStack(const glm::vec3 &value);
 
-    void withStackVariables(const std::function<void(const Variable &, const Variable &)> &fn);
+    void withStackVariables(const std::function<void(const StackValue &, const StackValue &)> &fn);
     void withIntsFromStack(const std::function<void(int, int)> &fn);
     void withIntFloatFromStack(const std::function<void(int, float)> &fn);
     void withFloatIntFromStack(const std::function<void(float, int)> &fn);
@@ -172,6 +232,11 @@ private:
     R_INSTR_HANDLER(RESTOREBP)
     R_INSTR_HANDLER(STORE_STATE)
 
+    // Superinstructions
+
+    R_INSTR_HANDLER(CPDOWNSP_MOVSP)
+    R_INSTR_HANDLER(CPDOWNBP_MOVSP)
+
     // END Handlers
 };
 
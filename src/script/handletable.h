@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+namespace reone {
+
+namespace script {
+
+/**
+ * Table of shared objects, addressed by handle. Handle 0 is reserved for a
+ * null pointer. Objects are only released by clear and compact.
+ */
+template <class T>
+class HandleTable : boost::noncopyable {
+public:
+    HandleTable() {
+        _objects.push_back(nullptr);
+    }
+
+    uint32_t add(std::shared_ptr<T> object) {
+        if (!object) {
+            return 0;
+        }
+        _objects.push_back(std::move(object));
+        return static_cast<uint32_t>(_objects.size() - 1);
+    }
+
+    /**
+     * Releases all objects, retaining capacity.
+     */
+    void clear() {
+        _objects.resize(1);
+    }
+
+    /**
+     * Releases objects that none of the specified handles refer to, and
+     * renumbers the rest. Handles are updated in place.
+     */
+    void compact(const std::vector<uint32_t *> &handles) {
+        static constexpr uint32_t kNotRemapped = 0xffffffff;
+
+        std::vector<uint32_t> newHandles(_objects.size(), kNotRemapped);
+        newHandles[0] = 0;
+
+        std::vector<std::shared_ptr<T>> objects;
+        objects.reserve(_objects.capacity());
+        objects.push_back(nullptr);
+        for (auto &handle : handles) {
+            uint32_t &newHandle = newHandles[*handle];
+            if (newHandle == kNotRemapped) {
+                newHandle = static_cast<uint32_t>(objects.size());
+                objects.push_back(std::move(_objects[*handle]));
+            }
+            *handle = newHandle;
+        }
+        _objects = std::move(objects);
+    }
+
+    const std::shared_ptr<T> &get(uint32_t handle) const {
+        return _objects[handle];
+    }
+
+    int size() const { return static_cast<int>(_objects.size()); }
+
+private:
+    std::vector<std::shared_ptr<T>> _objects;
+};
+
+} // namespace script
+
+} // namespace reone
@@ -124,7 +124,9 @@ static unordered_map<InstructionType, string> g_descByInstrType {
     {InstructionType::SAVEBP, "SAVEBP"},
     {InstructionType::RESTOREBP, "RESTOREBP"},
     {InstructionType::STORE_STATE, "STORE_STATE"},
-    {InstructionType::NOP2, "NOP2"}};
+    {InstructionType::NOP2, "NOP2"},
+    {InstructionType::CPDOWNSP_MOVSP, "CPDOWNSP_MOVSP"},
+    {InstructionType::CPDOWNBP_MOVSP, "CPDOWNBP_MOVSP"}};
 
 static map<string, InstructionType> g_instrTypeByDesc = associate<pair<InstructionType, string>, string, InstructionType>(
     mapToEntries(g_descByInstrType),
@@ -141,6 +143,10 @@ string describeInstruction(const Instruction &ins, const IRoutines &routines) {
     case InstructionType::CPTOPBP:
         desc += str(boost::format(" %d, %d") % ins.stackOffset % ins.size);
         break;
+    case InstructionType::CPDOWNSP_MOVSP:
+    case InstructionType::CPDOWNBP_MOVSP:
+        desc += str(boost::format(" %d, %d, %d") % ins.stackOffset % ins.size % ins.moveOffset);
+        break;
     case InstructionType::CONSTI:
         desc += " " + to_string(ins.intValue);
         break;
@@ -0,0 +1,581 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "optimizer.h"
+
+#include "program.h"
+#include "routine.h"
+#include "routines.h"
+
+using namespace std;
+
+namespace reone {
+
+namespace script {
+
+static constexpr uint32_t kStoreStateResumeOffset = 0x10;
+
+static bool isJump(InstructionType type) {
+    switch (type) {
+    case InstructionType::JMP:
+    case InstructionType::JSR:
+    case InstructionType::JZ:
+    case InstructionType::JNZ:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static unordered_set<uint32_t> findLeaders(const vector<Instruction> &instructions) {
+    unordered_set<uint32_t> leaders;
+    if (instructions.empty()) {
+        return move(leaders);
+    }
+    leaders.insert(instructions.front().offset);
+
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        const Instruction &ins = instructions[i];
+        bool jump = isJump(ins.type);
+        if (jump) {
+            leaders.insert(ins.offset + ins.jumpOffset);
+        } else if (ins.type == InstructionType::STORE_STATE) {
+            leaders.insert(ins.offset + kStoreStateResumeOffset);
+        }
+        if ((jump || ins.type == InstructionType::RETN) && i + 1 < instructions.size()) {
+            leaders.insert(instructions[i + 1].offset);
+        }
+    }
+
+    return move(leaders);
+}
+
+static bool isMatchingConstant(InstructionType rsadd, InstructionType constant) {
+    switch (rsadd) {
+    case InstructionType::RSADDI:
+        return constant == InstructionType::CONSTI;
+    case InstructionType::RSADDF:
+        return constant == InstructionType::CONSTF;
+    case InstructionType::RSADDS:
+        return constant == InstructionType::CONSTS;
+    case InstructionType::RSADDO:
+        return constant == InstructionType::CONSTO;
+    default:
+        return false;
+    }
+}
+
+/**
+ * Evaluates a binary integer instruction the same way ScriptExecution does.
+ *
+ * @return false if instruction cannot be folded
+ */
+static bool foldInts(InstructionType type, int left, int right, int &result) {
+    auto uleft = static_cast<uint32_t>(left);
+    auto uright = static_cast<uint32_t>(right);
+
+    switch (type) {
+    case InstructionType::LOGANDII:
+        result = static_cast<int>(left && right);
+        return true;
+    case InstructionType::LOGORII:
+        result = static_cast<int>(left || right);
+        return true;
+    case InstructionType::INCORII:
+        result = left | right;
+        return true;
+    case InstructionType::EXCORII:
+        result = left ^ right;
+        return true;
+    case InstructionType::BOOLANDII:
+        result = left & right;
+        return true;
+    case InstructionType::EQUALII:
+        result = static_cast<int>(left == right);
+        return true;
+    case InstructionType::NEQUALII:
+        result = static_cast<int>(left != right);
+        return true;
+    case InstructionType::GEQII:
+        result = static_cast<int>(left >= right);
+        return true;
+    case InstructionType::GTII:
+        result = static_cast<int>(left > right);
+        return true;
+    case InstructionType::LTII:
+        result = static_cast<int>(left < right);
+        return true;
+    case InstructionType::LEQII:
+        result = static_cast<int>(left <= right);
+        return true;
+    case InstructionType::ADDII:
+        result = static_cast<int>(uleft + uright);
+        return true;
+    case InstructionType::SUBII:
+        result = static_cast<int>(uleft - uright);
+        return true;
+    case InstructionType::MULII:
+        result = static_cast<int>(uleft * uright);
+        return true;
+    case InstructionType::DIVII:
+    case InstructionType::MODII:
+        // Leave division by zero and overflow to the runtime
+        if (right == 0 || (left == numeric_limits<int>::min() && right == -1)) {
+            return false;
+        }
+        result = type == InstructionType::DIVII ? left / right : left % right;
+        return true;
+    default:
+        return false;
+    }
+}
+
+shared_ptr<ScriptProgram> ScriptOptimizer::optimize(const ScriptProgram &program) const {
+    vector<Instruction> instructions(program.instructions());
+    while (rewrite(instructions)) {
+    }
+
+    auto optimized = make_shared<ScriptProgram>(program.name());
+    optimized->setLength(program.length());
+    for (auto &ins : instructions) {
+        optimized->add(move(ins));
+    }
+    optimized->setStackSize(computeStackSize(*optimized));
+
+    return move(optimized);
+}
+
+bool ScriptOptimizer::rewrite(vector<Instruction> &instructions) const {
+    unordered_set<uint32_t> leaders(findLeaders(instructions));
+
+    // Returns true if count instructions starting at idx belong to the same basic block
+    auto isSequence = [&](size_t idx, size_t count) {
+        if (idx + count > instructions.size()) {
+            return false;
+        }
+        for (size_t i = idx + 1; i < idx + count; ++i) {
+            if (leaders.count(instructions[i].offset) > 0) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    vector<Instruction> result;
+    result.reserve(instructions.size());
+    bool changed = false;
+
+    size_t idx = 0;
+    while (idx < instructions.size()) {
+        const Instruction &ins = instructions[idx];
+
+        // RSADDx, CONSTx, CPDOWNSP -8, 4, MOVSP -4 => CONSTx
+        if (isSequence(idx, 4) &&
+            isMatchingConstant(ins.type, instructions[idx + 1].type) &&
+            instructions[idx + 2].type == InstructionType::CPDOWNSP &&
+            instructions[idx + 2].stackOffset == -8 &&
+            instructions[idx + 2].size == 4 &&
+            instructions[idx + 3].type == InstructionType::MOVSP &&
+            instructions[idx + 3].stackOffset == -4) {
+
+            Instruction constant(instructions[idx + 1]);
+            constant.offset = ins.offset;
+            constant.nextOffset = instructions[idx + 3].nextOffset;
+            result.push_back(move(constant));
+            idx += 4;
+            changed = true;
+            continue;
+        }
+
+        // RSADDx, CONSTx, CPDOWNSP_MOVSP -8, 4, -4 => CONSTx
+        if (isSequence(idx, 3) &&
+            isMatchingConstant(ins.type, instructions[idx + 1].type) &&
+            instructions[idx + 2].type == InstructionType::CPDOWNSP_MOVSP &&
+            instructions[idx + 2].stackOffset == -8 &&
+            instructions[idx + 2].size == 4 &&
+            instructions[idx + 2].moveOffset == -4) {
+
+            Instruction constant(instructions[idx + 1]);
+            constant.offset = ins.offset;
+            constant.nextOffset = instructions[idx + 2].nextOffset;
+            result.push_back(move(constant));
+            idx += 3;
+            changed = true;
+            continue;
+        }
+
+        if (ins.type == InstructionType::CONSTI) {
+            // CONSTI, CONSTI, <binary integer operation> => CONSTI
+            if (isSequence(idx, 3) && instructions[idx + 1].type == InstructionType::CONSTI) {
+                int value;
+                if (foldInts(instructions[idx + 2].type, ins.intValue, instructions[idx + 1].intValue, value)) {
+                    Instruction constant(ins);
+                    constant.intValue = value;
+                    constant.nextOffset = instructions[idx + 2].nextOffset;
+                    result.push_back(move(constant));
+                    idx += 3;
+                    changed = true;
+                    continue;
+                }
+            }
+            if (isSequence(idx, 2)) {
+                const Instruction &next = instructions[idx + 1];
+
+                // CONSTI, NEGI => CONSTI and CONSTI, NOTI => CONSTI
+                if (next.type == InstructionType::NEGI || next.type == InstructionType::NOTI) {
+                    Instruction constant(ins);
+                    constant.intValue = next.type == InstructionType::NEGI ? static_cast<int>(0u - static_cast<uint32_t>(ins.intValue)) : static_cast<int>(!ins.intValue);
+                    constant.nextOffset = next.nextOffset;
+                    result.push_back(move(constant));
+                    idx += 2;
+                    changed = true;
+                    continue;
+                }
+
+                // CONSTI, JZ/JNZ => JMP or nothing
+                if (next.type == InstructionType::JZ || next.type == InstructionType::JNZ) {
+                    bool taken = (next.type == InstructionType::JZ) == (ins.intValue == 0);
+                    if (taken) {
+                        Instruction jump;
+                        jump.offset = ins.offset;
+                        jump.type = InstructionType::JMP;
+                        jump.nextOffset = next.nextOffset;
+                        jump.jumpOffset = static_cast<int>(next.offset + next.jumpOffset - ins.offset);
+                        result.push_back(move(jump));
+                    } else if (leaders.count(ins.offset) > 0) {
+                        Instruction nop;
+                        nop.offset = ins.offset;
+                        nop.type = InstructionType::NOP;
+                        nop.nextOffset = next.nextOffset;
+                        result.push_back(move(nop));
+                    }
+                    idx += 2;
+                    changed = true;
+                    continue;
+                }
+            }
+        }
+
+        // CPDOWNSP, MOVSP => CPDOWNSP_MOVSP and CPDOWNBP, MOVSP => CPDOWNBP_MOVSP
+        if ((ins.type == InstructionType::CPDOWNSP || ins.type == InstructionType::CPDOWNBP) &&
+            isSequence(idx, 2) &&
+            instructions[idx + 1].type == InstructionType::MOVSP) {
+
+            Instruction fused(ins);
+            fused.type = ins.type == InstructionType::CPDOWNSP ? InstructionType::CPDOWNSP_MOVSP : InstructionType::CPDOWNBP_MOVSP;
+            fused.moveOffset = instructions[idx + 1].stackOffset;
+            fused.nextOffset = instructions[idx + 1].nextOffset;
+            result.push_back(move(fused));
+            idx += 2;
+            changed = true;
+            continue;
+        }
+
+        result.push_back(ins);
+        ++idx;
+    }
+
+    instructions = move(result);
+
+    return changed;
+}
+
+int ScriptOptimizer::computeStackSize(const ScriptProgram &program) const {
+    const vector<Instruction> &instructions = program.instructions();
+    if (instructions.empty()) {
+        return 0;
+    }
+
+    unordered_set<int> leaders;
+    for (uint32_t offset : findLeaders(instructions)) {
+        int idx = program.getInstructionIndex(offset);
+        if (idx != -1) {
+            leaders.insert(idx);
+        }
+    }
+
+    unordered_map<int, StackSummary> summaries;
+    unordered_set<int> inProgress;
+
+    StackSummary main;
+    if (!analyzeSubroutine(program, leaders, 0, summaries, inProgress, main)) {
+        return 0;
+    }
+    int result = main.maxDepth;
+
+    // Saved states are resumed with globals and locals already on the stack
+    for (auto &ins : instructions) {
+        if (ins.type != InstructionType::STORE_STATE) {
+            continue;
+        }
+        int resumeIdx = program.getInstructionIndex(ins.offset + kStoreStateResumeOffset);
+        if (resumeIdx == -1) {
+            continue;
+        }
+        StackSummary resumed;
+        if (!analyzeSubroutine(program, leaders, resumeIdx, summaries, inProgress, resumed)) {
+            return 0;
+        }
+        result = max(result, (ins.size + ins.sizeLocals) / 4 + resumed.maxDepth);
+    }
+
+    return result;
+}
+
+bool ScriptOptimizer::analyzeSubroutine(
+    const ScriptProgram &program,
+    const unordered_set<int> &leaders,
+    int startIdx,
+    unordered_map<int, StackSummary> &summaries,
+    unordered_set<int> &inProgress,
+    StackSummary &summary) const {
+
+    const vector<Instruction> &instructions = program.instructions();
+    int numInstructions = static_cast<int>(instructions.size());
+    if (startIdx < 0 || startIdx >= numInstructions) {
+        return false;
+    }
+
+    auto maybeSummary = summaries.find(startIdx);
+    if (maybeSummary != summaries.end()) {
+        summary = maybeSummary->second;
+        return true;
+    }
+    if (inProgress.count(startIdx) > 0) {
+        return false; // recursion
+    }
+    inProgress.insert(startIdx);
+
+    // Stack depth at entry to each basic block, relative to subroutine entry
+    unordered_map<int, int> entryDepths {{startIdx, 0}};
+    vector<int> blocks {startIdx};
+    auto enqueueBlock = [&](int idx, int depth) {
+        if (idx < 0 || idx >= numInstructions) {
+            return true; // execution stops
+        }
+        auto maybeDepth = entryDepths.find(idx);
+        if (maybeDepth != entryDepths.end()) {
+            return maybeDepth->second == depth;
+        }
+        entryDepths.insert(make_pair(idx, depth));
+        blocks.push_back(idx);
+        return true;
+    };
+
+    bool valid = true;
+    bool returns = false;
+    int maxDepth = 0;
+    int returnDepth = 0;
+
+    while (valid && !blocks.empty()) {
+        int idx = blocks.back();
+        blocks.pop_back();
+        int depth = entryDepths.find(idx)->second;
+
+        for (; idx < numInstructions; ++idx) {
+            const Instruction &ins = instructions[idx];
+            if (ins.type == InstructionType::JSR) {
+                StackSummary callee;
+                valid = analyzeSubroutine(program, leaders, ins.jumpIndex, summaries, inProgress, callee) &&
+                        enqueueBlock(idx + 1, depth + callee.netDelta);
+                maxDepth = max(maxDepth, depth + callee.maxDepth);
+                break;
+            }
+            if (ins.type == InstructionType::JMP) {
+                valid = enqueueBlock(ins.jumpIndex, depth);
+                break;
+            }
+            if (ins.type == InstructionType::JZ || ins.type == InstructionType::JNZ) {
+                --depth;
+                valid = enqueueBlock(ins.jumpIndex, depth) && enqueueBlock(idx + 1, depth);
+                break;
+            }
+            if (ins.type == InstructionType::RETN) {
+                valid = !returns || returnDepth == depth;
+                returns = true;
+                returnDepth = depth;
+                break;
+            }
+            int delta;
+            if (!getStackDelta(ins, delta)) {
+                valid = false;
+                break;
+            }
+            depth += delta;
+            maxDepth = max(maxDepth, depth);
+
+            if (leaders.count(idx + 1) > 0) {
+                valid = enqueueBlock(idx + 1, depth);
+                break;
+            }
+        }
+    }
+
+    inProgress.erase(startIdx);
+    if (!valid) {
+        return false;
+    }
+    summary.netDelta = returnDepth;
+    summary.maxDepth = maxDepth;
+    summaries.insert(make_pair(startIdx, summary));
+
+    return true;
+}
+
+bool ScriptOptimizer::getStackDelta(const Instruction &ins, int &delta) const {
+    switch (ins.type) {
+    case InstructionType::NOP:
+    case InstructionType::NOP2:
+    case InstructionType::CPDOWNSP:
+    case InstructionType::CPDOWNBP:
+    case InstructionType::NEGI:
+    case InstructionType::NEGF:
+    case InstructionType::NOTI:
+    case InstructionType::DECISP:
+    case InstructionType::INCISP:
+    case InstructionType::DECIBP:
+    case InstructionType::INCIBP:
+    case InstructionType::STORE_STATE:
+        delta = 0;
+        return true;
+    case InstructionType::RSADDI:
+    case InstructionType::RSADDF:
+    case InstructionType::RSADDS:
+    case InstructionType::RSADDO:
+    case InstructionType::RSADDEFF:
+    case InstructionType::RSADDEVT:
+    case InstructionType::RSADDLOC:
+    case InstructionType::RSADDTAL:
+    case InstructionType::CONSTI:
+    case InstructionType::CONSTF:
+    case InstructionType::CONSTS:
+    case InstructionType::CONSTO:
+    case InstructionType::SAVEBP:
+        delta = 1;
+        return true;
+    case InstructionType::CPTOPSP:
+    case InstructionType::CPTOPBP:
+        delta = ins.size / 4;
+        return true;
+    case InstructionType::MOVSP:
+        delta = ins.stackOffset / 4;
+        return true;
+    case InstructionType::CPDOWNSP_MOVSP:
+    case InstructionType::CPDOWNBP_MOVSP:
+        delta = ins.moveOffset / 4;
+        return true;
+    case InstructionType::EQUALTT:
+    case InstructionType::NEQUALTT:
+        delta = 1 - 2 * (ins.size / 4);
+        return true;
+    case InstructionType::DESTRUCT:
+        delta = (ins.sizeNoDestroy - ins.size) / 4;
+        return true;
+    case InstructionType::ACTION: {
+        if (ins.routine < 0 || ins.routine >= _routines.getNumRoutines()) {
+            return false;
+        }
+        const Routine &routine = _routines.get(ins.routine);
+        if (ins.argCount > routine.getArgumentCount()) {
+            return false;
+        }
+        delta = 0;
+        for (int i = 0; i < ins.argCount; ++i) {
+            VariableType type = routine.getArgumentType(i);
+            if (type == VariableType::Vector) {
+                delta -= 3;
+            } else if (type != VariableType::Action) {
+                --delta;
+            }
+        }
+        if (routine.returnType() == VariableType::Vector) {
+            delta += 3;
+        } else if (routine.returnType() != VariableType::Void) {
+            ++delta;
+        }
+        return true;
+    }
+    case InstructionType::LOGANDII:
+    case InstructionType::LOGORII:
+    case InstructionType::INCORII:
+    case InstructionType::EXCORII:
+    case InstructionType::BOOLANDII:
+    case InstructionType::EQUALII:
+    case InstructionType::EQUALFF:
+    case InstructionType::EQUALSS:
+    case InstructionType::EQUALOO:
+    case InstructionType::EQUALEFFEFF:
+    case InstructionType::EQUALEVTEVT:
+    case InstructionType::EQUALLOCLOC:
+    case InstructionType::EQUALTALTAL:
+    case InstructionType::NEQUALII:
+    case InstructionType::NEQUALFF:
+    case InstructionType::NEQUALSS:
+    case InstructionType::NEQUALOO:
+    case InstructionType::NEQUALEFFEFF:
+    case InstructionType::NEQUALEVTEVT:
+    case InstructionType::NEQUALLOCLOC:
+    case InstructionType::NEQUALTALTAL:
+    case InstructionType::GEQII:
+    case InstructionType::GEQFF:
+    case InstructionType::GTII:
+    case InstructionType::GTFF:
+    case InstructionType::LTII:
+    case InstructionType::LTFF:
+    case InstructionType::LEQII:
+    case InstructionType::LEQFF:
+    case InstructionType::SHLEFTII:
+    case InstructionType::SHRIGHTII:
+    case InstructionType::USHRIGHTII:
+    case InstructionType::ADDII:
+    case InstructionType::ADDIF:
+    case InstructionType::ADDFI:
+    case InstructionType::ADDFF:
+    case InstructionType::ADDSS:
+    case InstructionType::SUBII:
+    case InstructionType::SUBIF:
+    case InstructionType::SUBFI:
+    case InstructionType::SUBFF:
+    case InstructionType::MULII:
+    case InstructionType::MULIF:
+    case InstructionType::MULFI:
+    case InstructionType::MULFF:
+    case InstructionType::MULVF:
+    case InstructionType::MULFV:
+    case InstructionType::DIVII:
+    case InstructionType::DIVIF:
+    case InstructionType::DIVFI:
+    case InstructionType::DIVFF:
+    case InstructionType::DIVVF:
+    case InstructionType::DIVFV:
+    case InstructionType::MODII:
+    case InstructionType::RESTOREBP:
+        delta = -1;
+        return true;
+    case InstructionType::ADDVV:
+    case InstructionType::SUBVV:
+        delta = -3;
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // namespace script
+
+} // namespace reone
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "types.h"
+
+namespace reone {
+
+namespace script {
+
+struct Instruction;
+
+class IRoutines;
+class ScriptProgram;
+
+/**
+ * Ahead-of-time optimization pass over decoded NCS programs. Folds
+ * constants, fuses common instruction sequences into superinstructions and
+ * computes the maximum stack size, so that executions can preallocate it.
+ *
+ * Rewrites never cross basic block boundaries and preserve offsets of block
+ * leaders, so that jumps and saved states remain valid.
+ */
+class ScriptOptimizer : boost::noncopyable {
+public:
+    ScriptOptimizer(IRoutines &routines) :
+        _routines(routines) {
+    }
+
+    std::shared_ptr<ScriptProgram> optimize(const ScriptProgram &program) const;
+
+    /**
+     * @return maximum number of stack slots used by the program, or 0 if it cannot be determined
+     */
+    int computeStackSize(const ScriptProgram &program) const;
+
+private:
+    struct StackSummary {
+        int netDelta {0};
+        int maxDepth {0};
+    };
+
+    IRoutines &_routines;
+
+    bool rewrite(std::vector<Instruction> &instructions) const;
+
+    bool analyzeSubroutine(
+        const ScriptProgram &program,
+        const std::unordered_set<int> &leaders,
+        int startIdx,
+        std::unordered_map<int, StackSummary> &summaries,
+        std::unordered_set<int> &inProgress,
+        StackSummary &summary) const;
+
+    bool getStackDelta(const Instruction &ins, int &delta) const;
+};
+
+} // namespace script
+
+} // namespace reone
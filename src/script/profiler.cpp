@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "profiler.h"
+
+using namespace std;
+
+namespace fs = boost::filesystem;
+
+namespace reone {
+
+namespace script {
+
+static constexpr int kNumInstructionCounters = 0x10000;
+
+struct ProfileFrame {
+    ScriptProfileFrameType type {ScriptProfileFrameType::Script};
+    const string *name {nullptr};
+    chrono::steady_clock::time_point startTime;
+    uint64_t childTime {0};
+    size_t parentStackLength {0};
+    bool call {true};
+};
+
+struct ProfileStats {
+    uint64_t calls {0};
+    uint64_t inclusiveTime {0};
+    uint64_t exclusiveTime {0};
+};
+
+static bool g_enabled = false;
+static int g_suspensions = 0;
+
+static vector<ProfileFrame> g_frames;
+static string g_stack; /**< names of current frames, separated by semicolons */
+
+static unordered_map<string, ProfileStats> g_scriptStats;
+static unordered_map<string, ProfileStats> g_routineStats;
+static unordered_map<string, uint64_t> g_exclusiveTimeByStack;
+static vector<uint64_t> g_instructionCounts;
+
+void setScriptProfilingEnabled(bool enabled) {
+    if (enabled && g_instructionCounts.empty()) {
+        g_instructionCounts.resize(kNumInstructionCounters, 0);
+    }
+    g_enabled = enabled;
+}
+
+bool isScriptProfilingEnabled() {
+    return g_enabled && g_suspensions == 0;
+}
+
+void resetScriptProfile() {
+    g_scriptStats.clear();
+    g_routineStats.clear();
+    g_exclusiveTimeByStack.clear();
+    fill(g_instructionCounts.begin(), g_instructionCounts.end(), 0);
+}
+
+void beginScriptProfileFrame(ScriptProfileFrameType type, const string &name, bool call) {
+    ProfileFrame frame;
+    frame.type = type;
+    frame.name = &name;
+    frame.call = call;
+    frame.parentStackLength = g_stack.length();
+    if (!g_stack.empty()) {
+        g_stack += ';';
+    }
+    g_stack += name;
+    frame.startTime = chrono::steady_clock::now();
+    g_frames.push_back(move(frame));
+}
+
+void endScriptProfileFrame() {
+    auto now = chrono::steady_clock::now();
+
+    const ProfileFrame &frame = g_frames.back();
+    auto inclusiveTime = static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(now - frame.startTime).count());
+    uint64_t exclusiveTime = inclusiveTime > frame.childTime ? inclusiveTime - frame.childTime : 0;
+
+    auto &allStats = frame.type == ScriptProfileFrameType::Script ? g_scriptStats : g_routineStats;
+    ProfileStats &stats = allStats[*frame.name];
+    if (frame.call) {
+        ++stats.calls;
+    }
+    stats.inclusiveTime += inclusiveTime;
+    stats.exclusiveTime += exclusiveTime;
+
+    g_exclusiveTimeByStack[g_stack] += exclusiveTime;
+    g_stack.resize(frame.parentStackLength);
+    g_frames.pop_back();
+
+    if (!g_frames.empty()) {
+        g_frames.back().childTime += inclusiveTime;
+    }
+}
+
+uint64_t *getScriptInstructionCounters() {
+    return g_instructionCounts.empty() ? nullptr : &g_instructionCounts[0];
+}
+
+vector<ScriptProfileEntry> getScriptProfile(ScriptProfileFrameType type) {
+    const auto &allStats = type == ScriptProfileFrameType::Script ? g_scriptStats : g_routineStats;
+
+    vector<ScriptProfileEntry> entries;
+    entries.reserve(allStats.size());
+    for (auto &pair : allStats) {
+        ScriptProfileEntry entry;
+        entry.name = pair.first;
+        entry.calls = pair.second.calls;
+        entry.inclusiveTime = pair.second.inclusiveTime;
+        entry.exclusiveTime = pair.second.exclusiveTime;
+        entries.push_back(move(entry));
+    }
+    sort(entries.begin(), entries.end(), [](auto &left, auto &right) {
+        return left.exclusiveTime > right.exclusiveTime;
+    });
+
+    return entries;
+}
+
+vector<pair<InstructionType, uint64_t>> getScriptInstructionHistogram() {
+    vector<pair<InstructionType, uint64_t>> histogram;
+    for (size_t i = 0; i < g_instructionCounts.size(); ++i) {
+        if (g_instructionCounts[i] > 0) {
+            histogram.push_back(make_pair(static_cast<InstructionType>(i), g_instructionCounts[i]));
+        }
+    }
+    sort(histogram.begin(), histogram.end(), [](auto &left, auto &right) {
+        return left.second > right.second;
+    });
+
+    return histogram;
+}
+
+void saveScriptProfile(const fs::path &path) {
+    fs::ofstream out(path);
+    if (!out) {
+        throw runtime_error("Unable to open file for writing: " + path.string());
+    }
+    for (auto &pair : g_exclusiveTimeByStack) {
+        // Collapsed stack samples are integers, hence microseconds
+        out << pair.first << " " << pair.second / 1000 << '\n';
+    }
+}
+
+ScriptProfileSuspension::ScriptProfileSuspension() {
+    ++g_suspensions;
+}
+
+ScriptProfileSuspension::~ScriptProfileSuspension() {
+    --g_suspensions;
+}
+
+} // namespace script
+
+} // namespace reone
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "types.h"
+
+namespace reone {
+
+namespace script {
+
+enum class ScriptProfileFrameType {
+    Script,
+    Routine
+};
+
+struct ScriptProfileEntry {
+    std::string name;
+    uint64_t calls {0};
+    uint64_t inclusiveTime {0}; /**< nanoseconds */
+    uint64_t exclusiveTime {0}; /**< nanoseconds */
+};
+
+/**
+ * Opt-in NWScript profiler. Collects call counts and inclusive and exclusive
+ * times of scripts and routines, and counts executed instructions by type.
+ * Must only be used from the main thread.
+ */
+void setScriptProfilingEnabled(bool enabled);
+bool isScriptProfilingEnabled();
+void resetScriptProfile();
+
+/**
+ * @param call false if the frame continues an earlier call, e.g. when a yielded script is resumed
+ */
+void beginScriptProfileFrame(ScriptProfileFrameType type, const std::string &name, bool call = true);
+void endScriptProfileFrame();
+
+/**
+ * @return array of executed instruction counts, indexed by instruction type
+ */
+uint64_t *getScriptInstructionCounters();
+
+/**
+ * @return profile entries of the specified type, sorted by exclusive time in descending order
+ */
+std::vector<ScriptProfileEntry> getScriptProfile(ScriptProfileFrameType type);
+
+/**
+ * @return executed instruction counts by type, sorted in descending order
+ */
+std::vector<std::pair<InstructionType, uint64_t>> getScriptInstructionHistogram();
+
+/**
+ * Saves exclusive times of script and routine call stacks in the collapsed
+ * stack format, which flame graph tools can render.
+ */
+void saveScriptProfile(const boost::filesystem::path &path);
+
+/**
+ * Profile frame of the current scope, if profiling is enabled.
+ */
+class ScriptProfileScope : boost::noncopyable {
+public:
+    ScriptProfileScope(ScriptProfileFrameType type, const std::string &name, bool call = true) :
+        _active(isScriptProfilingEnabled()) {
+
+        if (_active) {
+            beginScriptProfileFrame(type, name, call);
+        }
+    }
+
+    ~ScriptProfileScope() {
+        if (_active) {
+            endScriptProfileFrame();
+        }
+    }
+
+private:
+    bool _active;
+};
+
+/**
+ * Suspends profiling for the lifetime of this object, e.g. while executing
+ * code that is already accounted for by another frame.
+ */
+class ScriptProfileSuspension : boost::noncopyable {
+public:
+    ScriptProfileSuspension();
+    ~ScriptProfileSuspension();
+};
+
+} // namespace script
+
+} // namespace reone
@@ -23,9 +23,44 @@ namespace reone {
 
 namespace script {
 
+static bool isJump(InstructionType type) {
+    switch (type) {
+    case InstructionType::JMP:
+    case InstructionType::JSR:
+    case InstructionType::JZ:
+    case InstructionType::JNZ:
+        return true;
+    default:
+        return false;
+    }
+}
+
 void ScriptProgram::add(Instruction instr) {
+    int idx = static_cast<int>(_instructions.size());
+    uint32_t offset = instr.offset;
+
+    // Resolve jump target, or defer until the target instruction is added
+    if (isJump(instr.type)) {
+        uint32_t target = instr.offset + instr.jumpOffset;
+        auto maybeIdx = _insIdxByOffset.find(target);
+        if (maybeIdx != _insIdxByOffset.end()) {
+            instr.jumpIndex = maybeIdx->second;
+        } else {
+            _pendingJumps[target].push_back(idx);
+        }
+    }
+
     _instructions.push_back(move(instr));
-    _insIdxByOffset.insert(make_pair(instr.offset, static_cast<int>(_instructions.size() - 1)));
+    _insIdxByOffset.insert(make_pair(offset, idx));
+
+    // Resolve forward jumps to this instruction
+    auto maybePending = _pendingJumps.find(offset);
+    if (maybePending != _pendingJumps.end()) {
+        for (int jumpIdx : maybePending->second) {
+            _instructions[jumpIdx].jumpIndex = idx;
+        }
+        _pendingJumps.erase(maybePending);
+    }
 }
 
 const Instruction &ScriptProgram::getInstruction(uint32_t offset) const {
@@ -33,6 +68,11 @@ const Instruction &ScriptProgram::getInstruction(uint32_t offset) const {
     return _instructions[idx];
 }
 
+int ScriptProgram::getInstructionIndex(uint32_t offset) const {
+    auto maybeIdx = _insIdxByOffset.find(offset);
+    return maybeIdx != _insIdxByOffset.end() ? maybeIdx->second : -1;
+}
+
 } // namespace script
 
 } // namespace reone
@@ -27,6 +27,7 @@ struct Instruction {
     uint32_t offset {0};
     InstructionType type {InstructionType::NOP};
     uint32_t nextOffset {0};
+    int jumpIndex {-1}; /**< index of the jump target for JMP, JSR, JZ and JNZ, or -1 if it lies outside of the program */
     std::string strValue;
 
     union {
@@ -46,6 +47,7 @@ struct Instruction {
         int objectId; // used only for CONSTO
         int sizeLocals;
         int sizeNoDestroy;
+        int moveOffset; // used only for CPDOWNSP_MOVSP and CPDOWNBP_MOVSP
     };
 };
 
@@ -59,18 +61,39 @@ public:
 
     const std::string &name() const { return _name; }
     uint32_t length() const { return _length; }
-    const std::vector<Instruction> instructions() const { return _instructions; }
+    int stackSize() const { return _stackSize; }
+    const std::vector<Instruction> &instructions() const { return _instructions; }
 
     const Instruction &getInstruction(uint32_t offset) const;
 
+    /**
+     * @return index of the instruction at the specified offset, or -1 if not found
+     */
+    int getInstructionIndex(uint32_t offset) const;
+
     void setLength(uint32_t length) { _length = length; }
 
+    /**
+     * @param size maximum number of stack slots used by this program, or 0 if unknown
+     */
+    void setStackSize(int size) { _stackSize = size; }
+
+    /**
+     * Keeps the program this one was optimized from, for verification.
+     */
+    void setOriginal(std::shared_ptr<ScriptProgram> original) { _original = std::move(original); }
+
+    std::shared_ptr<ScriptProgram> original() const { return _original; }
+
 private:
     std::string _name;
 
     uint32_t _length {0};
+    int _stackSize {0};
+    std::shared_ptr<ScriptProgram> _original;
     std::vector<Instruction> _instructions;
     std::unordered_map<uint32_t, int> _insIdxByOffset;
+    std::unordered_map<uint32_t, std::vector<int>> _pendingJumps; /**< forward jumps by target offset */
 };
 
 } // namespace script
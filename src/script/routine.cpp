@@ -21,6 +21,8 @@
 #include "../script/exception/argument.h"
 #include "../script/exception/notimpl.h"
 
+#include "profiler.h"
+#include "routinestack.h"
 #include "variable.h"
 
 using namespace std;
@@ -30,6 +32,7 @@ namespace reone {
 namespace script {
 
 Variable Routine::invoke(const vector<Variable> &args, ExecutionContext &ctx) const {
+    ScriptProfileScope profileScope(ScriptProfileFrameType::Routine, _name);
     try {
         return _func(args, ctx);
     } catch (const NotImplementedException &ex) {
@@ -41,6 +44,19 @@ Variable Routine::invoke(const vector<Variable> &args, ExecutionContext &ctx) co
     }
 }
 
+void Routine::invoke(RoutineStack &stack, ExecutionContext &ctx) const {
+    ScriptProfileScope profileScope(ScriptProfileFrameType::Routine, _name);
+    try {
+        _typedFunc(stack, ctx);
+    } catch (const NotImplementedException &ex) {
+        string msg = "Routine not implemented: " + _name;
+        stack.pushVariable(onException(msg, ex));
+    } catch (const ArgumentException &ex) {
+        string msg = str(boost::format("Routine '%s' invocation failed: %s") % _name % ex.what());
+        stack.pushVariable(onException(msg, ex));
+    }
+}
+
 Variable Routine::onException(const string &msg, const exception &ex) const {
     switch (_returnType) {
     case VariableType::Action:
@@ -26,6 +26,8 @@ namespace script {
 
 struct ExecutionContext;
 
+class RoutineStack;
+
 class Routine {
 public:
     Routine(
@@ -41,8 +43,35 @@ public:
         _func(std::move(fn)) {
     }
 
+    /**
+     * Constructs a typed routine, which besides the generic calling convention
+     * can pop its arguments directly off the VM stack.
+     */
+    Routine(
+        std::string name,
+        VariableType retType,
+        Variable defRetValue,
+        std::vector<VariableType> argTypes,
+        std::function<Variable(const std::vector<Variable> &, ExecutionContext &ctx)> fn,
+        std::function<void(RoutineStack &, ExecutionContext &ctx)> typedFn) :
+        _name(std::move(name)),
+        _returnType(retType),
+        _defaultReturnValue(std::move(defRetValue)),
+        _argumentTypes(std::move(argTypes)),
+        _func(std::move(fn)),
+        _typedFunc(std::move(typedFn)) {
+    }
+
     Variable invoke(const std::vector<Variable> &args, ExecutionContext &ctx) const;
 
+    /**
+     * Invokes this typed routine, popping all of its arguments off the stack
+     * and pushing its return value.
+     */
+    void invoke(RoutineStack &stack, ExecutionContext &ctx) const;
+
+    bool isTyped() const { return static_cast<bool>(_typedFunc); }
+
     int getArgumentCount() const;
     VariableType getArgumentType(int index) const;
 
@@ -55,6 +84,7 @@ private:
     Variable _defaultReturnValue;
     std::vector<VariableType> _argumentTypes;
     std::function<Variable(const std::vector<Variable> &, ExecutionContext &ctx)> _func;
+    std::function<void(RoutineStack &, ExecutionContext &ctx)> _typedFunc;
 
     Variable onException(const std::string &msg, const std::exception &ex) const;
 };
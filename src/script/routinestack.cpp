@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "routinestack.h"
+
+#include "variable.h"
+
+using namespace std;
+
+namespace reone {
+
+namespace script {
+
+void RoutineStack::pushVariable(const Variable &var) {
+    switch (var.type) {
+    case VariableType::Void:
+        break;
+    case VariableType::Int:
+        pushInt(var.intValue);
+        break;
+    case VariableType::Float:
+        pushFloat(var.floatValue);
+        break;
+    case VariableType::Object:
+        pushObject(var.objectId);
+        break;
+    case VariableType::String:
+        pushString(var.strValue);
+        break;
+    case VariableType::Vector:
+        pushVector(var.vecValue);
+        break;
+    default:
+        throw invalid_argument("Unsupported variable type: " + to_string(static_cast<int>(var.type)));
+    }
+}
+
+} // namespace script
+
+} // namespace reone
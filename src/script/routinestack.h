@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "stackvalue.h"
+#include "stringpool.h"
+
+namespace reone {
+
+namespace script {
+
+struct Variable;
+
+/**
+ * View of the VM stack, through which typed routines pop their arguments and
+ * push return values without intermediate containers.
+ */
+class RoutineStack : boost::noncopyable {
+public:
+    RoutineStack(std::vector<StackValue> &stack, StringPool &strings) :
+        _stack(stack),
+        _strings(strings) {
+    }
+
+    int popInt() { return pop(VariableType::Int).intValue; }
+    float popFloat() { return pop(VariableType::Float).floatValue; }
+    uint32_t popObject() { return pop(VariableType::Object).objectId; }
+    const std::string &popString() { return _strings.get(pop(VariableType::String).handle); }
+
+    glm::vec3 popVector() {
+        float x = popFloat();
+        float y = popFloat();
+        float z = popFloat();
+        return glm::vec3(x, y, z);
+    }
+
+    void pushInt(int value) { _stack.push_back(StackValue::ofInt(value)); }
+    void pushFloat(float value) { _stack.push_back(StackValue::ofFloat(value)); }
+    void pushObject(uint32_t objectId) { _stack.push_back(StackValue::ofObject(objectId)); }
+    void pushString(const std::string &value) { _stack.push_back(StackValue::ofHandle(VariableType::String, _strings.intern(value))); }
+
+    void pushVector(const glm::vec3 &value) {
+        pushFloat(value.z);
+        pushFloat(value.y);
+        pushFloat(value.x);
+    }
+
+    /**
+     * Pushes a variable of type Int, Float, Object, String or Vector. Void
+     * variables are ignored.
+     */
+    void pushVariable(const Variable &var);
+
+private:
+    std::vector<StackValue> &_stack;
+    StringPool &_strings;
+
+    StackValue pop(VariableType type) {
+        StackValue value(_stack.back());
+        _stack.pop_back();
+
+        if (value.type != type) {
+            throw std::runtime_error("Invalid argument variable type");
+        }
+
+        return value;
+    }
+};
+
+} // namespace script
+
+} // namespace reone
@@ -17,8 +17,6 @@
 
 #include "scripts.h"
 
-#include "../common/streamutil.h"
-
 #include "format/ncsreader.h"
 
 using namespace std;
@@ -35,15 +33,31 @@ Scripts::Scripts(Resources &resources) :
     _resources(resources) {
 }
 
+void Scripts::setOptimizer(unique_ptr<ScriptOptimizer> optimizer, bool verify) {
+    _optimizer = move(optimizer);
+    _verify = verify;
+    clear();
+}
+
 shared_ptr<ScriptProgram> Scripts::doGet(string resRef) {
-    shared_ptr<ByteArray> data(_resources.get(resRef, ResourceType::Ncs));
+    ByteView data(_resources.getView(resRef, ResourceType::Ncs));
     if (!data)
         return nullptr;
 
     NcsReader ncs(resRef);
-    ncs.load(wrap(data));
+    ncs.load(move(data));
+
+    shared_ptr<ScriptProgram> program(ncs.program());
+    if (!_optimizer) {
+        return move(program);
+    }
+
+    shared_ptr<ScriptProgram> optimized(_optimizer->optimize(*program));
+    if (_verify) {
+        optimized->setOriginal(move(program));
+    }
 
-    return ncs.program();
+    return move(optimized);
 }
 
 } // namespace script
@@ -20,6 +20,7 @@
 #include "../common/memorycache.h"
 #include "../resource/resources.h"
 
+#include "optimizer.h"
 #include "program.h"
 
 namespace reone {
@@ -30,9 +31,17 @@ class Scripts : public MemoryCache<std::string, ScriptProgram> {
 public:
     Scripts(resource::Resources &resources);
 
+    /**
+     * @param verify keep original programs, so that optimizations can be verified
+     */
+    void setOptimizer(std::unique_ptr<ScriptOptimizer> optimizer, bool verify = false);
+
 private:
     resource::Resources &_resources;
 
+    std::unique_ptr<ScriptOptimizer> _optimizer;
+    bool _verify {false};
+
     std::shared_ptr<ScriptProgram> doGet(std::string resRef);
 };
 
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "types.h"
+
+namespace reone {
+
+namespace script {
+
+/**
+ * Compact tagged value stored on the script VM stack. Strings, engine types
+ * and action contexts are referenced by handles into tables owned by the
+ * execution. Vectors occupy three consecutive float values, as in NCS.
+ */
+struct StackValue {
+    VariableType type {VariableType::Void};
+
+    union {
+        int32_t intValue {0};
+        uint32_t objectId;
+        float floatValue;
+        uint32_t handle;
+    };
+
+    static StackValue ofNull() {
+        return StackValue();
+    }
+
+    static StackValue ofInt(int value) {
+        StackValue result;
+        result.type = VariableType::Int;
+        result.intValue = value;
+        return result;
+    }
+
+    static StackValue ofFloat(float value) {
+        StackValue result;
+        result.type = VariableType::Float;
+        result.floatValue = value;
+        return result;
+    }
+
+    static StackValue ofObject(uint32_t objectId) {
+        StackValue result;
+        result.type = VariableType::Object;
+        result.objectId = objectId;
+        return result;
+    }
+
+    static StackValue ofHandle(VariableType type, uint32_t handle) {
+        StackValue result;
+        result.type = type;
+        result.handle = handle;
+        return result;
+    }
+};
+
+static_assert(sizeof(StackValue) == 8, "StackValue must be 8 bytes");
+
+} // namespace script
+
+} // namespace reone
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "stringpool.h"
+
+using namespace std;
+
+namespace reone {
+
+namespace script {
+
+StringPool::StringPool() {
+    _strings.push_back("");
+}
+
+uint32_t StringPool::intern(const string &value) {
+    if (value.empty()) {
+        return 0;
+    }
+    auto maybeHandle = _handleByValue.find(value);
+    if (maybeHandle != _handleByValue.end()) {
+        return maybeHandle->second;
+    }
+    auto handle = static_cast<uint32_t>(_strings.size());
+    _strings.push_back(value);
+    _bytes += value.length();
+    _handleByValue.insert(make_pair(string_view(_strings.back()), handle));
+    return handle;
+}
+
+void StringPool::clear() {
+    _handleByValue.clear();
+    _strings.resize(1);
+    _bytes = 0;
+}
+
+void StringPool::compact(const vector<uint32_t *> &handles) {
+    static constexpr uint32_t kNotRemapped = 0xffffffff;
+
+    vector<uint32_t> newHandles(_strings.size(), kNotRemapped);
+    newHandles[0] = 0;
+
+    deque<string> strings;
+    strings.push_back("");
+    _bytes = 0;
+    for (auto &handle : handles) {
+        uint32_t &newHandle = newHandles[*handle];
+        if (newHandle == kNotRemapped) {
+            newHandle = static_cast<uint32_t>(strings.size());
+            _bytes += _strings[*handle].length();
+            strings.push_back(move(_strings[*handle]));
+        }
+        *handle = newHandle;
+    }
+    _strings = move(strings);
+
+    _handleByValue.clear();
+    for (uint32_t i = 1; i < _strings.size(); ++i) {
+        _handleByValue.insert(make_pair(string_view(_strings[i]), i));
+    }
+}
+
+} // namespace script
+
+} // namespace reone
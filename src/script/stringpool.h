@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+namespace reone {
+
+namespace script {
+
+/**
+ * Pool of interned strings, addressed by handle. Equal strings share a
+ * handle, and handle 0 is reserved for an empty string.
+ */
+class StringPool : boost::noncopyable {
+public:
+    StringPool();
+
+    uint32_t intern(const std::string &value);
+
+    /**
+     * Releases all strings except the empty one, retaining capacity.
+     */
+    void clear();
+
+    /**
+     * Releases strings that none of the specified handles refer to, and
+     * renumbers the rest. Handles are updated in place.
+     */
+    void compact(const std::vector<uint32_t *> &handles);
+
+    const std::string &get(uint32_t handle) const { return _strings[handle]; }
+
+    int size() const { return static_cast<int>(_strings.size()); }
+
+    /**
+     * @return total length of pooled strings
+     */
+    size_t bytes() const { return _bytes; }
+
+private:
+    std::deque<std::string> _strings;
+    size_t _bytes {0};
+    std::unordered_map<std::string_view, uint32_t> _handleByValue;
+};
+
+} // namespace script
+
+} // namespace reone
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "exception/argument.h"
+#include "routinestack.h"
+#include "variable.h"
+
+namespace reone {
+
+namespace script {
+
+/**
+ * Maps a C++ type of a typed routine argument or return value to its
+ * NWScript counterpart. Objects are represented by uint32_t, as opposed to
+ * int for integers.
+ */
+template <class T>
+struct RoutineValue;
+
+template <>
+struct RoutineValue<void> {
+    static constexpr VariableType type = VariableType::Void;
+};
+
+template <>
+struct RoutineValue<int> {
+    static constexpr VariableType type = VariableType::Int;
+
+    static int pop(RoutineStack &stack) { return stack.popInt(); }
+    static void push(RoutineStack &stack, int value) { stack.pushInt(value); }
+
+    static int fromVariable(const Variable &var) { return var.intValue; }
+    static Variable toVariable(int value) { return Variable::ofInt(value); }
+};
+
+template <>
+struct RoutineValue<float> {
+    static constexpr VariableType type = VariableType::Float;
+
+    static float pop(RoutineStack &stack) { return stack.popFloat(); }
+    static void push(RoutineStack &stack, float value) { stack.pushFloat(value); }
+
+    static float fromVariable(const Variable &var) { return var.floatValue; }
+    static Variable toVariable(float value) { return Variable::ofFloat(value); }
+};
+
+template <>
+struct RoutineValue<uint32_t> {
+    static constexpr VariableType type = VariableType::Object;
+
+    static uint32_t pop(RoutineStack &stack) { return stack.popObject(); }
+    static void push(RoutineStack &stack, uint32_t objectId) { stack.pushObject(objectId); }
+
+    static uint32_t fromVariable(const Variable &var) { return var.objectId; }
+    static Variable toVariable(uint32_t objectId) { return Variable::ofObject(objectId); }
+};
+
+template <>
+struct RoutineValue<std::string> {
+    static constexpr VariableType type = VariableType::String;
+
+    static const std::string &pop(RoutineStack &stack) { return stack.popString(); }
+    static void push(RoutineStack &stack, const std::string &value) { stack.pushString(value); }
+
+    static const std::string &fromVariable(const Variable &var) { return var.strValue; }
+    static Variable toVariable(std::string value) { return Variable::ofString(std::move(value)); }
+};
+
+template <>
+struct RoutineValue<glm::vec3> {
+    static constexpr VariableType type = VariableType::Vector;
+
+    static glm::vec3 pop(RoutineStack &stack) { return stack.popVector(); }
+    static void push(RoutineStack &stack, const glm::vec3 &value) { stack.pushVector(value); }
+
+    static glm::vec3 fromVariable(const Variable &var) { return var.vecValue; }
+    static Variable toVariable(glm::vec3 value) { return Variable::ofVector(std::move(value)); }
+};
+
+template <class T>
+using RoutineValueOf = RoutineValue<std::decay_t<T>>;
+
+template <class Context, class R, class... Args>
+VariableType getRoutineReturnType(R (*)(const Context &, Args...)) {
+    return RoutineValueOf<R>::type;
+}
+
+template <class Context, class R, class... Args>
+std::vector<VariableType> getRoutineArgumentTypes(R (*)(const Context &, Args...)) {
+    return std::vector<VariableType> {RoutineValueOf<Args>::type...};
+}
+
+/**
+ * Calls fn with the context and arguments popped directly off the stack, and
+ * pushes its return value.
+ */
+template <class Context, class R, class... Args>
+void invokeTypedRoutine(R (*fn)(const Context &, Args...), const Context &ctx, RoutineStack &stack) {
+    // Braced initialization guarantees that arguments are popped in order
+    std::tuple<Args...> args {RoutineValueOf<Args>::pop(stack)...};
+
+    if constexpr (std::is_void_v<R>) {
+        std::apply([&fn, &ctx](auto &&...args) { fn(ctx, std::forward<decltype(args)>(args)...); }, args);
+    } else {
+        R result = std::apply([&fn, &ctx](auto &&...args) { return fn(ctx, std::forward<decltype(args)>(args)...); }, args);
+        RoutineValueOf<R>::push(stack, result);
+    }
+}
+
+template <class Context, class R, class... Args, std::size_t... I>
+Variable invokeTypedRoutine(R (*fn)(const Context &, Args...), const Context &ctx, const std::vector<Variable> &args, std::index_sequence<I...>) {
+    if (args.size() < sizeof...(Args)) {
+        throw ArgumentException(str(boost::format("Argument index is out of range: %d/%d") % static_cast<int>(sizeof...(Args) - 1) % static_cast<int>(args.size())));
+    }
+    bool typesMatch = ((args[I].type == RoutineValueOf<Args>::type) && ...);
+    if (!typesMatch) {
+        throw ArgumentException("Unexpected argument type");
+    }
+    if constexpr (std::is_void_v<R>) {
+        fn(ctx, RoutineValueOf<Args>::fromVariable(args[I])...);
+        return Variable::ofNull();
+    } else {
+        return RoutineValueOf<R>::toVariable(fn(ctx, RoutineValueOf<Args>::fromVariable(args[I])...));
+    }
+}
+
+/**
+ * Calls fn with the context and arguments converted from variables. Used
+ * when a typed routine is invoked through the generic calling convention.
+ */
+template <class Context, class R, class... Args>
+Variable invokeTypedRoutine(R (*fn)(const Context &, Args...), const Context &ctx, const std::vector<Variable> &args) {
+    return invokeTypedRoutine(fn, ctx, args, std::index_sequence_for<Args...> {});
+}
+
+} // namespace script
+
+} // namespace reone
@@ -194,7 +194,12 @@ enum class InstructionType {
     SAVEBP = R_INSTR_TYPE_VAL(ByteCode::SAVEBP, 0x00),
     RESTOREBP = R_INSTR_TYPE_VAL(ByteCode::RESTOREBP, 0x00),
     STORE_STATE = R_INSTR_TYPE_VAL(ByteCode::STORE_STATE, 0x10),
-    NOP2 = R_INSTR_TYPE_VAL(ByteCode::NOP2, 0x00)
+    NOP2 = R_INSTR_TYPE_VAL(ByteCode::NOP2, 0x00),
+
+    // Superinstructions, produced by ScriptOptimizer and never written to NCS
+
+    CPDOWNSP_MOVSP = R_INSTR_TYPE_VAL(0xf0, 0x01),
+    CPDOWNBP_MOVSP = R_INSTR_TYPE_VAL(0xf1, 0x01)
 };
 
 #define R_INSTR_TYPE(a, b) static_cast<InstructionType>(R_INSTR_TYPE_VAL(a, b))
@@ -213,6 +218,11 @@ enum class VariableType {
     Action
 };
 
+enum class ExecutionStatus {
+    Finished,
+    Yielded
+};
+
 } // namespace script
 
 } // namespace reone
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "verifier.h"
+
+#include "../common/logutil.h"
+
+#include "execution.h"
+#include "executioncontext.h"
+#include "profiler.h"
+#include "program.h"
+
+using namespace std;
+
+namespace reone {
+
+namespace script {
+
+OptimizationVerifier::OptimizationVerifier(IRoutines &routines) :
+    _routines(routines) {
+
+    int numRoutines = routines.getNumRoutines();
+    _proxies.reserve(numRoutines);
+
+    for (int i = 0; i < numRoutines; ++i) {
+        const Routine &routine = routines.get(i);
+        vector<VariableType> argTypes;
+        for (int j = 0; j < routine.getArgumentCount(); ++j) {
+            argTypes.push_back(routine.getArgumentType(j));
+        }
+        _proxies.emplace_back(
+            routine.name(),
+            routine.returnType(),
+            Variable::ofNull(),
+            move(argTypes),
+            [this, i](auto &args, auto &ctx) { return invoke(i, args, ctx); });
+    }
+}
+
+int OptimizationVerifier::run(shared_ptr<ScriptProgram> program, const ExecutionContext &ctx) {
+    auto originalCtx = make_unique<ExecutionContext>(ctx);
+    originalCtx->routines = this;
+
+    auto optimizedCtx = make_unique<ExecutionContext>(ctx);
+    optimizedCtx->routines = this;
+
+    _calls.clear();
+    _mode = Mode::Record;
+    ScriptExecution original(program->original(), move(originalCtx));
+    int result = original.run();
+
+    _numReplayed = 0;
+    _mode = Mode::Replay;
+    ScriptExecution optimized(program, move(optimizedCtx));
+    int optimizedResult;
+    {
+        // Replay repeats the work of the original program, do not profile it
+        ScriptProfileSuspension profileSuspension;
+        optimizedResult = optimized.run();
+    }
+
+    _mode = Mode::Forward;
+
+    bool equivalent =
+        result == optimizedResult &&
+        _numReplayed == _calls.size() &&
+        original.getStackSize() == optimized.getStackSize();
+
+    for (int i = 0; equivalent && i < original.getStackSize(); ++i) {
+        equivalent = original.getStackVariable(i) == optimized.getStackVariable(i);
+    }
+    if (!equivalent) {
+        warn(boost::format("Optimized script '%s' is not equivalent to the original: result=%d, optimizedResult=%d") %
+                 program->name() %
+                 result %
+                 optimizedResult,
+             LogChannels::script);
+    }
+
+    return result;
+}
+
+Variable OptimizationVerifier::invoke(int index, const vector<Variable> &args, ExecutionContext &ctx) {
+    switch (_mode) {
+    case Mode::Record: {
+        Variable result;
+        {
+            // Proxy invocation is already profiled as this routine
+            ScriptProfileSuspension profileSuspension;
+            result = _routines.get(index).invoke(args, ctx);
+        }
+        RoutineCall call;
+        call.routine = index;
+        call.result = result;
+        _calls.push_back(move(call));
+        return result;
+    }
+    case Mode::Replay: {
+        if (_numReplayed >= _calls.size() || _calls[_numReplayed].routine != index) {
+            throw runtime_error("Routine call sequence mismatch");
+        }
+        return _calls[_numReplayed++].result;
+    }
+    default:
+        return _routines.get(index).invoke(args, ctx);
+    }
+}
+
+const Routine &OptimizationVerifier::get(int index) const {
+    return _proxies.at(index);
+}
+
+int OptimizationVerifier::getNumRoutines() const {
+    return static_cast<int>(_proxies.size());
+}
+
+int OptimizationVerifier::getIndexByName(const string &name) const {
+    return _routines.getIndexByName(name);
+}
+
+} // namespace script
+
+} // namespace reone
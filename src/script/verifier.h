@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "routine.h"
+#include "routines.h"
+
+namespace reone {
+
+namespace script {
+
+struct ExecutionContext;
+
+class ScriptProgram;
+
+/**
+ * Equivalence test mode for ScriptOptimizer. Executes the original program
+ * against real routines, recording their results, then executes the
+ * optimized program replaying those results, and compares return values and
+ * final stack states.
+ *
+ * Acts as a proxy to the real routines, so that action contexts created
+ * while recording remain valid after verification.
+ */
+class OptimizationVerifier : public IRoutines {
+public:
+    OptimizationVerifier(IRoutines &routines);
+
+    /**
+     * @param program optimized program, whose original is known
+     * @return result of executing the original program
+     */
+    int run(std::shared_ptr<ScriptProgram> program, const ExecutionContext &ctx);
+
+    bool isRunning() const { return _mode != Mode::Forward; }
+
+    const Routine &get(int index) const override;
+
+    int getNumRoutines() const override;
+    int getIndexByName(const std::string &name) const override;
+
+private:
+    enum class Mode {
+        Forward,
+        Record,
+        Replay
+    };
+
+    struct RoutineCall {
+        int routine {0};
+        Variable result;
+    };
+
+    IRoutines &_routines;
+    std::vector<Routine> _proxies;
+
+    Mode _mode {Mode::Forward};
+    std::vector<RoutineCall> _calls;
+    size_t _numReplayed {0};
+
+    Variable invoke(int index, const std::vector<Variable> &args, ExecutionContext &ctx);
+};
+
+} // namespace script
+
+} // namespace reone
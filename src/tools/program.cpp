@@ -27,6 +27,7 @@
 #include "tool/keybif.h"
 #include "tool/lip.h"
 #include "tool/ncs.h"
+#include "tool/ncsbench.h"
 #include "tool/rim.h"
 #include "tool/ssf.h"
 #include "tool/tlk.h"
@@ -57,7 +58,8 @@ static const unordered_map<string, Operation> g_operations {
     {"to-lip", Operation::ToLIP},
     {"to-pcode", Operation::ToPCODE},
     {"to-ncs", Operation::ToNCS},
-    {"to-ssf", Operation::ToSSF}};
+    {"to-ssf", Operation::ToSSF},
+    {"benchmark", Operation::Benchmark}};
 
 static fs::path getDestination(const po::variables_map &vars) {
     fs::path result;
@@ -114,6 +116,7 @@ void Program::initOptions() {
         ("to-pcode", "convert NCS to PCODE")                                               //
         ("to-ncs", "convert PCODE to NCS")                                                 //
         ("to-ssf", "convert JSON to SSF")                                                  //
+        ("benchmark", "benchmark script interpreter on NCS files or a synthetic corpus")   //
         ("target", po::value<string>(), "target name or path to input file");
 }
 
@@ -167,6 +170,7 @@ void Program::loadTools() {
     _tools.push_back(make_shared<TpcTool>());
     _tools.push_back(make_shared<AudioTool>());
     _tools.push_back(make_shared<NcsTool>(_gameId));
+    _tools.push_back(make_shared<NcsBenchmarkTool>(_gameId));
 }
 
 shared_ptr<ITool> Program::getTool() const {
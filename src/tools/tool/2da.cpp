@@ -54,7 +54,7 @@ void TwoDaTool::toJSON(const fs::path &path, const fs::path &destPath) {
         child.put("_id", row);
 
         for (int col = 0; col < twoDa->getColumnCount(); ++col) {
-            child.put(twoDa->columns()[col], twoDa->rows()[row].values[col]);
+            child.put(twoDa->columns()[col], twoDa->getCellValue(row, col));
         }
         children.push_back(make_pair("", child));
     }
@@ -0,0 +1,627 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ncsbench.h"
+
+#include "../../common/pathutil.h"
+#include "../../kotor/script/routines.h"
+#include "../../resource/format/bifreader.h"
+#include "../../resource/format/erfreader.h"
+#include "../../resource/format/keyreader.h"
+#include "../../resource/format/rimreader.h"
+#include "../../script/execution.h"
+#include "../../script/executioncontext.h"
+#include "../../script/format/ncsreader.h"
+#include "../../script/optimizer.h"
+#include "../../script/profiler.h"
+#include "../../script/program.h"
+#include "../../script/routine.h"
+#include "../../script/routinestack.h"
+#include "../../script/routines.h"
+#include "../../script/variable.h"
+
+using namespace std;
+
+using namespace reone::game;
+using namespace reone::kotor;
+using namespace reone::resource;
+using namespace reone::script;
+
+namespace fs = boost::filesystem;
+
+// Allocations are counted by the global allocation functions, but only
+// while the benchmark turns counting on. Otherwise, they are equivalent to
+// the default ones.
+
+static atomic<bool> g_countAllocations {false};
+static atomic<uint64_t> g_numAllocations {0};
+
+void *operator new(size_t size) {
+    if (g_countAllocations.load(memory_order_relaxed)) {
+        g_numAllocations.fetch_add(1, memory_order_relaxed);
+    }
+    void *ptr = malloc(size > 0 ? size : 1);
+    if (!ptr) {
+        throw bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t size) noexcept {
+    free(ptr);
+}
+
+namespace reone {
+
+static constexpr float kMinBenchmarkTime = 0.25f; // seconds
+static constexpr int kMinRuns = 10;
+static constexpr int kMaxRuns = 10000;
+
+static constexpr uint32_t kStubObjectId = 2;
+
+/**
+ * Counts heap allocations made during the lifetime of this object.
+ */
+class AllocationCounter : boost::noncopyable {
+public:
+    AllocationCounter() {
+        g_numAllocations = 0;
+        g_countAllocations = true;
+    }
+
+    ~AllocationCounter() {
+        g_countAllocations = false;
+    }
+
+    uint64_t numAllocations() const { return g_numAllocations; }
+};
+
+/**
+ * Routines with signatures of the game routines, which record calls and
+ * return canned values. Routines that are typed in the game are typed here
+ * as well, so that the typed calling convention is benchmarked.
+ */
+class StubRoutines : public IRoutines {
+public:
+    StubRoutines(GameID gameId) {
+        if (gameId == GameID::TSL) {
+            _signatures.initForTSL();
+        } else {
+            _signatures.initForKotOR();
+        }
+        int numRoutines = _signatures.getNumRoutines();
+        _numCalls.resize(numRoutines, 0);
+        _routines.reserve(numRoutines);
+
+        for (int i = 0; i < numRoutines; ++i) {
+            const Routine &signature = _signatures.get(i);
+            vector<VariableType> argTypes;
+            for (int j = 0; j < signature.getArgumentCount(); ++j) {
+                argTypes.push_back(signature.getArgumentType(j));
+            }
+            Variable retValue(getCannedValue(signature.returnType()));
+            auto fn = [this, i, retValue](auto &args, auto &ctx) {
+                ++_numCalls[i];
+                return retValue;
+            };
+            if (!signature.isTyped()) {
+                _routines.emplace_back(signature.name(), signature.returnType(), retValue, move(argTypes), move(fn));
+                continue;
+            }
+            auto typedFn = [this, i, argTypes, retValue](RoutineStack &stack, auto &ctx) {
+                ++_numCalls[i];
+                for (auto type : argTypes) {
+                    popArgument(stack, type);
+                }
+                stack.pushVariable(retValue);
+            };
+            _routines.emplace_back(signature.name(), signature.returnType(), retValue, argTypes, move(fn), move(typedFn));
+        }
+    }
+
+    void resetCalls() {
+        fill(_numCalls.begin(), _numCalls.end(), 0);
+    }
+
+    const Routine &get(int index) const override { return _routines[index]; }
+    int getNumCalls(int index) const { return _numCalls[index]; }
+
+    int getNumRoutines() const override { return static_cast<int>(_routines.size()); }
+    int getIndexByName(const string &name) const override { return _signatures.getIndexByName(name); }
+
+private:
+    Routines _signatures;
+    vector<Routine> _routines;
+    vector<int> _numCalls;
+
+    static void popArgument(RoutineStack &stack, VariableType type) {
+        switch (type) {
+        case VariableType::Int:
+            stack.popInt();
+            break;
+        case VariableType::Float:
+            stack.popFloat();
+            break;
+        case VariableType::Object:
+            stack.popObject();
+            break;
+        case VariableType::String:
+            stack.popString();
+            break;
+        case VariableType::Vector:
+            stack.popVector();
+            break;
+        default:
+            throw invalid_argument("Unsupported typed routine argument type: " + to_string(static_cast<int>(type)));
+        }
+    }
+
+    static Variable getCannedValue(VariableType type) {
+        switch (type) {
+        case VariableType::Int:
+            return Variable::ofInt(1);
+        case VariableType::Float:
+            return Variable::ofFloat(1.0f);
+        case VariableType::String:
+            return Variable::ofString("");
+        case VariableType::Vector:
+            return Variable::ofVector(glm::vec3(0.0f));
+        case VariableType::Object:
+            return Variable::ofObject(kStubObjectId);
+        default: {
+            Variable result;
+            result.type = type;
+            return result;
+        }
+        }
+    }
+};
+
+/**
+ * Assembles a script program from instructions, resolving jump labels.
+ */
+class ProgramBuilder {
+public:
+    ProgramBuilder(string name) :
+        _name(move(name)) {
+    }
+
+    ProgramBuilder &add(InstructionType type) {
+        Instruction ins;
+        ins.type = type;
+        _instructions.push_back(move(ins));
+        return *this;
+    }
+
+    ProgramBuilder &addInt(InstructionType type, int value) {
+        add(type);
+        _instructions.back().intValue = value;
+        return *this;
+    }
+
+    ProgramBuilder &addFloat(float value) {
+        add(InstructionType::CONSTF);
+        _instructions.back().floatValue = value;
+        return *this;
+    }
+
+    ProgramBuilder &addString(string value) {
+        add(InstructionType::CONSTS);
+        _instructions.back().strValue = move(value);
+        return *this;
+    }
+
+    ProgramBuilder &addObject(uint32_t objectId) {
+        add(InstructionType::CONSTO);
+        _instructions.back().objectId = objectId;
+        return *this;
+    }
+
+    ProgramBuilder &addStack(InstructionType type, int stackOffset, int size = 4) {
+        add(type);
+        _instructions.back().stackOffset = stackOffset;
+        _instructions.back().size = size;
+        return *this;
+    }
+
+    ProgramBuilder &addAction(int routine, int argCount) {
+        add(InstructionType::ACTION);
+        _instructions.back().routine = routine;
+        _instructions.back().argCount = argCount;
+        return *this;
+    }
+
+    ProgramBuilder &addJump(InstructionType type, const string &label) {
+        _jumpLabels.insert(make_pair(static_cast<int>(_instructions.size()), label));
+        return add(type);
+    }
+
+    ProgramBuilder &addLabel(const string &label) {
+        _labelIndices[label] = static_cast<int>(_instructions.size());
+        return *this;
+    }
+
+    shared_ptr<ScriptProgram> build() {
+        uint32_t offset = kStartOffset;
+        for (auto &ins : _instructions) {
+            ins.offset = offset;
+            offset += getInstructionSize(ins);
+            ins.nextOffset = offset;
+        }
+        for (auto &jump : _jumpLabels) {
+            Instruction &ins = _instructions[jump.first];
+            ins.jumpOffset = _instructions[_labelIndices.find(jump.second)->second].offset - ins.offset;
+        }
+        auto program = make_shared<ScriptProgram>(_name);
+        for (auto &ins : _instructions) {
+            program->add(ins);
+        }
+        program->setLength(offset);
+
+        return program;
+    }
+
+private:
+    static constexpr uint32_t kStartOffset = 13;
+
+    string _name;
+    vector<Instruction> _instructions;
+    map<int, string> _jumpLabels;
+    map<string, int> _labelIndices;
+
+    static int getInstructionSize(const Instruction &ins) {
+        switch (ins.type) {
+        case InstructionType::CPDOWNSP:
+        case InstructionType::CPTOPSP:
+            return 8;
+        case InstructionType::CONSTI:
+        case InstructionType::CONSTF:
+        case InstructionType::CONSTO:
+        case InstructionType::MOVSP:
+        case InstructionType::JMP:
+        case InstructionType::JZ:
+        case InstructionType::DECISP:
+            return 6;
+        case InstructionType::CONSTS:
+            return 4 + static_cast<int>(ins.strValue.length());
+        case InstructionType::ACTION:
+            return 5;
+        default:
+            return 2;
+        }
+    }
+};
+
+struct BenchmarkResult {
+    string name;
+    int runs {0};
+    int result {0};
+    uint64_t instructionsPerRun {0};
+    uint64_t routineCallsPerRun {0};
+    double allocationsPerRun {0.0};
+    double instructionsPerSecond {0.0};
+    uint64_t latencyP50 {0}; /**< nanoseconds */
+    uint64_t latencyP90 {0};
+    uint64_t latencyP99 {0};
+};
+
+static uint64_t getPercentile(const vector<uint64_t> &sortedValues, float percentile) {
+    size_t idx = static_cast<size_t>(percentile * (sortedValues.size() - 1));
+    return sortedValues[idx];
+}
+
+static uint64_t countInstructions(ScriptExecution &execution, const shared_ptr<ScriptProgram> &program, const ExecutionContext &ctx) {
+    setScriptProfilingEnabled(true);
+    resetScriptProfile();
+
+    execution.reset(program, ctx);
+    execution.run();
+
+    uint64_t result = 0;
+    for (auto &pair : getScriptInstructionHistogram()) {
+        result += pair.second;
+    }
+    setScriptProfilingEnabled(false);
+
+    return result;
+}
+
+static BenchmarkResult runBenchmark(const shared_ptr<ScriptProgram> &program, StubRoutines &routines) {
+    ExecutionContext ctx;
+    ctx.routines = &routines;
+    ctx.callerId = kStubObjectId;
+
+    BenchmarkResult result;
+    result.name = program->name();
+
+    // Warm up, so that execution containers and string pool reach their capacity
+    ScriptExecution execution;
+    result.instructionsPerRun = countInstructions(execution, program, ctx);
+
+    routines.resetCalls();
+    execution.reset(program, ctx);
+    execution.run();
+    for (int i = 0; i < routines.getNumRoutines(); ++i) {
+        result.routineCallsPerRun += routines.getNumCalls(i);
+    }
+
+    vector<uint64_t> latencies;
+    latencies.reserve(kMaxRuns);
+    uint64_t totalTime = 0;
+    AllocationCounter allocationCounter;
+
+    while (latencies.size() < kMaxRuns && (latencies.size() < kMinRuns || totalTime < kMinBenchmarkTime * 1e9)) {
+        auto startTime = chrono::steady_clock::now();
+        execution.reset(program, ctx);
+        result.result = execution.run();
+        uint64_t latency = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - startTime).count();
+        latencies.push_back(latency);
+        totalTime += latency;
+    }
+    result.runs = static_cast<int>(latencies.size());
+    result.allocationsPerRun = allocationCounter.numAllocations() / static_cast<double>(result.runs);
+    result.instructionsPerSecond = result.instructionsPerRun * result.runs / (totalTime / 1e9);
+
+    sort(latencies.begin(), latencies.end());
+    result.latencyP50 = getPercentile(latencies, 0.5f);
+    result.latencyP90 = getPercentile(latencies, 0.9f);
+    result.latencyP99 = getPercentile(latencies, 0.99f);
+
+    return result;
+}
+
+void NcsBenchmarkTool::invoke(Operation operation, const fs::path &target, const fs::path &gamePath, const fs::path &destPath) {
+    StubRoutines routines(_gameId);
+
+    vector<shared_ptr<ScriptProgram>> programs;
+    if (target.empty()) {
+        for (auto &synthetic : getSyntheticPrograms(routines)) {
+            checkSyntheticProgram(synthetic, routines);
+            programs.push_back(synthetic.program);
+        }
+    } else {
+        programs = loadPrograms(target, gamePath);
+    }
+
+    cout << boost::format("%-24s %6s %10s %8s %10s %10s %10s %10s %10s") % "script" % "runs" % "instr/run" % "calls" % "allocs" % "Minstr/s" % "p50 us" % "p90 us" % "p99 us" << endl;
+
+    uint64_t totalInstructions = 0;
+    double totalTime = 0.0;
+    for (auto &program : programs) {
+        BenchmarkResult result(runBenchmark(program, routines));
+        cout << boost::format("%-24s %6d %10d %8d %10.2f %10.2f %10.2f %10.2f %10.2f") %
+                    result.name %
+                    result.runs %
+                    result.instructionsPerRun %
+                    result.routineCallsPerRun %
+                    result.allocationsPerRun %
+                    (result.instructionsPerSecond / 1e6) %
+                    (result.latencyP50 / 1e3) %
+                    (result.latencyP90 / 1e3) %
+                    (result.latencyP99 / 1e3)
+             << endl;
+        if (result.instructionsPerSecond > 0.0) {
+            totalInstructions += result.instructionsPerRun * result.runs;
+            totalTime += result.instructionsPerRun * result.runs / result.instructionsPerSecond;
+        }
+    }
+    if (totalTime > 0.0) {
+        cout << boost::format("Total: %d programs, %.2f Minstr/s") % programs.size() % (totalInstructions / totalTime / 1e6) << endl;
+    }
+}
+
+vector<shared_ptr<ScriptProgram>> NcsBenchmarkTool::loadPrograms(const fs::path &target, const fs::path &gamePath) {
+    vector<shared_ptr<ScriptProgram>> programs;
+
+    auto loadProgram = [&programs](const string &resRef, const function<void(NcsReader &)> &load) {
+        try {
+            NcsReader ncs(resRef);
+            load(ncs);
+            programs.push_back(ncs.program());
+        } catch (const exception &ex) {
+            cout << "Unable to load script '" << resRef << "': " << ex.what() << endl;
+        }
+    };
+    auto loadProgramData = [&loadProgram](const string &resRef, shared_ptr<ByteArray> data) {
+        loadProgram(resRef, [&data](auto &ncs) { ncs.load(ByteView(&(*data)[0], data->size(), data)); });
+    };
+
+    string ext(boost::to_lower_copy(target.extension().string()));
+    if (fs::is_directory(target)) {
+        vector<fs::path> paths;
+        for (auto &entry : fs::directory_iterator(target)) {
+            if (boost::iequals(entry.path().extension().string(), ".ncs")) {
+                paths.push_back(entry.path());
+            }
+        }
+        sort(paths.begin(), paths.end());
+        for (auto &path : paths) {
+            loadProgram(path.stem().string(), [&path](auto &ncs) { ncs.load(path); });
+        }
+    } else if (ext == ".ncs") {
+        loadProgram(target.stem().string(), [&target](auto &ncs) { ncs.load(target); });
+    } else if (ext == ".erf" || ext == ".mod") {
+        ErfReader erf;
+        erf.load(target);
+        erf.forEachEntry([&](const ResourceId &id, int idx) {
+            if (id.type == ResourceType::Ncs) {
+                loadProgramData(id.resRef, erf.readEntry(idx));
+            }
+        });
+    } else if (ext == ".rim") {
+        RimReader rim;
+        rim.load(target);
+        rim.forEachEntry([&](const ResourceId &id, int idx) {
+            if (id.type == ResourceType::Ncs) {
+                loadProgramData(id.resRef, rim.readEntry(idx));
+            }
+        });
+    } else if (ext == ".bif") {
+        KeyReader key;
+        key.load(getPathIgnoreCase(gamePath, "chitin.key"));
+
+        BifReader bif;
+        bif.load(target);
+
+        for (size_t i = 0; i < key.files().size(); ++i) {
+            if (!boost::iends_with(key.getFilename(static_cast<int>(i)), target.filename().string())) {
+                continue;
+            }
+            for (auto &keyEntry : key.keys()) {
+                if (keyEntry.bifIdx == static_cast<int>(i) && keyEntry.resId.type == ResourceType::Ncs) {
+                    loadProgramData(keyEntry.resId.resRef, bif.getResourceData(keyEntry.resIdx));
+                }
+            }
+            break;
+        }
+    }
+
+    return programs;
+}
+
+vector<NcsBenchmarkTool::SyntheticProgram> NcsBenchmarkTool::getSyntheticPrograms(const IRoutines &routines) {
+    static constexpr int kNumIterations = 1000;
+
+    vector<SyntheticProgram> programs;
+
+    // Integer arithmetic in a loop: sum of numbers from 1 to N
+    programs.push_back(SyntheticProgram {ProgramBuilder("synthetic_loop")
+                           .addInt(InstructionType::CONSTI, 0)
+                           .addInt(InstructionType::CONSTI, kNumIterations)
+                           .addLabel("loop")
+                           .addStack(InstructionType::CPTOPSP, -4)
+                           .addJump(InstructionType::JZ, "end")
+                           .addStack(InstructionType::CPTOPSP, -8)
+                           .addStack(InstructionType::CPTOPSP, -8)
+                           .add(InstructionType::ADDII)
+                           .addStack(InstructionType::CPDOWNSP, -12)
+                           .addStack(InstructionType::MOVSP, -4)
+                           .addStack(InstructionType::DECISP, -4)
+                           .addJump(InstructionType::JMP, "loop")
+                           .addLabel("end")
+                           .addStack(InstructionType::MOVSP, -4)
+                           .add(InstructionType::RETN)
+                           .build(), kNumIterations * (kNumIterations + 1) / 2, 4});
+
+    // String concatenation in a loop
+    programs.push_back(SyntheticProgram {ProgramBuilder("synthetic_strings")
+                           .addString("")
+                           .addInt(InstructionType::CONSTI, kNumIterations / 10)
+                           .addLabel("loop")
+                           .addStack(InstructionType::CPTOPSP, -4)
+                           .addJump(InstructionType::JZ, "end")
+                           .addStack(InstructionType::CPTOPSP, -8)
+                           .addString("ab")
+                           .add(InstructionType::ADDSS)
+                           .addStack(InstructionType::CPDOWNSP, -12)
+                           .addStack(InstructionType::MOVSP, -4)
+                           .addStack(InstructionType::DECISP, -4)
+                           .addJump(InstructionType::JMP, "loop")
+                           .addLabel("end")
+                           .addStack(InstructionType::MOVSP, -4)
+                           .addString("")
+                           .add(InstructionType::NEQUALSS)
+                           .add(InstructionType::RETN)
+                           .build(), 1, 4});
+
+    // Vector math in a loop: v = v * 0.5 + [1, 1, 1], which converges to [2, 2, 2]
+    programs.push_back(SyntheticProgram {ProgramBuilder("synthetic_vectors")
+                           .addFloat(1.0f)
+                           .addFloat(2.0f)
+                           .addFloat(3.0f)
+                           .addInt(InstructionType::CONSTI, kNumIterations)
+                           .addLabel("loop")
+                           .addStack(InstructionType::CPTOPSP, -4)
+                           .addJump(InstructionType::JZ, "end")
+                           .addStack(InstructionType::CPTOPSP, -16, 12)
+                           .addFloat(0.5f)
+                           .add(InstructionType::MULVF)
+                           .addFloat(1.0f)
+                           .addFloat(1.0f)
+                           .addFloat(1.0f)
+                           .add(InstructionType::ADDVV)
+                           .addStack(InstructionType::CPDOWNSP, -28, 12)
+                           .addStack(InstructionType::MOVSP, -12)
+                           .addStack(InstructionType::DECISP, -4)
+                           .addJump(InstructionType::JMP, "loop")
+                           .addLabel("end")
+                           .addStack(InstructionType::MOVSP, -4)
+                           .addFloat(2.0f)
+                           .addFloat(2.0f)
+                           .addFloat(2.0f)
+                           .addStack(InstructionType::EQUALTT, 0, 12)
+                           .add(InstructionType::RETN)
+                           .build(), 1, 10});
+
+    // Routine calls in a loop
+    int routine = routines.getIndexByName("GetIsObjectValid");
+    if (routine != -1) {
+        programs.push_back(SyntheticProgram {ProgramBuilder("synthetic_routines")
+                               .addInt(InstructionType::CONSTI, 0)
+                               .addInt(InstructionType::CONSTI, kNumIterations)
+                               .addLabel("loop")
+                               .addStack(InstructionType::CPTOPSP, -4)
+                               .addJump(InstructionType::JZ, "end")
+                               .addObject(kObjectSelf)
+                               .addAction(routine, 1)
+                               .addStack(InstructionType::CPTOPSP, -12)
+                               .add(InstructionType::ADDII)
+                               .addStack(InstructionType::CPDOWNSP, -12)
+                               .addStack(InstructionType::MOVSP, -4)
+                               .addStack(InstructionType::DECISP, -4)
+                               .addJump(InstructionType::JMP, "loop")
+                               .addLabel("end")
+                               .addStack(InstructionType::MOVSP, -4)
+                               .add(InstructionType::RETN)
+                               .build(), kNumIterations, 4});
+    }
+
+    return programs;
+}
+
+void NcsBenchmarkTool::checkSyntheticProgram(const SyntheticProgram &synthetic, IRoutines &routines) {
+    const string &name = synthetic.program->name();
+
+    ScriptOptimizer optimizer(routines);
+    int stackSize = optimizer.computeStackSize(*synthetic.program);
+    if (stackSize != synthetic.expectedStackSize) {
+        throw runtime_error(str(boost::format("Program '%s': expected stack size %d, got %d") % name % synthetic.expectedStackSize % stackSize));
+    }
+
+    ExecutionContext ctx;
+    ctx.routines = &routines;
+    ctx.callerId = kStubObjectId;
+
+    for (auto &program : {synthetic.program, optimizer.optimize(*synthetic.program)}) {
+        ScriptExecution execution;
+        execution.reset(program, ctx);
+        int result = execution.run();
+        if (result != synthetic.expectedResult) {
+            throw runtime_error(str(boost::format("Program '%s': expected result %d, got %d") % name % synthetic.expectedResult % result));
+        }
+    }
+}
+
+bool NcsBenchmarkTool::supports(Operation operation, const fs::path &target) const {
+    return operation == Operation::Benchmark;
+}
+
+} // namespace reone
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2020-2021 The reone project contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../../engine/types.h"
+
+#include "../tool.h"
+
+namespace reone {
+
+namespace script {
+
+class IRoutines;
+class ScriptProgram;
+
+} // namespace script
+
+/**
+ * Measures throughput of the script interpreter without launching the game.
+ * Runs NCS programs from a directory, an NCS file, an ERF/RIM archive or a
+ * BIF of the game, or a built-in synthetic corpus when no target is given.
+ * Routines are replaced by stubs, which return canned values.
+ */
+class NcsBenchmarkTool : public ITool {
+public:
+    NcsBenchmarkTool(game::GameID gameId) :
+        _gameId(gameId) {
+    }
+
+    void invoke(
+        Operation operation,
+        const boost::filesystem::path &target,
+        const boost::filesystem::path &gamePath,
+        const boost::filesystem::path &destPath) override;
+
+    bool supports(Operation operation, const boost::filesystem::path &target) const override;
+
+private:
+    /**
+     * Synthetic program together with its known result and stack size, so
+     * that interpreter and optimizer regressions fail the benchmark.
+     */
+    struct SyntheticProgram {
+        std::shared_ptr<script::ScriptProgram> program;
+        int expectedResult {0};
+        int expectedStackSize {0};
+    };
+
+    game::GameID _gameId;
+
+    std::vector<std::shared_ptr<script::ScriptProgram>> loadPrograms(const boost::filesystem::path &target, const boost::filesystem::path &gamePath);
+    std::vector<SyntheticProgram> getSyntheticPrograms(const script::IRoutines &routines);
+
+    void checkSyntheticProgram(const SyntheticProgram &synthetic, script::IRoutines &routines);
+};
+
+} // namespace reone
@@ -35,7 +35,8 @@ enum class Operation {
     ToLIP,
     ToPCODE,
     ToNCS,
-    ToSSF
+    ToSSF,
+    Benchmark
 };
 
 } // namespace reone